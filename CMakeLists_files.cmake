@@ -131,6 +131,8 @@ list (APPEND PUBLIC_HEADER_FILES
              opm/models/discretization/common/fvbaseproperties.hh
              opm/models/discretization/common/fvbaseextensivequantities.hh
              opm/models/discretization/common/fvbaselinearizer.hh
+             opm/models/discretization/common/fvbasesubdomains.hh
+             opm/models/discretization/common/fvbasetimestepcontrol.hh
              opm/models/discretization/common/tpfalinearizer.hh
              opm/models/discretization/common/restrictprolong.hh
              opm/models/discretization/common/fvbasediscretization.hh
@@ -170,6 +172,9 @@ list (APPEND PUBLIC_HEADER_FILES
              opm/models/io/cubegridvanguard.hh
              opm/models/io/baseoutputwriter.hh
              opm/models/io/vtkmultiwriter.hh
+             opm/models/io/hdf5multiwriter.hh
+             opm/models/io/gridcache.hh
+             opm/models/io/probeoutputmodule.hh
              opm/models/io/vtkmultiphasemodule.hh
              opm/models/io/vtkdiscretefracturemodule.hh
              opm/models/io/vtkdiffusionmodule.hh
@@ -202,12 +207,15 @@ list (APPEND PUBLIC_HEADER_FILES
              opm/models/nonlinear/nullconvergencewriter.hh
              opm/models/nonlinear/newtonmethod.hh
              opm/models/nonlinear/newtonmethodproperties.hh
+             opm/models/nonlinear/sequentialimplicitsystems.hh
              opm/models/parallel/mpiutil.hh
              opm/models/parallel/tasklets.hh
              opm/models/parallel/threadmanager.hh
              opm/models/parallel/gridcommhandles.hh
              opm/models/parallel/mpibuffer.hh
              opm/models/parallel/threadedentityiterator.hh
+             opm/models/parallel/weightedbisectionpartitioner.hh
+             opm/models/parallel/globalelementindices.hh
              opm/models/pvs/pvsboundaryratevector.hh
              opm/models/pvs/pvsratevector.hh
              opm/models/pvs/pvsindices.hh
@@ -256,6 +264,7 @@ list (APPEND PUBLIC_HEADER_FILES
              opm/simulators/linalg/parallelbasebackend.hh
              opm/simulators/linalg/overlappingblockvector.hh
              opm/simulators/linalg/parallelbicgstabbackend.hh
+             opm/simulators/linalg/parallelcprbackend.hh
              opm/simulators/linalg/nullborderlistmanager.hh
              opm/simulators/linalg/overlappingoperator.hh
              opm/simulators/linalg/elementborderlistfromgrid.hh
@@ -264,6 +273,7 @@ list (APPEND PUBLIC_HEADER_FILES
              opm/simulators/linalg/globalindices.hh
              opm/simulators/linalg/superlubackend.hh
              opm/simulators/linalg/matrixblock.hh
+             opm/simulators/linalg/mixedprecisionpreconditioner.hh
              opm/simulators/linalg/istlsolverwrappers.hh
              opm/simulators/linalg/overlaptypes.hh
              opm/simulators/linalg/overlappingpreconditioner.hh
@@ -272,4 +282,7 @@ list (APPEND PUBLIC_HEADER_FILES
              opm/simulators/linalg/parallelamgbackend.hh
              opm/simulators/linalg/foreignoverlapfrombcrsmatrix.hh
              opm/simulators/linalg/overlappingscalarproduct.hh
+             opm/simulators/linalg/threadedpreconditioners.hh
+             opm/simulators/linalg/recyclinggmressolver.hh
+             opm/simulators/linalg/matrixreordering.hh
              opm/simulators/linalg/convergencecriterion.hh)
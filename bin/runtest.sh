@@ -12,9 +12,52 @@ usage() {
     echo "Usage:"
     echo
     echo "runTest.sh TEST_TYPE -e binary -- [TEST_ARGS]"
-    echo "where TEST_TYPE can either be --plain, --simulation, --spe1 or --parallel-simulation=\$NUM_CORES (is '$TEST_TYPE')."
+    echo "where TEST_TYPE can either be --plain, --simulation, --spe1, --parallel-simulation=\$NUM_CORES, --same-results=\$PARAM, --fewer-linear-iterations=\$PARAM, --more-linear-iterations=\$PARAM, --expect-output=\$REGEX, --probe-output=\$REGEX or --load-balance-cost=\$NUM_CORES (is '$TEST_TYPE')."
 };
 
+# this function prints the total number of linear iterations reported by the Newton
+# method in a log file
+countLinearIterations()
+{
+    grep -o "Linear iterations: [0-9]*" "$1" | awk '{ sum += $3 } END { print sum + 0 }'
+}
+
+# this function compares two VTU files which use the ASCII format. the numbers which
+# they contain are considered to be equal if they differ by less than an absolute or a
+# relative tolerance, all other tokens must be identical.
+compareVtuFiles()
+{
+    tr -s '[:space:]<>"=' '\n' < "$1" > "$1.tokens"
+    tr -s '[:space:]<>"=' '\n' < "$2" > "$2.tokens"
+    if test "$(wc -l < "$1.tokens")" != "$(wc -l < "$2.tokens")"; then
+        echo "The structure of the files $1 and $2 differs"
+        rm "$1.tokens" "$2.tokens"
+        return 1
+    fi
+
+    paste -d ' ' "$1.tokens" "$2.tokens" | awk -v ATOL=1e-5 -v RTOL=1e-3 '
+        function abs(x) { return (x < 0) ? -x : x }
+        $1 ~ /^[-+]?[0-9]*\.?[0-9]+([eE][-+]?[0-9]+)?$/ {
+            diff = abs($1 - $2)
+            size = (abs($1) > abs($2)) ? abs($1) : abs($2)
+            if (diff > ATOL && diff > RTOL*size) {
+                print "The values " $1 " and " $2 " differ"
+                failed = 1
+                exit
+            }
+            next
+        }
+        $1 != $2 {
+            print "The tokens " $1 " and " $2 " differ"
+            failed = 1
+            exit
+        }
+        END { exit failed }'
+    RET="$?"
+    rm "$1.tokens" "$2.tokens"
+    return "$RET"
+}
+
 # this function clips the help message printed by an ewoms simulation
 # to what is actually printed, throwing away all garbage which is
 # printed before or after the "meat"
@@ -157,6 +200,220 @@ case "$TEST_TYPE" in
         exit 0
         ;;
 
+    "--same-results="*)
+        # run the simulation with and without an additional parameter which must not
+        # change the results beyond the tolerances of the solvers
+        PARAM="${TEST_TYPE/--same-results=/}"
+
+        for VARIANT in "reference" "variant"; do
+            OUTPUT_DIR="test-$RND-$VARIANT"
+            mkdir -p "$OUTPUT_DIR"
+            VARIANT_ARGS="$TEST_ARGS --output-dir=$OUTPUT_DIR"
+            if test "$VARIANT" = "variant"; then
+                VARIANT_ARGS="$VARIANT_ARGS $PARAM"
+            fi
+
+            echo "executing \"$TEST_BINARY $VARIANT_ARGS\""
+            "$TEST_BINARY" $VARIANT_ARGS | tee "test-$RND.log"
+            RET="${PIPESTATUS[0]}"
+            if test "$RET" != "0"; then
+                echo "Executing the binary failed!"
+                rm -r "test-$RND.log" "test-$RND-reference" "test-$RND-variant"
+                exit 1
+            fi
+        done
+
+        # compare the results at the end of both simulations
+        echo "######################"
+        echo "# Comparing results"
+        echo "######################"
+
+        SIM_NAME=$(grep "Applying the initial solution of the" "test-$RND.log" | sed "s/.*\"\(.*\)\".*/\1/" | head -n1)
+        rm "test-$RND.log"
+        REFERENCE_RESULT=$(ls -- "test-$RND-reference/$SIM_NAME"-*.vtu | tail -n 1)
+        VARIANT_RESULT=$(ls -- "test-$RND-variant/$SIM_NAME"-*.vtu | tail -n 1)
+        echo "Comparing '$REFERENCE_RESULT' and '$VARIANT_RESULT'"
+
+        if ! compareVtuFiles "$REFERENCE_RESULT" "$VARIANT_RESULT"; then
+            echo "Passing '$PARAM' changes the results"
+            rm -r "test-$RND-reference" "test-$RND-variant"
+            exit 1
+        fi
+
+        rm -r "test-$RND-reference" "test-$RND-variant"
+        exit 0
+        ;;
+
+    "--fewer-linear-iterations="*|"--more-linear-iterations="*)
+        # run the simulation with and without an additional parameter which must reduce
+        # respectively increase the total number of linear iterations
+        PARAM="${TEST_TYPE#--*-linear-iterations=}"
+
+        for VARIANT in "reference" "variant"; do
+            VARIANT_ARGS="$TEST_ARGS"
+            if test "$VARIANT" = "variant"; then
+                VARIANT_ARGS="$VARIANT_ARGS $PARAM"
+            fi
+
+            echo "executing \"$TEST_BINARY $VARIANT_ARGS\""
+            "$TEST_BINARY" $VARIANT_ARGS | tee "test-$RND-$VARIANT.log"
+            RET="${PIPESTATUS[0]}"
+            if test "$RET" != "0"; then
+                echo "Executing the binary failed!"
+                rm -f "test-$RND-reference.log" "test-$RND-variant.log"
+                exit 1
+            fi
+        done
+
+        REFERENCE_ITERATIONS=$(countLinearIterations "test-$RND-reference.log")
+        VARIANT_ITERATIONS=$(countLinearIterations "test-$RND-variant.log")
+        rm "test-$RND-reference.log" "test-$RND-variant.log"
+
+        echo "Linear iterations without '$PARAM': $REFERENCE_ITERATIONS"
+        echo "Linear iterations with '$PARAM': $VARIANT_ITERATIONS"
+        if test "$REFERENCE_ITERATIONS" -eq 0 || test "$VARIANT_ITERATIONS" -eq 0; then
+            echo "The simulation does not report its linear iterations"
+            exit 1
+        elif test "${TEST_TYPE%%=*}" = "--fewer-linear-iterations" \
+                && test "$VARIANT_ITERATIONS" -ge "$REFERENCE_ITERATIONS"; then
+            echo "Passing '$PARAM' does not reduce the number of linear iterations"
+            exit 1
+        elif test "${TEST_TYPE%%=*}" = "--more-linear-iterations" \
+                && test "$VARIANT_ITERATIONS" -le "$REFERENCE_ITERATIONS"; then
+            echo "Passing '$PARAM' does not increase the number of linear iterations"
+            exit 1
+        fi
+        exit 0
+        ;;
+
+    "--expect-output="*)
+        # run the simulation and make sure that its output matches an extended regular
+        # expression. this is used to check that a feature actually takes effect.
+        REGEX="${TEST_TYPE/--expect-output=/}"
+
+        echo "executing \"$TEST_BINARY $TEST_ARGS\""
+        "$TEST_BINARY" $TEST_ARGS | tee "test-$RND.log"
+        RET="${PIPESTATUS[0]}"
+        if test "$RET" != "0"; then
+            echo "Executing the binary failed!"
+            rm "test-$RND.log"
+            exit 1
+        fi
+
+        if ! grep -q -E -- "$REGEX" "test-$RND.log"; then
+            echo "The output of the simulation does not match '$REGEX'"
+            rm "test-$RND.log"
+            exit 1
+        fi
+
+        rm "test-$RND.log"
+        exit 0
+        ;;
+
+    "--probe-output="*)
+        # run the simulation and make sure that it writes the time series of the probes:
+        # the file must contain one row per time step and a header which matches an
+        # extended regular expression. since all probes of the tests are located within
+        # the grid, none of the values may be NaN.
+        REGEX="${TEST_TYPE/--probe-output=/}"
+        OUTPUT_DIR="test-$RND"
+        mkdir -p "$OUTPUT_DIR"
+
+        echo "executing \"$TEST_BINARY $TEST_ARGS --output-dir=$OUTPUT_DIR\""
+        "$TEST_BINARY" $TEST_ARGS --output-dir="$OUTPUT_DIR" | tee "test-$RND.log"
+        RET="${PIPESTATUS[0]}"
+        if test "$RET" != "0"; then
+            echo "Executing the binary failed!"
+            rm -r "test-$RND.log" "$OUTPUT_DIR"
+            exit 1
+        fi
+
+        SIM_NAME=$(grep "Applying the initial solution of the" "test-$RND.log" | sed "s/.*\"\(.*\)\".*/\1/" | head -n1)
+        NUM_TIMESTEPS=$(grep -c "Time step [0-9]* done" "test-$RND.log")
+        rm "test-$RND.log"
+
+        CSV_FILE="$OUTPUT_DIR/$SIM_NAME-probes.csv"
+        if ! test -r "$CSV_FILE"; then
+            echo "File $CSV_FILE does not exist or is not readable"
+            rm -r "$OUTPUT_DIR"
+            exit 1
+        fi
+
+        HEADER=$(grep -v "^#" "$CSV_FILE" | head -n 1)
+        NUM_COLUMNS=$(echo "$HEADER" | awk -F, '{ print NF }')
+        NUM_ROWS=$(grep -v "^#" "$CSV_FILE" | tail -n +2 | wc -l)
+        echo "Header of the time series: '$HEADER'"
+        echo "Number of timesteps: '$NUM_TIMESTEPS', number of rows: '$NUM_ROWS'"
+
+        if ! echo "$HEADER" | grep -q -E -- "$REGEX"; then
+            echo "The header of the time series does not match '$REGEX'"
+            RET=1
+        elif test "$NUM_ROWS" -ne "$NUM_TIMESTEPS"; then
+            echo "The time series does not contain one row per time step"
+            RET=1
+        elif grep -v "^#" "$CSV_FILE" | tail -n +2 \
+                | awk -F, -v N="$NUM_COLUMNS" 'NF != N || tolower($0) ~ /nan/ { bad = 1 } END { exit !bad }'; then
+            echo "The time series contains incomplete rows or NaN values"
+            RET=1
+        fi
+
+        rm -r "$OUTPUT_DIR"
+        exit "$RET"
+        ;;
+
+    "--load-balance-cost="*)
+        # run a parallel simulation which measures the linearization cost of the
+        # elements, make sure that it writes a file containing the coordinates and the
+        # cost of each element and use this file to balance the load of a second
+        # parallel run
+        NUM_PROCS="${TEST_TYPE/--load-balance-cost=/}"
+        OUTPUT_DIR="test-$RND"
+        mkdir -p "$OUTPUT_DIR"
+
+        echo "executing \"mpirun -np $NUM_PROCS $TEST_BINARY $TEST_ARGS --output-dir=$OUTPUT_DIR\""
+        mpirun -np "$NUM_PROCS" "$TEST_BINARY" $TEST_ARGS --output-dir="$OUTPUT_DIR" | tee "test-$RND.log"
+        RET="${PIPESTATUS[0]}"
+        if test "$RET" != "0"; then
+            echo "Executing the binary failed!"
+            rm -r "test-$RND.log" "$OUTPUT_DIR"
+            exit 1
+        fi
+
+        SIM_NAME=$(grep "Applying the initial solution of the" "test-$RND.log" | sed "s/.*\"\(.*\)\".*/\1/" | head -n1)
+        COST_FILE="$OUTPUT_DIR/$SIM_NAME-cost.txt"
+        if ! test -s "$COST_FILE"; then
+            echo "File $COST_FILE does not exist or is empty"
+            rm -r "test-$RND.log" "$OUTPUT_DIR"
+            exit 1
+        fi
+
+        # all lines must consist of the same number of values, the last one of which
+        # is the cost. the cost must be non-negative and not zero for all elements.
+        if ! awk 'NR == 1 { n = NF }
+                  NF != n || NF < 2 || $NF < 0 { bad = 1 }
+                  { sum += $NF }
+                  END { exit bad || sum <= 0 }' "$COST_FILE"; then
+            echo "The cost file $COST_FILE is malformed"
+            rm -r "test-$RND.log" "$OUTPUT_DIR"
+            exit 1
+        fi
+        echo "Cost file '$COST_FILE' contains $(wc -l < "$COST_FILE") elements"
+
+        echo "executing \"mpirun -np $NUM_PROCS $TEST_BINARY $TEST_ARGS --output-dir=$OUTPUT_DIR --load-balance-cost-file=$COST_FILE\""
+        mpirun -np "$NUM_PROCS" "$TEST_BINARY" $TEST_ARGS --output-dir="$OUTPUT_DIR" \
+               --load-balance-cost-file="$COST_FILE" | tee "test-$RND.log"
+        RET="${PIPESTATUS[0]}"
+        if test "$RET" != "0"; then
+            echo "Executing the binary using the cost file failed!"
+        elif grep -q "does not support cost-weighted load balancing" "test-$RND.log"; then
+            echo "The grid has not been partitioned using the cost file"
+            RET=1
+        fi
+
+        rm -r "test-$RND.log" "$OUTPUT_DIR"
+        exit "$RET"
+        ;;
+
     "--spe1")
         echo "Running the ebos simulator for SPE1CASE1"
 
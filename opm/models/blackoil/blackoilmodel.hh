@@ -205,6 +205,12 @@ public:
 template<class TypeTag>
 struct BlackoilConserveSurfaceVolume<TypeTag, TTag::BlackOilModel> { static constexpr bool value = false; };
 
+//! The CPR preconditioner decouples the pressure from the primary variable which
+//! either is the oil, the gas or the water pressure
+template<class TypeTag>
+struct CprPressureIndex<TypeTag, TTag::BlackOilModel>
+{ static constexpr int value = GetPropType<TypeTag, Properties::Indices>::pressureSwitchIdx; };
+
 } // namespace Opm::Properties
 
 namespace Opm {
@@ -211,6 +211,12 @@ protected:
     friend NewtonMethod<TypeTag>;
     friend ParentType;
 
+    /*!
+     * \copydoc NewtonMethod::pressureVarIdx_
+     */
+    int pressureVarIdx_() const
+    { return Indices::pressureSwitchIdx; }
+
     /*!
      * \copydoc FvBaseNewtonMethod::beginIteration_
      */
@@ -244,6 +250,43 @@ protected:
         ParentType::endIteration_(uCurrentIter, uLastIter);
     }
 
+    /*!
+     * \copydoc NewtonMethod::storeUpdateState_
+     */
+    void storeUpdateState_()
+    {
+        storedWasSwitched_ = wasSwitched_;
+        storedNumPriVarsSwitched_ = numPriVarsSwitched_;
+    }
+
+    /*!
+     * \copydoc NewtonMethod::restoreUpdateState_
+     */
+    void restoreUpdateState_()
+    {
+        wasSwitched_ = storedWasSwitched_;
+        numPriVarsSwitched_ = storedNumPriVarsSwitched_;
+    }
+
+    /*!
+     * \copydoc NewtonMethod::jacobianIsReusable_
+     */
+    bool jacobianIsReusable_() const
+    { return numPriVarsSwitched_ == 0; }
+
+    /*!
+     * \copydoc NewtonMethod::primaryVariablesCompatible_
+     */
+    bool primaryVariablesCompatible_(const PrimaryVariables& a,
+                                     const PrimaryVariables& b) const
+    {
+        return a.primaryVarsMeaningWater() == b.primaryVarsMeaningWater()
+            && a.primaryVarsMeaningPressure() == b.primaryVarsMeaningPressure()
+            && a.primaryVarsMeaningGas() == b.primaryVarsMeaningGas()
+            && a.primaryVarsMeaningBrine() == b.primaryVarsMeaningBrine()
+            && a.primaryVarsMeaningSolvent() == b.primaryVarsMeaningSolvent();
+    }
+
 public:
     void update_(SolutionVector& nextSolution,
                  const SolutionVector& currentSolution,
@@ -489,8 +532,13 @@ protected:
         else
             wasSwitched_[globalDofIdx] = nextValue.adaptPrimaryVariables(this->problem(), globalDofIdx, waterSaturationMax_, waterOnlyThreshold_);
 
-        if (wasSwitched_[globalDofIdx])
+        if (wasSwitched_[globalDofIdx]) {
+            // the primary variables of multiple DOFs may be updated concurrently
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
             ++ numPriVarsSwitched_;
+        }
         if(projectSaturations_){
             nextValue.chopAndNormalizeSaturations();
         }
@@ -515,8 +563,13 @@ private:
     Scalar pressMin_;
 
     // keep track of cells where the primary variable meaning has changed
-    // to detect and hinder oscillations
-    std::vector<bool> wasSwitched_;
+    // to detect and hinder oscillations. a char is used instead of a bool so
+    // that the flags of different cells can be written by multiple threads.
+    std::vector<unsigned char> wasSwitched_;
+
+    // the switching state before the first trial update of the line search
+    std::vector<unsigned char> storedWasSwitched_;
+    int storedNumPriVarsSwitched_;
 };
 } // namespace Opm
 
@@ -72,6 +72,7 @@
 #include <sstream>
 #include <string>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace Opm {
@@ -132,6 +133,34 @@ struct MaxTimeStepDivisions<TypeTag, TTag::FvBaseDiscretization> { static conste
 template<class TypeTag>
 struct ContinueOnConvergenceError<TypeTag, TTag::FvBaseDiscretization> { static constexpr bool value = false; };
 
+//! By default, the size of the next time step is suggested by the Newton method
+template<class TypeTag>
+struct TimeStepControl<TypeTag, TTag::FvBaseDiscretization> { static constexpr auto value = "newton"; };
+template<class TypeTag>
+struct TimeStepControlTolerance<TypeTag, TTag::FvBaseDiscretization>
+{
+    using type = GetPropType<TypeTag, Scalar>;
+    static constexpr type value = 0.1;
+};
+template<class TypeTag>
+struct TimeStepControlGrowthRate<TypeTag, TTag::FvBaseDiscretization>
+{
+    using type = GetPropType<TypeTag, Scalar>;
+    static constexpr type value = 2.0;
+};
+template<class TypeTag>
+struct TimeStepControlGrowthRateAfterFailure<TypeTag, TTag::FvBaseDiscretization>
+{
+    using type = GetPropType<TypeTag, Scalar>;
+    static constexpr type value = 1.2;
+};
+template<class TypeTag>
+struct TimeStepControlDecayRate<TypeTag, TTag::FvBaseDiscretization>
+{
+    using type = GetPropType<TypeTag, Scalar>;
+    static constexpr type value = 0.5;
+};
+
 /*!
  * \brief A vector of quanties, each for one equation.
  */
@@ -261,6 +290,30 @@ struct EnableAsyncVtkOutput<TypeTag, TTag::FvBaseDiscretization> { static conste
 template<class TypeTag>
 struct VtkOutputFormat<TypeTag, TTag::FvBaseDiscretization> { static constexpr int value = Dune::VTK::ascii; };
 
+//! Write VTK files instead of a HDF5 file by default
+template<class TypeTag>
+struct EnableHdf5Output<TypeTag, TTag::FvBaseDiscretization> { static constexpr bool value = false; };
+
+//! Write the fields using single precision by default
+template<class TypeTag>
+struct EnableSinglePrecisionOutput<TypeTag, TTag::FvBaseDiscretization> { static constexpr bool value = true; };
+
+//! Write all fields of the enabled output modules by default
+template<class TypeTag>
+struct OutputFields<TypeTag, TTag::FvBaseDiscretization> { static constexpr auto value = ""; };
+
+//! Do not restrict the output to a subset of the elements by default
+template<class TypeTag>
+struct OutputRegionLower<TypeTag, TTag::FvBaseDiscretization> { static constexpr auto value = ""; };
+template<class TypeTag>
+struct OutputRegionUpper<TypeTag, TTag::FvBaseDiscretization> { static constexpr auto value = ""; };
+template<class TypeTag>
+struct OutputRegionElementsFile<TypeTag, TTag::FvBaseDiscretization> { static constexpr auto value = ""; };
+
+//! Do not measure the linearization cost of the elements by default
+template<class TypeTag>
+struct LoadBalanceCostSteps<TypeTag, TTag::FvBaseDiscretization> { static constexpr unsigned value = 0; };
+
 // disable caching the storage term by default
 template<class TypeTag>
 struct EnableStorageCache<TypeTag, TTag::FvBaseDiscretization> { static constexpr bool value = false; };
@@ -276,6 +329,10 @@ struct EnableConstraints<TypeTag, TTag::FvBaseDiscretization> { static constexpr
 template<class TypeTag>
 struct EnableIntensiveQuantityCache<TypeTag, TTag::FvBaseDiscretization> { static constexpr bool value = false; };
 
+// do not keep the intensive quantities at the beginning of a time step by default
+template<class TypeTag>
+struct EnableIntensiveQuantitySnapshot<TypeTag, TTag::FvBaseDiscretization> { static constexpr bool value = false; };
+
 // do not use thermodynamic hints by default. If you enable this, make sure to also
 // enable the intensive quantity cache above to avoid getting an exception...
 template<class TypeTag>
@@ -456,6 +513,7 @@ public:
         , enableGridAdaptation_( EWOMS_GET_PARAM(TypeTag, bool, EnableGridAdaptation) )
         , enableIntensiveQuantityCache_(EWOMS_GET_PARAM(TypeTag, bool, EnableIntensiveQuantityCache))
         , enableStorageCache_(EWOMS_GET_PARAM(TypeTag, bool, EnableStorageCache))
+        , enableIntensiveQuantitySnapshot_(EWOMS_GET_PARAM(TypeTag, bool, EnableIntensiveQuantitySnapshot))
         , enableThermodynamicHints_(EWOMS_GET_PARAM(TypeTag, bool, EnableThermodynamicHints))
     {
         bool isEcfv = std::is_same<Discretization, EcfvDiscretization<TypeTag> >::value;
@@ -515,6 +573,9 @@ public:
         EWOMS_REGISTER_PARAM(TypeTag, bool, EnableThermodynamicHints, "Enable thermodynamic hints");
         EWOMS_REGISTER_PARAM(TypeTag, bool, EnableIntensiveQuantityCache, "Turn on caching of intensive quantities");
         EWOMS_REGISTER_PARAM(TypeTag, bool, EnableStorageCache, "Store previous storage terms and avoid re-calculating them.");
+        EWOMS_REGISTER_PARAM(TypeTag, bool, EnableIntensiveQuantitySnapshot,
+                             "Keep the cached intensive quantities at the beginning of a time "
+                             "step and restore them if the time integration fails");
         EWOMS_REGISTER_PARAM(TypeTag, std::string, OutputDir, "The directory to which result files are written");
     }
 
@@ -635,6 +696,7 @@ public:
         // also set the solutions of the "previous" time steps to the initial solution.
         for (unsigned timeIdx = 1; timeIdx < historySize; ++timeIdx)
             solution(timeIdx) = solution(/*timeIdx=*/0);
+        invalidateIntensiveQuantitySnapshot();
 
         simulator_.problem().initialSolutionApplied();
 
@@ -856,6 +918,43 @@ public:
         // no post-processing of the solution after a time step! fix it?)
     }
 
+    /*!
+     * \brief Keep the cached intensive quantities for the solution at the beginning of
+     *        the current time step.
+     *
+     * This is called by the Newton method when it updates the solution for the first
+     * time if the first linearization of the time step has been done at the solution of
+     * the last time step. If the time integration fails, updateFailed() restores these
+     * intensive quantities instead of calculating them again. Since the cache is only
+     * filled by the linearization, entries which it did not touch stay invalid.
+     *
+     * The intensive quantities are not copied: The buffer of the cache is exchanged
+     * with the one of the snapshot, so all entries of the cache are invalid afterwards.
+     */
+    void storeIntensiveQuantitySnapshot()
+    {
+        if (!enableIntensiveQuantitySnapshot_ || !enableIntensiveQuantityCache_ || intensiveQuantitySnapshotIsValid_)
+            return;
+
+        std::swap(intensiveQuantityCache_[/*timeIdx=*/0], intensiveQuantitySnapshot_);
+        std::swap(intensiveQuantityCacheUpToDate_[/*timeIdx=*/0], intensiveQuantitySnapshotUpToDate_);
+
+        // the buffer which the cache got is empty for the first snapshot, and its size
+        // is outdated if the grid has changed since the last one
+        intensiveQuantityCache_[/*timeIdx=*/0].resize(intensiveQuantitySnapshot_.size());
+        intensiveQuantityCacheUpToDate_[/*timeIdx=*/0].assign(intensiveQuantitySnapshotUpToDate_.size(),
+                                                              /*value=*/0);
+        intensiveQuantitySnapshotIsValid_ = true;
+    }
+
+    /*!
+     * \brief Discard the intensive quantities kept by storeIntensiveQuantitySnapshot().
+     *
+     * This must be called whenever the solution of the last time step changes.
+     */
+    void invalidateIntensiveQuantitySnapshot()
+    { intensiveQuantitySnapshotIsValid_ = false; }
+
     /*!
      * \brief Returns true iff the storage term is cached.
      *
@@ -1416,7 +1515,17 @@ public:
         // previous time step so that we can start the next
         // update at a physically meaningful solution.
         solution(/*timeIdx=*/0) = solution(/*timeIdx=*/1);
-        invalidateAndUpdateIntensiveQuantities(/*timeIdx=*/0);
+        if (intensiveQuantitySnapshotIsValid_) {
+            // the intensive quantities of the failed attempt are not needed anymore, so
+            // the buffers are exchanged again. the next attempt starts at the same
+            // solution, i.e., its first linearization reuses the restored intensive
+            // quantities and it takes the snapshot again.
+            std::swap(intensiveQuantityCache_[/*timeIdx=*/0], intensiveQuantitySnapshot_);
+            std::swap(intensiveQuantityCacheUpToDate_[/*timeIdx=*/0], intensiveQuantitySnapshotUpToDate_);
+            intensiveQuantitySnapshotIsValid_ = false;
+        }
+        else
+            invalidateAndUpdateIntensiveQuantities(/*timeIdx=*/0);
 
 #ifndef NDEBUG
         for (unsigned timeIdx = 0; timeIdx < historySize; ++timeIdx) {
@@ -1445,6 +1554,7 @@ public:
 
         // make the current solution the previous one.
         solution(/*timeIdx=*/1) = solution(/*timeIdx=*/0);
+        invalidateIntensiveQuantitySnapshot();
 
         // shift the intensive quantities cache by one position in the
         // history
@@ -1900,6 +2010,7 @@ protected:
                 invalidateIntensiveQuantitiesCache(timeIdx);
             }
         }
+        invalidateIntensiveQuantitySnapshot();
     }
     template <class Context>
     void supplementInitialSolution_(PrimaryVariables&,
@@ -1982,9 +2093,15 @@ protected:
 
     mutable GlobalEqVector storageCache_[historySize];
 
+    // the cached intensive quantities for the solution at the beginning of the time step
+    IntensiveQuantitiesVector intensiveQuantitySnapshot_;
+    std::vector<unsigned char> intensiveQuantitySnapshotUpToDate_;
+    bool intensiveQuantitySnapshotIsValid_{false};
+
     bool enableGridAdaptation_;
     bool enableIntensiveQuantityCache_;
     bool enableStorageCache_;
+    bool enableIntensiveQuantitySnapshot_;
     bool enableThermodynamicHints_;
 };
 
@@ -36,6 +36,7 @@
 #include <opm/grid/utility/SparseTable.hpp>
 
 #include <opm/models/parallel/gridcommhandles.hh>
+#include <opm/models/utils/parametersystem.hh>
 #include <opm/models/parallel/threadmanager.hh>
 #include <opm/models/parallel/threadedentityiterator.hh>
 #include <opm/models/discretization/common/baseauxiliarymodule.hh>
@@ -44,11 +45,15 @@
 #include <dune/common/fvector.hh>
 #include <dune/common/fmatrix.hh>
 
+#include <chrono>
+#include <fstream>
 #include <type_traits>
 #include <iostream>
 #include <vector>
 #include <thread>
 #include <set>
+#include <stdexcept>
+#include <string>
 #include <exception>   // current_exception, rethrow_exception
 #include <mutex>
 
@@ -131,7 +136,12 @@ public:
      * \brief Register all run-time parameters for the Jacobian linearizer.
      */
     static void registerParameters()
-    { }
+    {
+        EWOMS_REGISTER_PARAM(TypeTag, unsigned, LoadBalanceCostSteps,
+                             "The number of time steps for which the time required to "
+                             "linearize each element is measured and written to a file "
+                             "for load balancing later runs (0 = disabled)");
+    }
 
     /*!
      * \brief Initialize the linearizer.
@@ -153,6 +163,24 @@ public:
         }
         elementCtx_.resize(0);
         fullDomain_ = std::make_unique<FullDomain>(simulator.gridView());
+
+        costSteps_ = EWOMS_GET_PARAM(TypeTag, unsigned, LoadBalanceCostSteps);
+        costWritten_ = false;
+        elementCost_.clear();
+    }
+
+    /*!
+     * \brief Write the linearization cost of the elements if it has been measured but
+     *        not been written yet.
+     *
+     * This is called at the end of the simulation, so that the cost file is also
+     * written if the simulation is shorter than the number of time steps specified by
+     * the LoadBalanceCostSteps parameter.
+     */
+    void finishCostMeasurement()
+    {
+        if (costSteps_ > 0 && !costWritten_)
+            writeElementCost_();
     }
 
     /*!
@@ -240,6 +268,64 @@ public:
             throw NumericalProblem("A process did not succeed in linearizing the system");
     }
 
+    /*!
+     * \brief Linearize a subdomain of the local process.
+     *
+     * In contrast to linearizeDomain(), this method does not communicate with the other
+     * processes, so each process may linearize a different number of subdomains. Only
+     * the rows of the residual and of the Jacobian which belong to the subdomain are
+     * valid afterwards, and exceptions are passed on to the caller.
+     */
+    template <class SubDomainType>
+    void linearizeLocalDomain(const SubDomainType& domain)
+    {
+        OPM_TIMEBLOCK(linearizeLocalDomain);
+        resetSystem_(domain);
+        linearize_(domain);
+    }
+
+    /*!
+     * \brief Evaluate the residual of the spatial domain for the current solution while
+     *        keeping the Jacobian matrix of the last linearization.
+     *
+     * This is cheaper than linearizeDomain() because the local Jacobian matrices are
+     * neither computed nor added to the global one. It is used by Newton methods which
+     * solve several iterations with the same Jacobian, so the system must have been
+     * linearized at least once before. The auxiliary equations are not considered.
+     */
+    void linearizeResidual()
+    {
+        OPM_TIMEBLOCK(linearizeResidual);
+        if (!jacobian_)
+            throw std::logic_error("The residual can only be evaluated on its own "
+                                   "after the system has been linearized");
+
+        int succeeded;
+        try {
+            residual_ = 0.0;
+            evalResidual_();
+            succeeded = 1;
+        }
+        catch (const std::exception& e)
+        {
+            std::cout << "rank " << simulator_().gridView().comm().rank()
+                      << " caught an exception while evaluating the residual:" << e.what()
+                      << "\n"  << std::flush;
+            succeeded = 0;
+        }
+        catch (...)
+        {
+            std::cout << "rank " << simulator_().gridView().comm().rank()
+                      << " caught an exception while evaluating the residual"
+                      << "\n"  << std::flush;
+            succeeded = 0;
+        }
+        succeeded = simulator_().gridView().comm().min(succeeded);
+
+        if (!succeeded)
+            throw NumericalProblem("A process did not succeed in evaluating the residual");
+    }
+
     void finalize()
     { jacobian_->finalize(); }
 
@@ -523,6 +609,19 @@ private:
 
         applyConstraintsToSolution_();
 
+        // the linearization cost of the elements is only measured for the full domain
+        bool recordCost = false;
+        if constexpr (std::is_same_v<SubDomainType, FullDomain>) {
+            if (costSteps_ > 0 && !costWritten_) {
+                if (simulator_().timeStepIndex() >= static_cast<int>(costSteps_))
+                    writeElementCost_();
+                else {
+                    recordCost = true;
+                    elementCost_.resize(static_cast<std::size_t>(gridView_().size(/*codim=*/0)), 0.0);
+                }
+            }
+        }
+
         // to avoid a race condition if two threads handle an exception at the same time,
         // we use an explicit lock to control access to the exception storage object
         // amongst thread-local handlers
@@ -560,7 +659,15 @@ private:
                     if (!linearizeNonLocalElements && elem.partitionType() != Dune::InteriorEntity)
                         continue;
 
-                    linearizeElement_(elem);
+                    if (recordCost) {
+                        const auto startTime = std::chrono::steady_clock::now();
+                        linearizeElement_(elem);
+                        const std::chrono::duration<double> duration =
+                            std::chrono::steady_clock::now() - startTime;
+                        elementCost_[elementMapper_().index(elem)] += duration.count();
+                    }
+                    else
+                        linearizeElement_(elem);
                 }
             }
             // If an exception occurs in the parallel block, it won't escape the
@@ -589,6 +696,63 @@ private:
         applyConstraintsToLinearization_();
     }
 
+    // evaluate the residual of all elements without their local Jacobian matrices
+    void evalResidual_()
+    {
+        std::mutex exceptionLock;
+        std::exception_ptr exceptionPtr = nullptr;
+
+        ThreadedEntityIterator<GridView, /*codim=*/0> threadedElemIt(gridView_());
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        {
+            unsigned threadId = ThreadManager::threadId();
+            ElementIterator elemIt = threadedElemIt.beginParallel();
+            try {
+                for (; !threadedElemIt.isFinished(elemIt); elemIt = threadedElemIt.increment()) {
+                    const Element& elem = *elemIt;
+                    if (!linearizeNonLocalElements && elem.partitionType() != Dune::InteriorEntity)
+                        continue;
+
+                    ElementContext& elemCtx = *elementCtx_[threadId];
+                    auto& localResidual = model_().localResidual(threadId);
+                    elemCtx.updateAll(elem);
+                    localResidual.eval(elemCtx);
+
+                    if (getPropValue<TypeTag, Properties::UseLinearizationLock>())
+                        globalMatrixMutex_.lock();
+
+                    size_t numPrimaryDof = elemCtx.numPrimaryDof(/*timeIdx=*/0);
+                    for (unsigned primaryDofIdx = 0; primaryDofIdx < numPrimaryDof; ++ primaryDofIdx) {
+                        unsigned globI = elemCtx.globalSpaceIndex(/*spaceIdx=*/primaryDofIdx, /*timeIdx=*/0);
+                        const auto& localRes = localResidual.residual(primaryDofIdx);
+                        for (unsigned eqIdx = 0; eqIdx < numEq; ++ eqIdx)
+                            residual_[globI][eqIdx] += Toolbox::value(localRes[eqIdx]);
+                    }
+
+                    if (getPropValue<TypeTag, Properties::UseLinearizationLock>())
+                        globalMatrixMutex_.unlock();
+                }
+            }
+            catch(...) {
+                std::lock_guard<std::mutex> take(exceptionLock);
+                exceptionPtr = std::current_exception();
+                threadedElemIt.setFinished();
+            }
+        }
+
+        if (exceptionPtr)
+            std::rethrow_exception(exceptionPtr);
+
+        // the Jacobian matrix already exhibits the rows of the constraint degrees of
+        // freedom, only the residual needs to be updated
+        if (enableConstraints_()) {
+            for (const auto& constraint : constraintsMap_)
+                residual_[constraint.first] = 0.0;
+        }
+    }
+
 
     // linearize an element in the interior of the process' grid partition
     template <class ElementType>
@@ -625,6 +789,71 @@ private:
             globalMatrixMutex_.unlock();
     }
 
+    // write the measured linearization cost of the interior elements to a file in the
+    // output directory and report how well the load was balanced. all elements end up
+    // in a single file on the first process.
+    void writeElementCost_()
+    {
+        costWritten_ = true;
+
+        const auto& gridView = gridView_();
+        enum { dimWorld = GridView::dimensionworld };
+        std::vector<double> localData;
+        double localCost = 0.0;
+        for (const auto& elem : elements(gridView, Dune::Partitions::interior)) {
+            unsigned elemIdx = elementMapper_().index(elem);
+            double cost = (elemIdx < elementCost_.size()) ? elementCost_[elemIdx] : 0.0;
+            const auto& center = elem.geometry().center();
+            for (unsigned k = 0; k < dimWorld; ++k)
+                localData.push_back(center[k]);
+            localData.push_back(cost);
+            localCost += cost;
+        }
+        elementCost_.clear();
+
+        const auto& comm = gridView.comm();
+        double maxCost = comm.max(localCost);
+        double totalCost = comm.sum(localCost);
+
+        std::vector<double> allData;
+        if (comm.size() > 1) {
+            int numLocal = static_cast<int>(localData.size());
+            std::vector<int> counts(static_cast<std::size_t>(comm.size()));
+            comm.gather(&numLocal, counts.data(), 1, /*root=*/0);
+
+            std::vector<int> displacements(counts.size(), 0);
+            for (std::size_t rank = 1; rank < counts.size(); ++rank)
+                displacements[rank] = displacements[rank - 1] + counts[rank - 1];
+
+            if (comm.rank() == 0)
+                allData.resize(static_cast<std::size_t>(displacements.back() + counts.back()));
+            comm.gatherv(localData.data(), numLocal, allData.data(),
+                         counts.data(), displacements.data(), /*root=*/0);
+        }
+        else
+            allData = std::move(localData);
+
+        if (comm.rank() != 0)
+            return;
+
+        const std::string fileName =
+            problem_().outputDir() + "/" + problem_().name() + "-cost.txt";
+        std::ofstream costFile(fileName);
+        if (!costFile)
+            throw std::runtime_error("Could not open cost file '"+fileName+"' for writing");
+        costFile.precision(10);
+        for (std::size_t i = 0; i + dimWorld < allData.size(); i += dimWorld + 1) {
+            for (unsigned k = 0; k < dimWorld; ++k)
+                costFile << allData[i + k] << " ";
+            costFile << allData[i + dimWorld] << "\n";
+        }
+
+        double meanCost = totalCost/comm.size();
+        std::cout << "Linearization cost of the elements written to '" << fileName << "'. "
+                  << "Load imbalance (maximum/mean cost per process): "
+                  << ((meanCost > 0.0) ? maxCost/meanCost : 1.0) << "\n" << std::flush;
+    }
+
     // apply the constraints to the solution. (i.e., the solution of constraint degrees
     // of freedom is set to the value of the constraint.)
     void applyConstraintsToSolution_()
@@ -697,6 +926,12 @@ private:
 
     std::vector<std::set<unsigned int>> sparsityPattern_;
 
+    // the time spent to linearize each element [s] (only used if the
+    // LoadBalanceCostSteps parameter is non-zero)
+    unsigned costSteps_ = 0;
+    bool costWritten_ = false;
+    std::vector<double> elementCost_;
+
     struct FullDomain
     {
         explicit FullDomain(const GridView& v) : view (v) {}
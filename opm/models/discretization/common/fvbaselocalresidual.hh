@@ -538,10 +538,13 @@ protected:
                 if (model.newtonMethod().numIterations() == 0 &&
                     !elemCtx.haveStashedIntensiveQuantities())
                 {
-                    if (!elemCtx.problem().recycleFirstIterationStorage()) {
+                    if (!elemCtx.problem().recycleFirstIterationStorage() ||
+                        model.newtonMethod().solutionPredicted())
+                    {
                         // we re-calculate the storage term for the solution of the
                         // previous time step from scratch instead of using the one of
-                        // the first iteration of the current time step.
+                        // the first iteration of the current time step. this is also
+                        // required if the initial solution has been extrapolated.
                         tmp2 = 0.0;
                         elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/1);
                         asImp_().computeStorage(tmp2, elemCtx,  dofIdx, /*timeIdx=*/1);
@@ -29,15 +29,29 @@
 #define EWOMS_FV_BASE_NEWTON_METHOD_HH
 
 #include "fvbasenewtonconvergencewriter.hh"
+#include "fvbasesubdomains.hh"
 
 #include <opm/models/nonlinear/newtonmethod.hh>
+#include <opm/models/utils/parametersystem.hh>
 #include <opm/models/utils/propertysystem.hh>
 
+#include <opm/common/Exceptions.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <iostream>
+#include <type_traits>
+#include <vector>
+
 namespace Opm {
 
 template <class TypeTag>
 class FvBaseNewtonMethod;
 
+template <class TypeTag>
+class FvBaseLinearizer;
+
 template <class TypeTag>
 class FvBaseNewtonConvergenceWriter;
 } // namespace Opm
@@ -54,6 +68,22 @@ struct FvBaseNewtonMethod { using InheritsFrom = std::tuple<NewtonMethod>; };
 template<class TypeTag, class MyTypeTag>
 struct DiscNewtonMethod { using type = UndefinedProperty; };
 
+//! The number of subdomains per process of the nonlinear domain decomposition
+template<class TypeTag, class MyTypeTag>
+struct NewtonNlddSubdomains { using type = UndefinedProperty; };
+
+//! The maximum number of Newton iterations of a subdomain
+template<class TypeTag, class MyTypeTag>
+struct NewtonNlddLocalIterations { using type = UndefinedProperty; };
+
+//! The relative residual reduction of the linear solver of a subdomain
+template<class TypeTag, class MyTypeTag>
+struct NewtonNlddLinearTolerance { using type = UndefinedProperty; };
+
+//! The maximum number of iterations of the linear solver of a subdomain
+template<class TypeTag, class MyTypeTag>
+struct NewtonNlddLinearMaxIterations { using type = UndefinedProperty; };
+
 // set default values
 template<class TypeTag>
 struct DiscNewtonMethod<TypeTag, TTag::FvBaseNewtonMethod>
@@ -67,6 +97,20 @@ template<class TypeTag>
 struct NewtonConvergenceWriter<TypeTag, TTag::FvBaseNewtonMethod>
 { using type = FvBaseNewtonConvergenceWriter<TypeTag>; };
 
+// the nonlinear domain decomposition is disabled by default
+template<class TypeTag>
+struct NewtonNlddSubdomains<TypeTag, TTag::FvBaseNewtonMethod> { static constexpr int value = 0; };
+template<class TypeTag>
+struct NewtonNlddLocalIterations<TypeTag, TTag::FvBaseNewtonMethod> { static constexpr int value = 5; };
+template<class TypeTag>
+struct NewtonNlddLinearTolerance<TypeTag, TTag::FvBaseNewtonMethod>
+{
+    using type = GetPropType<TypeTag, Scalar>;
+    static constexpr type value = 1e-3;
+};
+template<class TypeTag>
+struct NewtonNlddLinearMaxIterations<TypeTag, TTag::FvBaseNewtonMethod> { static constexpr int value = 100; };
+
 } // namespace Opm::Properties
 
 namespace Opm {
@@ -78,6 +122,12 @@ namespace Opm {
  *
  * This class is sufficient for most models which use an Element or a
  * Vertex Centered Finite Volume discretization.
+ *
+ * For the element centered discretization, each but the first Newton iteration can
+ * optionally be preceded by a nonlinear domain decomposition step: The interior of each process is
+ * split into subdomains and the nonlinear system of each subdomain is solved by a local
+ * Newton method while the solution outside of the subdomain is kept fixed. The global
+ * Newton iteration which follows corrects the coupling between the subdomains.
  */
 template <class TypeTag>
 class FvBaseNewtonMethod : public NewtonMethod<TypeTag>
@@ -94,15 +144,63 @@ class FvBaseNewtonMethod : public NewtonMethod<TypeTag>
     using PrimaryVariables = GetPropType<TypeTag, Properties::PrimaryVariables>;
     using EqVector = GetPropType<TypeTag, Properties::EqVector>;
 
+    using Subdomains = FvBaseSubdomains<TypeTag>;
+    using Subdomain = typename Subdomains::Subdomain;
+
+    enum { numEq = getPropValue<TypeTag, Properties::NumEq>() };
 
 public:
     FvBaseNewtonMethod(Simulator& simulator)
         : ParentType(simulator)
+        , subdomains_(simulator)
     { }
 
+    /*!
+     * \brief Register all run-time parameters for the Newton method.
+     */
+    static void registerParameters()
+    {
+        ParentType::registerParameters();
+
+        EWOMS_REGISTER_PARAM(TypeTag, int, NewtonNlddSubdomains,
+                             "The number of subdomains per process of the nonlinear "
+                             "domain decomposition which precedes each but the first "
+                             "Newton iteration (0: disabled)");
+        EWOMS_REGISTER_PARAM(TypeTag, int, NewtonNlddLocalIterations,
+                             "The maximum number of Newton iterations of a subdomain");
+        EWOMS_REGISTER_PARAM(TypeTag, Scalar, NewtonNlddLinearTolerance,
+                             "The relative residual reduction of the linear solver "
+                             "of a subdomain");
+        EWOMS_REGISTER_PARAM(TypeTag, int, NewtonNlddLinearMaxIterations,
+                             "The maximum number of iterations of the linear solver "
+                             "of a subdomain");
+    }
+
+    /*!
+     * \copydoc NewtonMethod::eraseMatrix()
+     */
+    void eraseMatrix()
+    {
+        ParentType::eraseMatrix();
+        subdomains_.reset();
+    }
+
 protected:
     friend class NewtonMethod<TypeTag>;
 
+    /*!
+     * \copydoc NewtonMethod::begin_
+     */
+    void begin_(const SolutionVector& u)
+    {
+        ParentType::begin_(u);
+
+        // unless the initial solution has been extrapolated or it is modified by the
+        // subdomain solves, the first linearization is done at the solution of the
+        // last time step
+        snapshotPending_ = !this->predicted_ && !asImp_().useNldd_();
+    }
+
     /*!
      * \brief Update the current solution with a delta vector.
      *
@@ -127,6 +225,15 @@ protected:
     {
         ParentType::update_(nextSolution, currentSolution, solutionUpdate, currentResidual);
 
+        // the cache holds the intensive quantities of the first linearization of the
+        // time step until the solution is updated for the first time. if they have
+        // been calculated at the solution of the last time step, the model is asked to
+        // keep them, so a failed time step can be rolled back cheaply.
+        if (snapshotPending_) {
+            model_().storeIntensiveQuantitySnapshot();
+            snapshotPending_ = false;
+        }
+
         // make sure that the intensive quantities get recalculated at the next
         // linearization
         if (model_().storeIntensiveQuantities()) {
@@ -142,9 +249,149 @@ protected:
      */
     void beginIteration_()
     {
+        // the first iteration caches the storage term of the last time step if the
+        // problem recycles it, so it must linearize the unmodified initial solution.
+        // the subdomains are thus only solved from the second iteration on, and their
+        // linearizations then never touch the cached storage.
+        const bool useNldd = this->numIterations() > 0 && asImp_().useNldd_();
+        int numConverged = 0;
+        if constexpr (std::is_same_v<Linearizer, FvBaseLinearizer<TypeTag>>) {
+            if (useNldd)
+                numConverged = solveSubdomains_();
+        }
+
         model_().syncOverlap();
 
         ParentType::beginIteration_();
+
+        if (useNldd) {
+            const auto& comm = this->simulator_.gridView().comm();
+            const int numSubdomains = comm.sum(static_cast<int>(subdomains_.subdomains().size()));
+            numConverged = comm.sum(numConverged);
+            this->endIterMsg() << ", converged subdomains: " << numConverged << "/" << numSubdomains;
+        }
+    }
+
+    /*!
+     * \brief Returns true if the nonlinear domain decomposition ought to be used.
+     *
+     * The subdomains are linearized by the linearizer of the finite volume
+     * discretizations, and they are sets of elements, so the nonlinear domain
+     * decomposition is only available if this linearizer is used and if the degrees
+     * of freedom are the elements.
+     */
+    bool useNldd_()
+    {
+        const int numSubdomains = EWOMS_GET_PARAM(TypeTag, int, NewtonNlddSubdomains);
+        if (numSubdomains < 1)
+            return false;
+
+        if constexpr (std::is_same_v<Linearizer, FvBaseLinearizer<TypeTag>>) {
+            if (subdomains_.create(numSubdomains))
+                return true;
+        }
+
+        if (!nlddFallbackReported_ && this->verbose_())
+            std::cout << "Newton: The nonlinear domain decomposition is not applicable "
+                      << "to this model, using the global Newton method only\n" << std::flush;
+        nlddFallbackReported_ = true;
+        return false;
+    }
+
+    /*!
+     * \brief Solve the nonlinear systems of all subdomains of the local process.
+     *
+     * The subdomains are solved one after another, so each subdomain sees the updated
+     * solution of the ones which have been solved before it. If the local Newton
+     * method of a subdomain breaks down, the solution of the subdomain is reset to the
+     * one before its local solve.
+     *
+     * \return The number of subdomains for which the local Newton method converged.
+     */
+    int solveSubdomains_()
+    {
+        SolutionVector& solution = model_().solution(/*timeIdx=*/0);
+
+        int numConverged = 0;
+        std::vector<PrimaryVariables> initialValues;
+        for (auto& subdomain : subdomains_.subdomains()) {
+            initialValues.clear();
+            for (unsigned dofIdx : subdomain.dofs)
+                initialValues.push_back(solution[dofIdx]);
+
+            try {
+                if (solveSubdomain_(subdomain, solution))
+                    ++numConverged;
+            }
+            catch (const std::exception&) {
+                for (std::size_t i = 0; i < subdomain.dofs.size(); ++i)
+                    solution[subdomain.dofs[i]] = initialValues[i];
+                model_().invalidateAndUpdateIntensiveQuantities(/*timeIdx=*/0, subdomain.view);
+            }
+        }
+
+        // the overlap is synchronized after the subdomains have been solved, so the
+        // intensive quantities of all degrees of freedom must be recalculated
+        if (model_().storeIntensiveQuantities()) {
+            for (unsigned dofIdx = 0; dofIdx < model_().numGridDof(); ++dofIdx)
+                model_().setIntensiveQuantitiesCacheEntryValidity(dofIdx,
+                                                                  /*timeIdx=*/0,
+                                                                  /*valid=*/false);
+        }
+
+        return numConverged;
+    }
+
+    /*!
+     * \brief Run the local Newton method of a subdomain.
+     *
+     * The residual is evaluated using the same weights and tolerance as for the global
+     * system, but only the rows of the subdomain are considered.
+     *
+     * \return true if the residual of the subdomain has converged.
+     */
+    bool solveSubdomain_(Subdomain& subdomain, SolutionVector& solution)
+    {
+        auto& linearizer = model_().linearizer();
+        const int maxIterations = EWOMS_GET_PARAM(TypeTag, int, NewtonNlddLocalIterations);
+        const Scalar linearTolerance = EWOMS_GET_PARAM(TypeTag, Scalar, NewtonNlddLinearTolerance);
+        const int linearMaxIterations = EWOMS_GET_PARAM(TypeTag, int, NewtonNlddLinearMaxIterations);
+
+        for (int iterIdx = 0; ; ++iterIdx) {
+            linearizer.linearizeLocalDomain(subdomain);
+            const auto& residual = linearizer.residual();
+
+            Scalar error = 0.0;
+            for (unsigned dofIdx : subdomain.dofs) {
+                if (model_().dofTotalVolume(dofIdx) <= 0.0)
+                    continue;
+
+                for (unsigned eqIdx = 0; eqIdx < numEq; ++eqIdx)
+                    error = std::max(std::abs(residual[dofIdx][eqIdx]*model_().eqWeight(dofIdx, eqIdx)),
+                                     error);
+            }
+
+            if (error <= this->tolerance())
+                return true;
+            if (iterIdx >= maxIterations)
+                return false;
+
+            subdomains_.assemble(subdomain, linearizer.jacobian().istlMatrix(), residual);
+            if (!Subdomains::solve(subdomain, linearTolerance, linearMaxIterations))
+                throw NumericalProblem("The linear solver of a subdomain did not converge");
+
+            for (std::size_t i = 0; i < subdomain.dofs.size(); ++i) {
+                const unsigned dofIdx = subdomain.dofs[i];
+                const PrimaryVariables currentValue(solution[dofIdx]);
+                asImp_().updatePrimaryVariables_(dofIdx,
+                                                 solution[dofIdx],
+                                                 currentValue,
+                                                 subdomain.update[i],
+                                                 residual[dofIdx]);
+            }
+
+            model_().invalidateAndUpdateIntensiveQuantities(/*timeIdx=*/0, subdomain.view);
+        }
     }
 
     /*!
@@ -165,6 +412,10 @@ private:
 
     const Implementation& asImp_() const
     { return *static_cast<const Implementation*>(this); }
+
+    Subdomains subdomains_;
+    bool nlddFallbackReported_{false};
+    bool snapshotPending_{false};
 };
 } // namespace Opm
 
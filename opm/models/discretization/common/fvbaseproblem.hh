@@ -29,16 +29,26 @@
 #define EWOMS_FV_BASE_PROBLEM_HH
 
 #include "fvbaseproperties.hh"
+#include "fvbasetimestepcontrol.hh"
 
 #include <opm/models/io/vtkmultiwriter.hh>
+#include <opm/models/io/hdf5multiwriter.hh>
+#include <opm/models/io/probeoutputmodule.hh>
 #include <opm/models/io/restart.hh>
 #include <opm/models/discretization/common/restrictprolong.hh>
 
 #include <dune/common/fvector.hh>
 
+#include <fstream>
 #include <iostream>
 #include <limits>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
 #include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #include <sys/stat.h>
 
@@ -51,6 +61,19 @@ struct NewtonMethod;
 
 namespace Opm {
 
+namespace detail {
+
+//! Detects linearizers which measure the linearization cost of the elements.
+template <class Linearizer, class = void>
+struct MeasuresElementCost : std::false_type {};
+
+template <class Linearizer>
+struct MeasuresElementCost<Linearizer,
+                           std::void_t<decltype(std::declval<Linearizer&>().finishCostMeasurement())>>
+    : std::true_type {};
+
+} // namespace detail
+
 /*!
  * \ingroup FiniteVolumeDiscretizations
  *
@@ -69,6 +92,8 @@ private:
 
     static const int vtkOutputFormat = getPropValue<TypeTag, Properties::VtkOutputFormat>();
     using VtkMultiWriter = ::Opm::VtkMultiWriter<GridView, vtkOutputFormat>;
+    using Hdf5MultiWriter = ::Opm::Hdf5MultiWriter<GridView>;
+    using ProbeOutputModule = ::Opm::ProbeOutputModule<TypeTag>;
 
     using Model = GetPropType<TypeTag, Properties::Model>;
     using Scalar = GetPropType<TypeTag, Properties::Scalar>;
@@ -114,6 +139,7 @@ public:
      */
     FvBaseProblem(Simulator& simulator)
         : nextTimeStepSize_(0.0)
+        , timeStepControl_(simulator)
         , gridView_(simulator.gridView())
         , elementMapper_(gridView_, Dune::mcmgElementLayout())
         , vertexMapper_(gridView_, Dune::mcmgVertexLayout())
@@ -121,6 +147,7 @@ public:
         , boundingBoxMax_(-std::numeric_limits<double>::max())
         , simulator_(simulator)
         , defaultVtkWriter_(0)
+        , defaultHdf5Writer_(0)
     {
         // calculate the bounding box of the local partition of the grid view
         VertexIterator vIt = gridView_.template begin<dim>();
@@ -153,13 +180,34 @@ public:
 
             std::string outputDir = asImp_().outputDir();
 
-            defaultVtkWriter_ =
-                new VtkMultiWriter(asyncVtkOutput, gridView_, outputDir, asImp_().name());
+            if (enableHdf5Output_()) {
+                defaultHdf5Writer_ =
+                    new Hdf5MultiWriter(gridView_, outputDir, asImp_().name());
+                configureOutputWriter_(*defaultHdf5Writer_);
+                configureOutputRegion_(*defaultHdf5Writer_);
+            }
+            else {
+                defaultVtkWriter_ =
+                    new VtkMultiWriter(asyncVtkOutput, gridView_, outputDir, asImp_().name());
+                configureOutputWriter_(*defaultVtkWriter_);
+
+                if (outputRegionSpecified_())
+                    throw std::runtime_error("Restricting the output to a region of the "
+                                             "grid is only supported by the HDF5 output");
+            }
         }
+
+        if (ProbeOutputModule::enabled())
+            probeModule_ = std::make_unique<ProbeOutputModule>(simulator_,
+                                                               asImp_().outputDir(),
+                                                               asImp_().name());
     }
 
     ~FvBaseProblem()
-    { delete defaultVtkWriter_; }
+    {
+        delete defaultVtkWriter_;
+        delete defaultHdf5Writer_;
+    }
 
     /*!
      * \brief Registers all available parameters for the problem and
@@ -168,6 +216,7 @@ public:
     static void registerParameters()
     {
         Model::registerParameters();
+        ProbeOutputModule::registerParameters();
         EWOMS_REGISTER_PARAM(TypeTag, Scalar, MaxTimeStepSize,
                              "The maximum size to which all time steps are limited to [s]");
         EWOMS_REGISTER_PARAM(TypeTag, Scalar, MinTimeStepSize,
@@ -175,8 +224,28 @@ public:
         EWOMS_REGISTER_PARAM(TypeTag, unsigned, MaxTimeStepDivisions,
                              "The maximum number of divisions by two of the timestep size "
                              "before the simulation bails out");
+        FvBaseTimeStepControl<TypeTag>::registerParameters();
         EWOMS_REGISTER_PARAM(TypeTag, bool, EnableAsyncVtkOutput,
                              "Dispatch a separate thread to write the VTK output");
+        EWOMS_REGISTER_PARAM(TypeTag, bool, EnableHdf5Output,
+                             "Write the visualization output of all time steps into a single "
+                             "HDF5 file plus an XDMF descriptor instead of VTK files");
+        EWOMS_REGISTER_PARAM(TypeTag, bool, EnableSinglePrecisionOutput,
+                             "Convert the output fields to 32 bit floating point values");
+        EWOMS_REGISTER_PARAM(TypeTag, std::string, OutputFields,
+                             "A comma separated list of the fields which are written. Names "
+                             "ending with '*' match all fields starting with the prefix. "
+                             "An empty list selects all fields.");
+        EWOMS_REGISTER_PARAM(TypeTag, std::string, OutputRegionLower,
+                             "Comma separated coordinates of the lower left corner of the "
+                             "box of elements which are written (HDF5 output only)");
+        EWOMS_REGISTER_PARAM(TypeTag, std::string, OutputRegionUpper,
+                             "Comma separated coordinates of the upper right corner of the "
+                             "box of elements which are written (HDF5 output only)");
+        EWOMS_REGISTER_PARAM(TypeTag, std::string, OutputRegionElementsFile,
+                             "A file containing the global (i.e., cartesian for "
+                             "structured grids) indices of the elements which are "
+                             "written (HDF5 output only)");
         EWOMS_REGISTER_PARAM(TypeTag, bool, ContinueOnConvergenceError,
                              "Continue with a non-converged solution instead of giving up "
                              "if we encounter a time step size smaller than the minimum time "
@@ -308,8 +377,12 @@ public:
                 vertexMapper_.update();
 #endif
 
-        if (enableVtkOutput_())
+        if (defaultVtkWriter_)
             defaultVtkWriter_->gridChanged();
+        if (defaultHdf5Writer_)
+            defaultHdf5Writer_->gridChanged();
+        if (probeModule_)
+            probeModule_->gridChanged();
     }
 
     /*!
@@ -462,6 +535,12 @@ public:
      */
     void finalize()
     {
+        // the simulation may have been shorter than the number of time steps for which
+        // the linearization cost of the elements is measured
+        using Linearizer = std::remove_reference_t<decltype(model().linearizer())>;
+        if constexpr (detail::MeasuresElementCost<Linearizer>::value)
+            model().linearizer().finishCostMeasurement();
+
         const auto& executionTimer = simulator().executionTimer();
 
         Scalar executionTime = executionTimer.realTimeElapsed();
@@ -516,17 +595,20 @@ public:
         std::string errorMessage;
         for (unsigned i = 0; i < maxFails; ++i) {
             bool converged = model().update();
-            if (converged)
+            if (converged) {
+                timeStepControl_.timeStepSucceeded(/*hadFailures=*/i > 0);
                 return;
+            }
 
             Scalar dt = simulator().timeStepSize();
-            Scalar nextDt = dt / 2.0;
+            Scalar nextDt = timeStepControl_.failedTimeStepSize(dt);
             if (dt < minTimeStepSize*(1 + 1e-9)) {
                 if (asImp_().continueOnConvergenceError()) {
                     if (gridView().comm().rank() == 0)
                         std::cout << "Newton solver did not converge with minimum time step of "
                                   << dt << " seconds. Continuing with unconverged solution!\n"
                                   << std::flush;
+                    timeStepControl_.timeStepSucceeded(/*hadFailures=*/true);
                     return;
                 }
                 else {
@@ -593,7 +675,7 @@ public:
             return nextTimeStepSize_;
 
         Scalar dtNext = std::min(EWOMS_GET_PARAM(TypeTag, Scalar, MaxTimeStepSize),
-                                 newtonMethod().suggestTimeStepSize(simulator().timeStepSize()));
+                                 timeStepControl_.suggestTimeStepSize(simulator().timeStepSize()));
 
         if (dtNext < simulator().maxTimeStepSize()
             && simulator().maxTimeStepSize() < dtNext*2)
@@ -635,7 +717,14 @@ public:
      *        model should be prepared to do the next time integration.
      */
     void advanceTimeLevel()
-    { model().advanceTimeLevel(); }
+    {
+        // record the time series of the probes for the solution of the time step
+        // which has just been completed
+        if (probeModule_)
+            probeModule_->sample(simulator().time() + simulator().timeStepSize());
+
+        model().advanceTimeLevel();
+    }
 
     /*!
      * \brief The problem name.
@@ -753,8 +842,10 @@ public:
     template <class Restarter>
     void serialize(Restarter& res)
     {
-        if (enableVtkOutput_())
+        if (defaultVtkWriter_)
             defaultVtkWriter_->serialize(res);
+        if (defaultHdf5Writer_)
+            defaultHdf5Writer_->serialize(res);
     }
 
     /*!
@@ -770,8 +861,10 @@ public:
     template <class Restarter>
     void deserialize(Restarter& res)
     {
-        if (enableVtkOutput_())
+        if (defaultVtkWriter_)
             defaultVtkWriter_->deserialize(res);
+        if (defaultHdf5Writer_)
+            defaultHdf5Writer_->deserialize(res);
     }
 
     /*!
@@ -792,6 +885,14 @@ public:
         // calculate the time _after_ the time was updated
         Scalar t = simulator().time() + simulator().timeStepSize();
 
+        if (defaultHdf5Writer_) {
+            defaultHdf5Writer_->beginWrite(t);
+            model().prepareOutputFields();
+            model().appendOutputFields(*defaultHdf5Writer_);
+            defaultHdf5Writer_->endWrite();
+            return;
+        }
+
         defaultVtkWriter_->beginWrite(t);
         model().prepareOutputFields();
         model().appendOutputFields(*defaultVtkWriter_);
@@ -808,11 +909,71 @@ public:
 
 protected:
     Scalar nextTimeStepSize_;
+    FvBaseTimeStepControl<TypeTag> timeStepControl_;
 
 private:
     bool enableVtkOutput_() const
     { return EWOMS_GET_PARAM(TypeTag, bool, EnableVtkOutput); }
 
+    bool enableHdf5Output_() const
+    { return EWOMS_GET_PARAM(TypeTag, bool, EnableHdf5Output); }
+
+    bool outputRegionSpecified_() const
+    {
+        return
+            !EWOMS_GET_PARAM(TypeTag, std::string, OutputRegionLower).empty()
+            || !EWOMS_GET_PARAM(TypeTag, std::string, OutputRegionUpper).empty()
+            || !EWOMS_GET_PARAM(TypeTag, std::string, OutputRegionElementsFile).empty();
+    }
+
+    // apply the precision and the field selection to an output writer
+    void configureOutputWriter_(BaseOutputWriter& writer) const
+    {
+        writer.setSinglePrecision(EWOMS_GET_PARAM(TypeTag, bool, EnableSinglePrecisionOutput));
+        writer.setFieldFilter(EWOMS_GET_PARAM(TypeTag, std::string, OutputFields));
+    }
+
+    // restrict the HDF5 output to the specified box and/or set of elements
+    void configureOutputRegion_(Hdf5MultiWriter& writer) const
+    {
+        const std::string lowerString = EWOMS_GET_PARAM(TypeTag, std::string, OutputRegionLower);
+        const std::string upperString = EWOMS_GET_PARAM(TypeTag, std::string, OutputRegionUpper);
+        if (!lowerString.empty() && !upperString.empty())
+            writer.setOutputRegion(parsePosition_(lowerString), parsePosition_(upperString));
+        else if (!lowerString.empty() || !upperString.empty())
+            throw std::runtime_error("Both corners of the output region need to be specified");
+
+        const std::string elemFileName =
+            EWOMS_GET_PARAM(TypeTag, std::string, OutputRegionElementsFile);
+        if (!elemFileName.empty()) {
+            std::ifstream elemFile(elemFileName);
+            if (!elemFile)
+                throw std::runtime_error("Could not open file '"+elemFileName+"'");
+
+            std::vector<unsigned> elemIndices;
+            unsigned elemIdx;
+            while (elemFile >> elemIdx)
+                elemIndices.push_back(elemIdx);
+            writer.setOutputElements(std::move(elemIndices));
+        }
+    }
+
+    static GlobalPosition parsePosition_(const std::string& posString)
+    {
+        GlobalPosition pos(0.0);
+        std::istringstream iss(posString);
+        std::string coord;
+        unsigned k = 0;
+        for (; std::getline(iss, coord, ','); ++k) {
+            if (k >= dimWorld)
+                throw std::runtime_error("Too many coordinates in '"+posString+"'");
+            pos[k] = std::stod(coord);
+        }
+        if (k != dimWorld)
+            throw std::runtime_error("Too few coordinates in '"+posString+"'");
+        return pos;
+    }
+
     //! Returns the implementation of the problem (i.e. static polymorphism)
     Implementation& asImp_()
     { return *static_cast<Implementation *>(this); }
@@ -831,6 +992,8 @@ private:
     // Attributes required for the actual simulation
     Simulator& simulator_;
     mutable VtkMultiWriter *defaultVtkWriter_;
+    mutable Hdf5MultiWriter *defaultHdf5Writer_;
+    std::unique_ptr<ProbeOutputModule> probeModule_;
 };
 
 } // namespace Opm
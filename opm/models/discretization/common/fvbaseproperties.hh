@@ -249,6 +249,69 @@ struct EnableAsyncVtkOutput { using type = UndefinedProperty; };
 template<class TypeTag, class MyTypeTag>
 struct VtkOutputFormat { using type = UndefinedProperty; };
 
+/*!
+ * \brief Write the visualization output to a single HDF5 file instead of VTK files
+ *
+ * The HDF5 file contains the grid and the fields of all time steps and is accompanied
+ * by an XDMF descriptor which can be read by ParaView. This has only an effect if
+ * EnableVtkOutput is true and it requires opm-models to be configured with HDF5.
+ */
+template<class TypeTag, class MyTypeTag>
+struct EnableHdf5Output { using type = UndefinedProperty; };
+
+/*!
+ * \brief Convert the output fields to 32 bit floating point values when they are written
+ *
+ * The coordinates of the grid are always written using double precision.
+ */
+template<class TypeTag, class MyTypeTag>
+struct EnableSinglePrecisionOutput { using type = UndefinedProperty; };
+
+/*!
+ * \brief A comma separated list of the fields which are written to disk
+ *
+ * Names which end with '*' select all fields starting with the given prefix. If the list
+ * is empty, all fields which are enabled by the output modules are written.
+ */
+template<class TypeTag, class MyTypeTag>
+struct OutputFields { using type = UndefinedProperty; };
+
+/*!
+ * \brief The lower left corner of the box of elements for which output is written
+ *
+ * The coordinates are separated by commas. If this or OutputRegionUpper is empty, the
+ * output is not restricted to a box. Restricting the output to a region is only
+ * supported by the HDF5 output.
+ */
+template<class TypeTag, class MyTypeTag>
+struct OutputRegionLower { using type = UndefinedProperty; };
+
+//! The upper right corner of the box of elements for which output is written
+template<class TypeTag, class MyTypeTag>
+struct OutputRegionUpper { using type = UndefinedProperty; };
+
+/*!
+ * \brief The name of a file which contains the indices of the elements for which
+ *        output is written
+ *
+ * The indices are independent of the partition of the grid. For structured grids, they
+ * are the cartesian indices of the elements, i.e., the ones of a sequential run. Like
+ * the box, this is only supported by the HDF5 output.
+ */
+template<class TypeTag, class MyTypeTag>
+struct OutputRegionElementsFile { using type = UndefinedProperty; };
+
+/*!
+ * \brief The number of time steps for which the time spent to linearize each element is
+ *        measured
+ *
+ * After these time steps or at the end of a shorter simulation, the accumulated cost is
+ * written to a text file in the output directory. This file can be used to balance the load of later runs via the
+ * LoadBalanceCostFile parameter. 0 disables the measurement.
+ */
+template<class TypeTag, class MyTypeTag>
+struct LoadBalanceCostSteps { using type = UndefinedProperty; };
+
 //! Specify whether the some degrees of fredom can be constraint
 template<class TypeTag, class MyTypeTag>
 struct EnableConstraints { using type = UndefinedProperty; };
@@ -284,6 +347,36 @@ struct MaxTimeStepDivisions { using type = UndefinedProperty; };
 template<class TypeTag, class MyTypeTag>
 struct ContinueOnConvergenceError { using type = UndefinedProperty; };
 
+/*!
+ * \brief The strategy which determines the size of the next time step
+ *
+ * "newton" uses the size suggested by the Newton method, "iterationcount" scales the
+ * size by the ratio of the targeted and the actual number of Newton iterations and
+ * "pid" uses a PID controller based on the relative change of the solution. The
+ * limits on the growth of the time step size only apply to the latter two.
+ */
+template<class TypeTag, class MyTypeTag>
+struct TimeStepControl { using type = UndefinedProperty; };
+
+//! The relative change of the solution per time step which is targeted by the PID
+//! time step controller
+template<class TypeTag, class MyTypeTag>
+struct TimeStepControlTolerance { using type = UndefinedProperty; };
+
+//! The largest factor by which the time step size may grow from one step to the next
+template<class TypeTag, class MyTypeTag>
+struct TimeStepControlGrowthRate { using type = UndefinedProperty; };
+
+//! The largest factor by which the time step size may grow after a time step which
+//! required the step size to be reduced
+template<class TypeTag, class MyTypeTag>
+struct TimeStepControlGrowthRateAfterFailure { using type = UndefinedProperty; };
+
+//! The factor by which the time step size is reduced if the time integration failed.
+//! This is also the smallest factor applied after a successful time step.
+template<class TypeTag, class MyTypeTag>
+struct TimeStepControlDecayRate { using type = UndefinedProperty; };
+
 /*!
  * \brief Specify whether all intensive quantities for the grid should be
  *        cached in the discretization.
@@ -305,6 +398,16 @@ struct EnableIntensiveQuantityCache { using type = UndefinedProperty; };
 template<class TypeTag, class MyTypeTag>
 struct EnableStorageCache { using type = UndefinedProperty; };
 
+/*!
+ * \brief Specify whether the cached intensive quantities at the beginning of a time step
+ *        should be kept.
+ *
+ * If the time integration fails, they are restored instead of recalculating them. This
+ * requires the intensive quantity cache and doubles its memory consumption.
+ */
+template<class TypeTag, class MyTypeTag>
+struct EnableIntensiveQuantitySnapshot { using type = UndefinedProperty; };
+
 /*!
  * \brief Specify whether to use the already calculated solutions as
  *        starting values of the intensive quantities.
@@ -0,0 +1,303 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \copydoc Opm::FvBaseSubdomains
+ */
+#ifndef EWOMS_FV_BASE_SUBDOMAINS_HH
+#define EWOMS_FV_BASE_SUBDOMAINS_HH
+
+#include "fvbaseproperties.hh"
+
+#include <opm/models/parallel/weightedbisectionpartitioner.hh>
+#include <opm/simulators/linalg/matrixblock.hh>
+
+#include <dune/common/fvector.hh>
+#include <dune/grid/common/gridenums.hh>
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+#include <dune/istl/operators.hh>
+#include <dune/istl/preconditioners.hh>
+#include <dune/istl/solvers.hh>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace Opm {
+
+/*!
+ * \brief A view on a subset of the elements of a grid view.
+ *
+ * This provides the parts of the grid view interface which are required to iterate
+ * over the elements, so it can be used as the view of a subdomain of the linearizer.
+ */
+template <class GridView>
+class ElementSubsetView
+{
+    using Element = typename GridView::template Codim<0>::Entity;
+
+public:
+    template <int codim>
+    struct Codim
+    {
+        static_assert(codim == 0, "The view only provides elements");
+
+        using Entity = Element;
+        using Iterator = typename std::vector<Element>::const_iterator;
+    };
+
+    explicit ElementSubsetView(std::vector<Element> elements)
+        : elements_(std::move(elements))
+    {}
+
+    template <int codim>
+    typename Codim<codim>::Iterator begin() const
+    { return elements_.begin(); }
+
+    template <int codim>
+    typename Codim<codim>::Iterator end() const
+    { return elements_.end(); }
+
+    int size(int codim) const
+    { return (codim == 0) ? static_cast<int>(elements_.size()) : 0; }
+
+private:
+    std::vector<Element> elements_;
+};
+
+/*!
+ * \ingroup FiniteVolumeDiscretizations
+ *
+ * \brief Partitions the interior of the local process into subdomains and solves the
+ *        linear systems of equations which are restricted to a subdomain.
+ *
+ * The subdomains are determined by recursive coordinate bisection of the element
+ * centers. The linear system of a subdomain consists of the rows and columns of the
+ * global Jacobian which belong to the degrees of freedom of the subdomain, i.e., the
+ * degrees of freedom outside of the subdomain are kept fixed. The subdomain systems
+ * are solved by BiCGStab preconditioned with ILU(0) without any communication.
+ *
+ * Since the subdomains are sets of elements, this is only possible if the degrees of
+ * freedom are the elements, i.e., for the element centered finite volume
+ * discretization.
+ */
+template <class TypeTag>
+class FvBaseSubdomains
+{
+    using Scalar = GetPropType<TypeTag, Properties::Scalar>;
+    using Simulator = GetPropType<TypeTag, Properties::Simulator>;
+    using GridView = GetPropType<TypeTag, Properties::GridView>;
+    using ElementContext = GetPropType<TypeTag, Properties::ElementContext>;
+    using GlobalEqVector = GetPropType<TypeTag, Properties::GlobalEqVector>;
+
+    using Element = typename GridView::template Codim<0>::Entity;
+
+    enum { numEq = getPropValue<TypeTag, Properties::NumEq>() };
+    enum { dimWorld = GridView::dimensionworld };
+
+    using Block = MatrixBlock<Scalar, numEq, numEq>;
+    using VectorBlock = Dune::FieldVector<Scalar, numEq>;
+    using Matrix = Dune::BCRSMatrix<Block>;
+    using Vector = Dune::BlockVector<VectorBlock>;
+
+public:
+    //! A subdomain and its linear system of equations
+    struct Subdomain
+    {
+        explicit Subdomain(std::vector<Element> elements)
+            : view(std::move(elements))
+        {}
+
+        ElementSubsetView<GridView> view;
+
+        //! the global indices of the degrees of freedom of the subdomain
+        std::vector<unsigned> dofs;
+
+        Matrix matrix;
+        Vector residual;
+        Vector update;
+    };
+
+    explicit FvBaseSubdomains(const Simulator& simulator)
+        : simulator_(simulator)
+    {}
+
+    /*!
+     * \brief Discard the subdomains, e.g., because the grid has changed.
+     */
+    void reset()
+    {
+        subdomains_.clear();
+        isCreated_ = false;
+    }
+
+    /*!
+     * \brief Partition the interior of the local process if this has not been done yet.
+     *
+     * \return false if the degrees of freedom of the discretization are not the
+     *         elements, i.e., if the model cannot be split into subdomains.
+     */
+    bool create(int numSubdomains)
+    {
+        if (isCreated_)
+            return isElementCentered_;
+        isCreated_ = true;
+
+        const auto& elementMapper = simulator_.model().elementMapper();
+        ElementContext elemCtx(simulator_);
+
+        std::vector<Element> interiorElements;
+        std::vector<Dune::FieldVector<Scalar, dimWorld>> centers;
+        for (const auto& elem : elements(simulator_.gridView(), Dune::Partitions::interior)) {
+            elemCtx.updatePrimaryStencil(elem);
+            if (elemCtx.numPrimaryDof(/*timeIdx=*/0) != 1
+                || elemCtx.globalSpaceIndex(/*dofIdx=*/0, /*timeIdx=*/0) != elementMapper.index(elem))
+            {
+                isElementCentered_ = false;
+                return false;
+            }
+
+            interiorElements.push_back(elem);
+            centers.push_back(elem.geometry().center());
+        }
+        isElementCentered_ = true;
+
+        if (interiorElements.empty())
+            return true;
+
+        numSubdomains = std::max(1, std::min(numSubdomains, static_cast<int>(interiorElements.size())));
+        WeightedBisectionPartitioner<Scalar, dimWorld>
+            partitioner(centers, std::vector<Scalar>(centers.size(), 1.0), numSubdomains);
+
+        std::vector<std::vector<Element>> subdomainElements(static_cast<std::size_t>(numSubdomains));
+        for (std::size_t elemIdx = 0; elemIdx < interiorElements.size(); ++elemIdx) {
+            const auto partIdx = static_cast<std::size_t>(partitioner.part(centers[elemIdx]));
+            subdomainElements[partIdx].push_back(interiorElements[elemIdx]);
+        }
+
+        for (auto& elems : subdomainElements) {
+            if (elems.empty())
+                continue;
+
+            std::vector<unsigned> dofs;
+            for (const auto& elem : elems)
+                dofs.push_back(static_cast<unsigned>(elementMapper.index(elem)));
+
+            subdomains_.emplace_back(std::move(elems));
+            subdomains_.back().dofs = std::move(dofs);
+        }
+
+        return true;
+    }
+
+    /*!
+     * \brief Returns the subdomains of the local process.
+     */
+    std::vector<Subdomain>& subdomains()
+    { return subdomains_; }
+
+    /*!
+     * \brief Copy the rows and columns of a subdomain from the global linearization.
+     *
+     * The sparsity pattern of the subdomain matrix is created when this method is
+     * called for the first time.
+     */
+    template <class IstlMatrix>
+    void assemble(Subdomain& subdomain,
+                  const IstlMatrix& jacobian,
+                  const GlobalEqVector& residual)
+    {
+        const auto& dofs = subdomain.dofs;
+        const std::size_t numDof = dofs.size();
+
+        if (subdomain.matrix.N() != numDof) {
+            localIdx_.resize(jacobian.N(), -1);
+            for (std::size_t i = 0; i < numDof; ++i)
+                localIdx_[dofs[i]] = static_cast<int>(i);
+
+            std::size_t numNonZeros = 0;
+            for (unsigned globalIdx : dofs)
+                numNonZeros += jacobian[globalIdx].size();
+
+            subdomain.matrix.setBuildMode(Matrix::row_wise);
+            subdomain.matrix.setSize(numDof, numDof, numNonZeros);
+            for (auto row = subdomain.matrix.createbegin(); row != subdomain.matrix.createend(); ++row) {
+                const auto& globalRow = jacobian[dofs[row.index()]];
+                for (auto col = globalRow.begin(); col != globalRow.end(); ++col)
+                    if (localIdx_[col.index()] >= 0)
+                        row.insert(static_cast<std::size_t>(localIdx_[col.index()]));
+            }
+
+            for (unsigned globalIdx : dofs)
+                localIdx_[globalIdx] = -1;
+
+            subdomain.residual.resize(numDof);
+            subdomain.update.resize(numDof);
+        }
+
+        for (auto row = subdomain.matrix.begin(); row != subdomain.matrix.end(); ++row) {
+            const auto& globalRow = jacobian[dofs[row.index()]];
+            for (auto col = row->begin(); col != row->end(); ++col)
+                *col = globalRow[dofs[col.index()]];
+            subdomain.residual[row.index()] = residual[dofs[row.index()]];
+        }
+    }
+
+    /*!
+     * \brief Solve the linear system of a subdomain.
+     *
+     * The result is stored in the update vector of the subdomain.
+     */
+    static bool solve(Subdomain& subdomain, Scalar tolerance, int maxIterations)
+    {
+        using Operator = Dune::MatrixAdapter<Matrix, Vector, Vector>;
+        using Preconditioner = Dune::SeqILU<Matrix, Vector, Vector>;
+
+        Operator op(subdomain.matrix);
+        Preconditioner preCond(subdomain.matrix, /*relaxation=*/1.0);
+        Dune::BiCGSTABSolver<Vector> solver(op, preCond, tolerance, maxIterations, /*verbosity=*/0);
+
+        // the solver overwrites the right hand side
+        Vector rhs(subdomain.residual);
+        subdomain.update = 0.0;
+        Dune::InverseOperatorResult result;
+        solver.apply(subdomain.update, rhs, result);
+        return result.converged;
+    }
+
+private:
+    const Simulator& simulator_;
+
+    std::vector<Subdomain> subdomains_;
+    bool isCreated_{false};
+    bool isElementCentered_{false};
+
+    // maps global to subdomain indices while a sparsity pattern is created
+    std::vector<int> localIdx_;
+};
+
+} // namespace Opm
+
+#endif
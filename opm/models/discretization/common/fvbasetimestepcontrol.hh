@@ -0,0 +1,272 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \copydoc Opm::FvBaseTimeStepControl
+ */
+#ifndef EWOMS_FV_BASE_TIME_STEP_CONTROL_HH
+#define EWOMS_FV_BASE_TIME_STEP_CONTROL_HH
+
+#include "fvbaseproperties.hh"
+
+#include <opm/models/nonlinear/newtonmethodproperties.hh>
+#include <opm/models/utils/parametersystem.hh>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace Opm {
+
+/*!
+ * \ingroup FiniteVolumeDiscretizations
+ *
+ * \brief The PID controller of the time step size.
+ *
+ * It determines the factor by which the size of the time step is changed from the
+ * relative changes of the solution during the last three time steps, so that the
+ * change per time step stays close to a tolerance.
+ */
+template <class Scalar>
+class PidTimeStepController
+{
+public:
+    explicit PidTimeStepController(Scalar tolerance)
+        : tolerance_(tolerance)
+    {}
+
+    /*!
+     * \brief Record the relative change of the solution during the last time step.
+     */
+    void recordChange(Scalar change)
+    {
+        changes_[0] = changes_[1];
+        changes_[1] = changes_[2];
+        changes_[2] = change;
+        numChanges_ = std::min(numChanges_ + 1, 3);
+    }
+
+    /*!
+     * \brief Returns the factor by which the size of the next time step should differ
+     *        from the size of the last one.
+     *
+     * The gains are the ones proposed by Söderlind for the H0321 controller which are
+     * also used by the PID time step control of the OPM flow simulator.
+     */
+    Scalar factor() const
+    {
+        const Scalar minChange = std::numeric_limits<Scalar>::epsilon();
+        const Scalar change = std::max(changes_[2], minChange);
+
+        // during the first time steps or if the change was too large, the size is
+        // scaled proportionally to the deviation from the targeted change
+        if (numChanges_ < 3 || change > tolerance_)
+            return tolerance_/change;
+
+        const Scalar kP = 0.075;
+        const Scalar kI = 0.175;
+        const Scalar kD = 0.01;
+        const Scalar lastChange = std::max(changes_[1], minChange);
+        const Scalar secondLastChange = std::max(changes_[0], minChange);
+        return std::pow(lastChange/change, kP)
+            * std::pow(tolerance_/change, kI)
+            * std::pow(lastChange*lastChange/(change*secondLastChange), kD);
+    }
+
+private:
+    Scalar tolerance_;
+    std::array<Scalar, 3> changes_ = {0.0, 0.0, 0.0};
+    int numChanges_ = 0;
+};
+
+/*!
+ * \ingroup FiniteVolumeDiscretizations
+ *
+ * \brief Determines the size of the next time step of a simulation.
+ *
+ * The strategy is selected by the TimeStepControl parameter:
+ *
+ * - \c newton: The size suggested by NewtonMethod::suggestTimeStepSize() is used.
+ * - \c iterationcount: The size is scaled by the ratio between the targeted and the
+ *   actual number of Newton iterations of the last time step.
+ * - \c pid: A PID controller keeps the relative change of the solution per time step
+ *   close to the TimeStepControlTolerance parameter. The change is measured with the
+ *   relativeDofError() method of the model, i.e., it considers the weights of the
+ *   primary variables such as pressures and saturations. If the last time step required
+ *   more Newton iterations than targeted, the size is additionally limited like for
+ *   the iteration count strategy.
+ *
+ * Except for the first strategy, the factor by which the size changes from one step to
+ * the next is bounded, and the bound is tighter for a time step which follows a failed
+ * attempt of the time integration.
+ */
+template <class TypeTag>
+class FvBaseTimeStepControl
+{
+    using Scalar = GetPropType<TypeTag, Properties::Scalar>;
+    using Simulator = GetPropType<TypeTag, Properties::Simulator>;
+
+    enum class Strategy { Newton, IterationCount, Pid };
+
+public:
+    explicit FvBaseTimeStepControl(const Simulator& simulator)
+        : simulator_(simulator)
+        , pidController_(EWOMS_GET_PARAM(TypeTag, Scalar, TimeStepControlTolerance))
+    {
+        const std::string strategy = EWOMS_GET_PARAM(TypeTag, std::string, TimeStepControl);
+        if (strategy == "newton")
+            strategy_ = Strategy::Newton;
+        else if (strategy == "iterationcount")
+            strategy_ = Strategy::IterationCount;
+        else if (strategy == "pid")
+            strategy_ = Strategy::Pid;
+        else
+            throw std::invalid_argument("Unknown time step control '"+strategy+"'. Use "
+                                        "'newton', 'iterationcount' or 'pid'");
+
+        growthRate_ = EWOMS_GET_PARAM(TypeTag, Scalar, TimeStepControlGrowthRate);
+        growthRateAfterFailure_ = EWOMS_GET_PARAM(TypeTag, Scalar, TimeStepControlGrowthRateAfterFailure);
+        decayRate_ = EWOMS_GET_PARAM(TypeTag, Scalar, TimeStepControlDecayRate);
+        if (!(decayRate_ > 0.0 && decayRate_ < 1.0))
+            throw std::invalid_argument("The decay rate of the time step control must be "
+                                        "between 0 and 1");
+    }
+
+    /*!
+     * \brief Register all run-time parameters of the time step control.
+     */
+    static void registerParameters()
+    {
+        EWOMS_REGISTER_PARAM(TypeTag, std::string, TimeStepControl,
+                             "The strategy which determines the size of the next time "
+                             "step ('newton', 'iterationcount' or 'pid')");
+        EWOMS_REGISTER_PARAM(TypeTag, Scalar, TimeStepControlTolerance,
+                             "The relative change of the solution per time step which "
+                             "is targeted by the PID time step control");
+        EWOMS_REGISTER_PARAM(TypeTag, Scalar, TimeStepControlGrowthRate,
+                             "The largest factor by which the time step size may grow");
+        EWOMS_REGISTER_PARAM(TypeTag, Scalar, TimeStepControlGrowthRateAfterFailure,
+                             "The largest factor by which the time step size may grow "
+                             "after the time integration failed");
+        EWOMS_REGISTER_PARAM(TypeTag, Scalar, TimeStepControlDecayRate,
+                             "The factor by which the time step size is reduced if the "
+                             "time integration failed");
+    }
+
+    /*!
+     * \brief Returns the size which is used for the next attempt after the time
+     *        integration with a given size failed.
+     */
+    Scalar failedTimeStepSize(Scalar dt) const
+    { return dt*decayRate_; }
+
+    /*!
+     * \brief Record the statistics of a time step for which the time integration has
+     *        been completed.
+     *
+     * This needs to be called before the model advances the time level, i.e., while
+     * the solutions at the beginning and at the end of the time step are available.
+     *
+     * \param hadFailures true if the time step size needed to be reduced
+     */
+    void timeStepSucceeded(bool hadFailures)
+    {
+        lastStepFailed_ = hadFailures;
+        numIterations_ = simulator_.model().newtonMethod().numIterations();
+
+        if (strategy_ == Strategy::Pid)
+            pidController_.recordChange(relativeChange_());
+    }
+
+    /*!
+     * \brief Returns the size of the next time step given the size of the last one.
+     */
+    Scalar suggestTimeStepSize(Scalar dt) const
+    {
+        if (strategy_ == Strategy::Newton)
+            return simulator_.model().newtonMethod().suggestTimeStepSize(dt);
+
+        Scalar factor;
+        if (strategy_ == Strategy::IterationCount)
+            factor = iterationCountFactor_();
+        else {
+            factor = pidController_.factor();
+            if (numIterations_ > targetIterations_())
+                factor = std::min(factor, iterationCountFactor_());
+        }
+
+        const Scalar maxFactor = lastStepFailed_ ? growthRateAfterFailure_ : growthRate_;
+        factor = std::max(decayRate_, std::min(factor, maxFactor));
+
+        return std::max(simulator_.problem().minTimeStepSize(), dt*factor);
+    }
+
+private:
+    static int targetIterations_()
+    { return EWOMS_GET_PARAM(TypeTag, int, NewtonTargetIterations); }
+
+    Scalar iterationCountFactor_() const
+    { return Scalar(targetIterations_())/std::max(numIterations_, 1); }
+
+    // the largest relative change of the primary variables of a degree of freedom
+    // over the time step
+    Scalar relativeChange_() const
+    {
+        const auto& model = simulator_.model();
+        const auto& newSolution = model.solution(/*timeIdx=*/0);
+        const auto& oldSolution = model.solution(/*timeIdx=*/1);
+
+        Scalar result = 0.0;
+        const unsigned numGridDof = model.numGridDof();
+        for (unsigned dofIdx = 0; dofIdx < numGridDof; ++dofIdx) {
+            if (!model.isLocalDof(dofIdx))
+                continue;
+
+            result = std::max(result, model.relativeDofError(dofIdx,
+                                                             oldSolution[dofIdx],
+                                                             newSolution[dofIdx]));
+        }
+
+        return simulator_.gridView().comm().max(result);
+    }
+
+    const Simulator& simulator_;
+
+    Strategy strategy_;
+    PidTimeStepController<Scalar> pidController_;
+    Scalar growthRate_;
+    Scalar growthRateAfterFailure_;
+    Scalar decayRate_;
+
+    // the statistics of the last time steps
+    bool lastStepFailed_ = false;
+    int numIterations_ = 0;
+};
+
+} // namespace Opm
+
+#endif
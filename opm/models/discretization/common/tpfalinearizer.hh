@@ -787,9 +787,12 @@ private:
                 model_().updateCachedStorage(globI, /*timeIdx=*/0, res);
                 if (model_().newtonMethod().numIterations() == 0) {
                     // Need to update the storage cache.
-                    if (problem_().recycleFirstIterationStorage()) {
+                    if (problem_().recycleFirstIterationStorage() &&
+                        !model_().newtonMethod().solutionPredicted()) {
                         // Assumes nothing have changed in the system which
-                        // affects masses calculated from primary variables.
+                        // affects masses calculated from primary variables,
+                        // i.e., that the initial solution has not been
+                        // extrapolated by the Newton method.
                         if (on_full_domain) {
                             // This is to avoid resetting the start-of-step storage
                             // to incorrect numbers when we do local solves, where the iteration
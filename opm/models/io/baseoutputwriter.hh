@@ -31,6 +31,8 @@
 #include <dune/common/dynvector.hh>
 #include <dune/common/dynmatrix.hh>
 
+#include <sstream>
+#include <string>
 #include <vector>
 
 namespace Opm {
@@ -51,6 +53,7 @@ public:
     using TensorBuffer = std::vector<Tensor>;
 
     BaseOutputWriter()
+        : singlePrecision_(true)
     {}
 
     virtual ~BaseOutputWriter()
@@ -100,6 +103,69 @@ public:
      * buffers are deleted, but no output is written.
      */
     virtual void endWrite(bool onlyDiscard = false) = 0;
+
+    /*!
+     * \brief Specify whether the fields are written using 32 bit floating point values.
+     *
+     * The buffers which are attached to the writer always contain double precision
+     * values. If single precision output is enabled, these are converted when the
+     * output file is encoded.
+     */
+    void setSinglePrecision(bool yesno)
+    { singlePrecision_ = yesno; }
+
+    /*!
+     * \brief Returns true if the fields are written using 32 bit floating point values.
+     */
+    bool singlePrecision() const
+    { return singlePrecision_; }
+
+    /*!
+     * \brief Restrict the output to a subset of the fields.
+     *
+     * The argument is a comma separated list of field names. A name which ends with
+     * '*' selects all fields that start with the given prefix, e.g. "saturation_*". If
+     * the list is empty, all fields are written.
+     */
+    void setFieldFilter(const std::string& fieldList)
+    {
+        selectedFields_.clear();
+
+        std::istringstream iss(fieldList);
+        std::string fieldName;
+        while (std::getline(iss, fieldName, ',')) {
+            // remove leading and trailing white space
+            const auto first = fieldName.find_first_not_of(" \t");
+            if (first == std::string::npos)
+                continue;
+            const auto last = fieldName.find_last_not_of(" \t");
+            selectedFields_.push_back(fieldName.substr(first, last - first + 1));
+        }
+    }
+
+    /*!
+     * \brief Returns true if a field of a given name ought to be written.
+     */
+    bool fieldSelected(const std::string& name) const
+    {
+        if (selectedFields_.empty())
+            return true;
+
+        for (const auto& pattern : selectedFields_) {
+            if (pattern.back() == '*') {
+                if (name.compare(0, pattern.size() - 1, pattern, 0, pattern.size() - 1) == 0)
+                    return true;
+            }
+            else if (name == pattern)
+                return true;
+        }
+
+        return false;
+    }
+
+private:
+    bool singlePrecision_;
+    std::vector<std::string> selectedFields_;
 };
 } // namespace Opm
 
@@ -27,6 +27,7 @@
 #ifndef EWOMS_BASE_VANGUARD_HH
 #define EWOMS_BASE_VANGUARD_HH
 
+#include <opm/models/parallel/weightedbisectionpartitioner.hh>
 #include <opm/models/utils/basicproperties.hh>
 #include <opm/models/utils/parametersystem.hh>
 
@@ -36,11 +37,62 @@
 #include <dune/fem/space/common/dofmanager.hh>
 #endif
 
+#if HAVE_DUNE_ALUGRID
+#include <dune/alugrid/grid.hh>
+#endif
+
+#include <iostream>
+#include <set>
+#include <string>
 #include <type_traits>
 #include <memory>
 
 namespace Opm {
 
+namespace detail {
+template <class Grid>
+struct IsAluGrid : public std::false_type {};
+
+#if HAVE_DUNE_ALUGRID
+template <int dim, int dimWorld, Dune::ALUGridElementType elType,
+          Dune::ALUGridRefinementType refineType, class Comm>
+struct IsAluGrid<Dune::ALUGrid<dim, dimWorld, elType, refineType, Comm>>
+    : public std::true_type {};
+#endif
+
+/*!
+ * \brief Assigns the macro elements of a grid to the process given by a cost-weighted
+ *        partition of the domain.
+ *
+ * This implements the interface expected by ALUGrid's repartition() method.
+ */
+template <class Partitioner>
+class PartitionerDestinations
+{
+public:
+    explicit PartitionerDestinations(const Partitioner& partitioner)
+        : partitioner_(partitioner)
+    {}
+
+    bool repartition() const
+    { return true; }
+
+    template <class Element>
+    int operator()(const Element& elem) const
+    { return partitioner_.part(elem.geometry().center()); }
+
+    template <class Element>
+    int destination(const Element& elem) const
+    { return (*this)(elem); }
+
+    bool importRanks(std::set<int>& /*ranks*/) const
+    { return false; }
+
+private:
+    const Partitioner& partitioner_;
+};
+} // namespace detail
+
 /*!
  * \brief Provides the base class for most (all?) simulator vanguards.
  */
@@ -103,10 +155,16 @@ public:
     /*!
      * \brief Distribute the grid (and attached data) over all
      *        processes.
+     *
+     * If the LoadBalanceCostFile parameter is specified and the grid supports it, the
+     * grid is partitioned such that each process gets the same share of the
+     * linearization cost recorded by a previous run.
      */
     void loadBalance()
     {
-        asImp_().grid().loadBalance();
+        const std::string costFileName = EWOMS_GET_PARAM(TypeTag, std::string, LoadBalanceCostFile);
+        if (costFileName.empty() || !weightedLoadBalance_(costFileName))
+            asImp_().grid().loadBalance();
         updateGridView_();
     }
 
@@ -117,6 +175,27 @@ protected:
         updateGridView_();
     }
 
+    // distribute the grid according to the cost of the elements stored in a file.
+    // returns false if the grid does not support user-defined partitions.
+    bool weightedLoadBalance_(const std::string& costFileName)
+    {
+        auto& grid = asImp_().grid();
+        if constexpr (detail::IsAluGrid<Grid>::value) {
+            using Partitioner = WeightedBisectionPartitioner<double, Grid::dimensionworld>;
+            const Partitioner partitioner = Partitioner::fromFile(costFileName, grid.comm().size());
+            detail::PartitionerDestinations<Partitioner> destinations(partitioner);
+            grid.repartition(destinations);
+            return true;
+        }
+        else {
+            if (grid.comm().rank() == 0)
+                std::cout << "Warning: The grid does not support cost-weighted load "
+                          << "balancing. Ignoring the cost file '" << costFileName << "'.\n"
+                          << std::flush;
+            return false;
+        }
+    }
+
     void updateGridView_()
     {
 #if HAVE_DUNE_FEM
@@ -28,22 +28,30 @@
 #define EWOMS_DGF_GRID_VANGUARD_HH
 
 #include <dune/grid/io/file/dgfparser/dgfparser.hh>
+#include <dune/grid/common/capabilities.hh>
 #include <dune/grid/common/mcmgmapper.hh>
 #include <opm/models/discretefracture/fracturemapper.hh>
 
 #include <opm/models/io/basevanguard.hh>
+#include <opm/models/io/gridcache.hh>
 #include <opm/models/utils/propertysystem.hh>
 #include <opm/models/utils/parametersystem.hh>
 
 
+#include <iostream>
 #include <type_traits>
 #include <string>
+#include <vector>
 
 namespace Opm {
 
 /*!
  * \brief Provides a simulator vanguard which creates a grid by parsing a Dune Grid
  *        Format (DGF) file.
+ *
+ * For unstructured grids, the parsed grid can optionally be stored in a binary cache
+ * file next to the DGF file, from which it is loaded on subsequent runs as long as the
+ * DGF file is unchanged. (See Opm::GridCache.)
  */
 template <class TypeTag>
 class DgfVanguard : public BaseVanguard<TypeTag>
@@ -53,6 +61,7 @@ class DgfVanguard : public BaseVanguard<TypeTag>
     using Simulator = GetPropType<TypeTag, Properties::Simulator>;
     using Grid = GetPropType<TypeTag, Properties::Grid>;
     using FractureMapper = Opm::FractureMapper<TypeTag>;
+    using GridCache = Opm::GridCache<Grid>;
 
     using GridPointer = std::unique_ptr< Grid >;
 
@@ -67,6 +76,9 @@ public:
         EWOMS_REGISTER_PARAM(TypeTag, unsigned, GridGlobalRefinements,
                              "The number of global refinements of the grid "
                              "executed after it was loaded");
+        EWOMS_REGISTER_PARAM(TypeTag, bool, EnableGridCache,
+                             "Store the grid in a binary file next to the DGF file and "
+                             "load it from there if the DGF file did not change");
     }
 
     /*!
@@ -78,16 +90,16 @@ public:
         const std::string dgfFileName = EWOMS_GET_PARAM(TypeTag, std::string, GridFile);
         unsigned numRefinments = EWOMS_GET_PARAM(TypeTag, unsigned, GridGlobalRefinements);
 
-        {
-            // create DGF GridPtr from a dgf file
-            Dune::GridPtr< Grid > dgfPointer( dgfFileName );
-
-            // this is only implemented for 2d currently
-            addFractures_( dgfPointer );
-
-            // store pointer to dune grid
-            gridPtr_.reset( dgfPointer.release() );
+        // the grid cache relies on Dune::GridFactory which is not available for
+        // structured grids. these are cheap to create from DGF anyway.
+        if constexpr (!Dune::Capabilities::isCartesian<Grid>::v) {
+            if (EWOMS_GET_PARAM(TypeTag, bool, EnableGridCache))
+                createCachedGrid_(dgfFileName);
+            else
+                createDgfGrid_(dgfFileName);
         }
+        else
+            createDgfGrid_(dgfFileName);
 
         if (numRefinments > 0)
             gridPtr_->globalRefine(static_cast<int>(numRefinments));
@@ -107,16 +119,6 @@ public:
     const Grid& grid() const
     { return *gridPtr_; }
 
-    /*!
-     * \brief Distributes the grid on all processes of a parallel
-     *        computation.
-     *
-     * This grid manager plays nice and also distributes the data of
-     * the DGF...
-     */
-    void loadBalance()
-    { gridPtr_->loadBalance(); }
-
     /*!
      * \brief Returns the fracture mapper
      *
@@ -134,6 +136,49 @@ public:
     { return fractureMapper_; }
 
 protected:
+    void createDgfGrid_(const std::string& dgfFileName)
+    {
+        // create DGF GridPtr from a dgf file
+        Dune::GridPtr< Grid > dgfPointer( dgfFileName );
+
+        // this is only implemented for 2d currently
+        addFractures_( dgfPointer );
+
+        // store pointer to dune grid
+        gridPtr_.reset( dgfPointer.release() );
+    }
+
+    void createCachedGrid_(const std::string& dgfFileName)
+    {
+        GridCache cache(dgfFileName + ".cache", GridCache::hashFile(dgfFileName));
+        if (cache.read()) {
+            gridPtr_ = cache.createGrid();
+
+            // like for grids read from DGF files, the fractures are only known to the
+            // process which created the grid
+            if (cache.hasVertexIndices()) {
+                for (const auto& edge : cache.fractureEdges())
+                    fractureMapper_.addFractureEdge(cache.vertexIndex(edge[0]),
+                                                    cache.vertexIndex(edge[1]));
+            }
+            return;
+        }
+
+        createDgfGrid_(dgfFileName);
+
+        // in parallel runs, the DGF parser may have distributed the grid already, so
+        // the cache can only be written by sequential runs
+        if (gridPtr_->comm().size() == 1) {
+            cache.extract(*gridPtr_);
+            for (const auto& edge : fractureEdges_)
+                cache.addFractureEdge(edge[0], edge[1]);
+            if (!cache.write())
+                std::cout << "Warning: Could not write the grid cache file '"
+                          << dgfFileName << ".cache'. Continuing without it.\n"
+                          << std::flush;
+        }
+    }
+
     void addFractures_(Dune::GridPtr<Grid>& dgfPointer)
     {
         using LevelGridView = typename Grid::LevelGridView;
@@ -176,8 +221,10 @@ protected:
                                                                         Grid::dimension)));
                 }
                 // if 2 vertices have been found with flag 1 insert a fracture edge
-                if (static_cast<int>(vertexIndices.size()) == Grid::dimension)
+                if (static_cast<int>(vertexIndices.size()) == Grid::dimension) {
                     fractureMapper_.addFractureEdge(vertexIndices[0], vertexIndices[1]);
+                    fractureEdges_.push_back({vertexIndices[0], vertexIndices[1]});
+                }
             }
         }
     }
@@ -185,6 +232,7 @@ protected:
 private:
     GridPointer    gridPtr_;
     FractureMapper fractureMapper_;
+    std::vector<typename GridCache::FractureEdge> fractureEdges_;
 };
 
 } // namespace Opm
@@ -0,0 +1,324 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \copydoc Opm::GridCache
+ */
+#ifndef EWOMS_GRID_CACHE_HH
+#define EWOMS_GRID_CACHE_HH
+
+#include <dune/common/fvector.hh>
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/geometry/type.hh>
+#include <dune/grid/common/gridfactory.hh>
+#include <dune/grid/common/mcmgmapper.hh>
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+namespace Opm {
+
+/*!
+ * \brief Stores the macro grid of an unstructured grid in a binary file.
+ *
+ * The cache contains the vertex coordinates, the element connectivity and the edges of
+ * the fractures of the coarsest level of a grid. It is tagged by a key which is
+ * supposed to change whenever the input the grid was created from changes, so reading
+ * a cache which does not fit the key simply fails and the grid needs to be created from
+ * the original input again.
+ *
+ * The grid is recreated from the cache using Dune::GridFactory, so this only works for
+ * grid managers which provide a factory. The vertices are inserted in the order of the
+ * vertex mapper of the grid from which the cache was extracted, which means that the
+ * vertex indices of the fracture edges refer to this numbering.
+ */
+template <class Grid>
+class GridCache
+{
+    enum { dim = Grid::dimension };
+    enum { dimWorld = Grid::dimensionworld };
+
+    using LevelGridView = typename Grid::LevelGridView;
+    using VertexMapper = Dune::MultipleCodimMultipleGeomTypeMapper<LevelGridView>;
+
+    static constexpr char magic_[] = "OPMGRIDCACHE";
+    static constexpr std::uint32_t formatVersion_ = 1;
+
+public:
+    using FractureEdge = std::array<unsigned, 2>;
+
+    GridCache(const std::string& fileName, std::uint64_t key)
+        : fileName_(fileName)
+        , key_(key)
+    {}
+
+    /*!
+     * \brief Compute a key from the contents of an input file and the grid type.
+     *
+     * This uses the 64 bit FNV-1a hash function.
+     */
+    static std::uint64_t hashFile(const std::string& inputFileName)
+    {
+        std::ifstream inputFile(inputFileName, std::ios::binary);
+        if (!inputFile)
+            throw std::runtime_error("Could not open grid file '"+inputFileName+"'");
+
+        std::uint64_t hash = 14695981039346656037ULL;
+        const auto addBytes = [&hash](const char* data, std::size_t size) {
+            for (std::size_t i = 0; i < size; ++i) {
+                hash ^= static_cast<unsigned char>(data[i]);
+                hash *= 1099511628211ULL;
+            }
+        };
+
+        std::vector<char> buffer(1 << 16);
+        while (inputFile) {
+            inputFile.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            addBytes(buffer.data(), static_cast<std::size_t>(inputFile.gcount()));
+        }
+
+        const char* gridTypeName = typeid(Grid).name();
+        addBytes(gridTypeName, std::strlen(gridTypeName));
+
+        return hash;
+    }
+
+    /*!
+     * \brief Read the cache file.
+     *
+     * Returns false if the file does not exist or if it was created for a different key.
+     */
+    bool read()
+    {
+        std::ifstream cacheFile(fileName_, std::ios::binary);
+        if (!cacheFile)
+            return false;
+
+        char fileMagic[sizeof(magic_)];
+        cacheFile.read(fileMagic, sizeof(fileMagic));
+        if (!cacheFile || std::memcmp(fileMagic, magic_, sizeof(magic_)) != 0)
+            return false;
+
+        std::uint32_t version = readValue_<std::uint32_t>(cacheFile);
+        std::uint64_t key = readValue_<std::uint64_t>(cacheFile);
+        std::uint32_t fileDimWorld = readValue_<std::uint32_t>(cacheFile);
+        if (!cacheFile || version != formatVersion_ || key != key_ || fileDimWorld != dimWorld)
+            return false;
+
+        readVector_(cacheFile, coordinates_);
+        readVector_(cacheFile, elementTypes_);
+        readVector_(cacheFile, elementOffsets_);
+        readVector_(cacheFile, connectivity_);
+        readVector_(cacheFile, fractureEdges_);
+
+        return static_cast<bool>(cacheFile);
+    }
+
+    /*!
+     * \brief Write the cache file.
+     *
+     * Returns false if the file could not be written, e.g., because its directory is
+     * not writable. Since the cache is only an optimization, this is not an error.
+     */
+    bool write() const
+    {
+        std::ofstream cacheFile(fileName_, std::ios::binary);
+        if (!cacheFile)
+            return false;
+
+        cacheFile.write(magic_, sizeof(magic_));
+        writeValue_(cacheFile, formatVersion_);
+        writeValue_(cacheFile, key_);
+        writeValue_(cacheFile, static_cast<std::uint32_t>(dimWorld));
+
+        writeVector_(cacheFile, coordinates_);
+        writeVector_(cacheFile, elementTypes_);
+        writeVector_(cacheFile, elementOffsets_);
+        writeVector_(cacheFile, connectivity_);
+        writeVector_(cacheFile, fractureEdges_);
+
+        return static_cast<bool>(cacheFile);
+    }
+
+    /*!
+     * \brief Extract the coarsest level of a grid.
+     *
+     * The grid must be completely present on the local process.
+     */
+    void extract(const Grid& grid)
+    {
+        const LevelGridView gridView = grid.levelGridView(/*level=*/0);
+        VertexMapper vertexMapper(gridView, Dune::mcmgVertexLayout());
+
+        coordinates_.resize(static_cast<std::size_t>(gridView.size(dim))*dimWorld);
+        for (const auto& vertex : vertices(gridView)) {
+            std::size_t vIdx = static_cast<std::size_t>(vertexMapper.index(vertex));
+            const auto& pos = vertex.geometry().corner(0);
+            for (unsigned k = 0; k < dimWorld; ++k)
+                coordinates_[vIdx*dimWorld + k] = pos[k];
+        }
+
+        elementTypes_.clear();
+        elementOffsets_.assign(1, 0);
+        connectivity_.clear();
+        for (const auto& elem : elements(gridView)) {
+            elementTypes_.push_back(elem.type().id());
+            unsigned numCorners = static_cast<unsigned>(elem.subEntities(dim));
+            for (unsigned i = 0; i < numCorners; ++i)
+                connectivity_.push_back(static_cast<std::uint32_t>(vertexMapper.subIndex(elem, i, dim)));
+            elementOffsets_.push_back(static_cast<std::uint64_t>(connectivity_.size()));
+        }
+    }
+
+    /*!
+     * \brief Create a new grid from the cached data.
+     *
+     * Only the first process inserts the entities into the grid factory; the grid
+     * needs to be load balanced afterwards in parallel runs.
+     */
+    std::unique_ptr<Grid> createGrid()
+    {
+        Dune::GridFactory<Grid> factory;
+
+        if (Dune::MPIHelper::getCommunication().rank() == 0) {
+            std::size_t numVertices = coordinates_.size()/dimWorld;
+            for (std::size_t vIdx = 0; vIdx < numVertices; ++vIdx) {
+                Dune::FieldVector<typename Grid::ctype, dimWorld> pos;
+                for (unsigned k = 0; k < dimWorld; ++k)
+                    pos[k] = coordinates_[vIdx*dimWorld + k];
+                factory.insertVertex(pos);
+            }
+
+            std::vector<unsigned> corners;
+            for (std::size_t elemIdx = 0; elemIdx < elementTypes_.size(); ++elemIdx) {
+                corners.assign(connectivity_.begin() + static_cast<std::ptrdiff_t>(elementOffsets_[elemIdx]),
+                               connectivity_.begin() + static_cast<std::ptrdiff_t>(elementOffsets_[elemIdx + 1]));
+                factory.insertElement(Dune::GeometryType(elementTypes_[elemIdx], dim), corners);
+            }
+        }
+
+        std::unique_ptr<Grid> grid = factory.createGrid();
+
+        // map the insertion indices of the vertices to the indices used by the grid. this
+        // is only possible on the process which inserted the vertices.
+        vertexIndex_.clear();
+        if (Dune::MPIHelper::getCommunication().rank() == 0) {
+            const LevelGridView gridView = grid->levelGridView(/*level=*/0);
+            VertexMapper vertexMapper(gridView, Dune::mcmgVertexLayout());
+            vertexIndex_.resize(coordinates_.size()/dimWorld);
+            for (const auto& vertex : vertices(gridView))
+                vertexIndex_[factory.insertionIndex(vertex)] =
+                    static_cast<unsigned>(vertexMapper.index(vertex));
+        }
+
+        return grid;
+    }
+
+    /*!
+     * \brief Returns true if the vertices of the grid created by createGrid() were
+     *        inserted by the local process.
+     *
+     * Only in this case, vertexIndex() can be used.
+     */
+    bool hasVertexIndices() const
+    { return !vertexIndex_.empty(); }
+
+    /*!
+     * \brief Returns the index of a vertex of the grid created by createGrid() given
+     *        the index it had in the grid from which the cache was extracted.
+     */
+    unsigned vertexIndex(unsigned cachedVertexIdx) const
+    {
+        assert(hasVertexIndices());
+        return vertexIndex_[cachedVertexIdx];
+    }
+
+    /*!
+     * \brief Add an edge of a fracture to the cache.
+     */
+    void addFractureEdge(unsigned vertexIdx1, unsigned vertexIdx2)
+    { fractureEdges_.push_back(FractureEdge{vertexIdx1, vertexIdx2}); }
+
+    /*!
+     * \brief Returns the edges of the fractures in terms of the cached vertex indices.
+     */
+    const std::vector<FractureEdge>& fractureEdges() const
+    { return fractureEdges_; }
+
+private:
+    template <class T>
+    static T readValue_(std::istream& is)
+    {
+        T value{};
+        is.read(reinterpret_cast<char*>(&value), sizeof(T));
+        return value;
+    }
+
+    template <class T>
+    static void writeValue_(std::ostream& os, const T& value)
+    { os.write(reinterpret_cast<const char*>(&value), sizeof(T)); }
+
+    template <class T>
+    static void readVector_(std::istream& is, std::vector<T>& data)
+    {
+        std::uint64_t size = readValue_<std::uint64_t>(is);
+        if (!is)
+            return;
+        data.resize(static_cast<std::size_t>(size));
+        is.read(reinterpret_cast<char*>(data.data()),
+                static_cast<std::streamsize>(data.size()*sizeof(T)));
+    }
+
+    template <class T>
+    static void writeVector_(std::ostream& os, const std::vector<T>& data)
+    {
+        writeValue_(os, static_cast<std::uint64_t>(data.size()));
+        os.write(reinterpret_cast<const char*>(data.data()),
+                 static_cast<std::streamsize>(data.size()*sizeof(T)));
+    }
+
+    std::string fileName_;
+    std::uint64_t key_;
+
+    std::vector<double> coordinates_;
+    std::vector<unsigned> elementTypes_;
+    std::vector<std::uint64_t> elementOffsets_;
+    std::vector<std::uint32_t> connectivity_;
+    std::vector<FractureEdge> fractureEdges_;
+
+    std::vector<unsigned> vertexIndex_;
+};
+
+} // namespace Opm
+
+#endif
@@ -0,0 +1,818 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \copydoc Opm::Hdf5MultiWriter
+ */
+#ifndef EWOMS_HDF5_MULTI_WRITER_HH
+#define EWOMS_HDF5_MULTI_WRITER_HH
+
+#include <opm/models/io/baseoutputwriter.hh>
+#include <opm/models/parallel/globalelementindices.hh>
+
+#include <dune/common/fvector.hh>
+#include <dune/common/version.hh>
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/geometry/type.hh>
+#include <dune/grid/common/mcmgmapper.hh>
+#include <dune/grid/common/partitionset.hh>
+#include <dune/grid/io/file/vtk/common.hh>
+
+#if HAVE_MPI
+#include <mpi.h>
+#endif
+
+#if HAVE_HDF5
+#include <hdf5.h>
+#endif
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace Opm {
+
+/*!
+ * \brief Writes all report steps of a simulation into a single HDF5 file.
+ *
+ * In contrast to the VtkMultiWriter, which produces one VTU file per process and
+ * report step plus the .pvtu and .pvd meta files, this writer stores the grid topology
+ * only once (and again after each change of the grid) and appends the cell and vertex
+ * fields of every report step to the same file. In parallel runs, all processes write
+ * their part of the data collectively, which requires HDF5 to be built with MPI
+ * support. Next to the HDF5 file, an XDMF descriptor is written which allows ParaView
+ * and VisIt to read the data set.
+ *
+ * The layout of the HDF5 file is as follows:
+ *
+ * - /grid_N/coordinates: the positions of the vertices of the Nth grid
+ * - /grid_N/connectivity: the vertex indices of the elements of the Nth grid
+ * - /step_M/cell/$NAME: the element centered field $NAME of the Mth report step
+ * - /step_M/vertex/$NAME: the vertex centered field $NAME of the Mth report step
+ *
+ * Optionally, the output can be restricted to the elements within a box or to an
+ * explicit set of elements. In this case, only these elements and their vertices are
+ * written. Since the set of elements is given by global element indices (see
+ * forEachElementOfGlobalIndices()), it selects the same elements for any number of
+ * processes.
+ */
+template <class GridView>
+class Hdf5MultiWriter : public BaseOutputWriter
+{
+    enum { dim = GridView::dimension };
+    enum { dimWorld = GridView::dimensionworld };
+
+    using VertexMapper = Dune::MultipleCodimMultipleGeomTypeMapper<GridView>;
+    using ElementMapper = Dune::MultipleCodimMultipleGeomTypeMapper<GridView>;
+    using GlobalPosition = Dune::FieldVector<typename GridView::ctype, dimWorld>;
+
+    // the entity type a field is associated with
+    enum class Centering { Cell, Vertex };
+
+    // a field which has been attached to the writer for the current report step
+    struct Field
+    {
+        std::string name;
+        Centering centering;
+        unsigned numComponents;
+        const ScalarBuffer* scalarBuf;
+        const VectorBuffer* vectorBuf;
+        const TensorBuffer* tensorBuf;
+        unsigned tensorColumn;
+    };
+
+public:
+    using Scalar = BaseOutputWriter::Scalar;
+    using Vector = BaseOutputWriter::Vector;
+    using Tensor = BaseOutputWriter::Tensor;
+    using ScalarBuffer = BaseOutputWriter::ScalarBuffer;
+    using VectorBuffer = BaseOutputWriter::VectorBuffer;
+    using TensorBuffer = BaseOutputWriter::TensorBuffer;
+
+    Hdf5MultiWriter(const GridView& gridView,
+                    const std::string& outputDir,
+                    const std::string& simName = "")
+        : gridView_(gridView)
+        , elementMapper_(gridView, Dune::mcmgElementLayout())
+        , vertexMapper_(gridView, Dune::mcmgVertexLayout())
+        , curWriterNum_(0)
+        , gridNum_(0)
+        , gridUpToDate_(false)
+        , fileIsOpen_(false)
+        , appendToFile_(false)
+        , hasRegionBox_(false)
+    {
+#if !HAVE_HDF5
+        throw std::runtime_error("HDF5 output has been requested, but opm-models was "
+                                 "configured without HDF5 support");
+#else
+        outputDir_ = outputDir;
+        if (outputDir == "")
+            outputDir_ = ".";
+
+        simName_ = (simName.empty()) ? "sim" : simName;
+        h5FileName_ = simName_ + ".h5";
+        xdmfFileName_ = outputDir_ + "/" + simName_ + ".xmf";
+
+        commRank_ = gridView.comm().rank();
+        commSize_ = gridView.comm().size();
+
+#if !defined(H5_HAVE_PARALLEL) || !HAVE_MPI
+        if (commSize_ > 1)
+            throw std::runtime_error("Parallel HDF5 output requires HDF5 to be built with "
+                                     "MPI support");
+#endif
+
+        file_ = -1;
+#endif // HAVE_HDF5
+    }
+
+    ~Hdf5MultiWriter()
+    {
+#if HAVE_HDF5
+        if (fileIsOpen_)
+            H5Fclose(file_);
+#endif
+    }
+
+    /*!
+     * \brief Returns the number of the current report step.
+     */
+    int curWriterNum() const
+    { return curWriterNum_; }
+
+    /*!
+     * \brief Updates the internal data structures after mesh refinement.
+     *
+     * If the grid changes between two calls of beginWrite(), this method _must_ be
+     * called before the second beginWrite()! The topology of the new grid will then be
+     * written into a new group of the HDF5 file.
+     */
+    void gridChanged()
+    {
+#if DUNE_VERSION_NEWER(DUNE_GRID, 2, 8)
+        elementMapper_.update(gridView_);
+        vertexMapper_.update(gridView_);
+#else
+        elementMapper_.update();
+        vertexMapper_.update();
+#endif
+        gridUpToDate_ = false;
+    }
+
+    /*!
+     * \brief Restrict the output to the elements whose centers are located within an
+     *        axis-aligned box.
+     */
+    void setOutputRegion(const GlobalPosition& lower, const GlobalPosition& upper)
+    {
+        hasRegionBox_ = true;
+        regionLower_ = lower;
+        regionUpper_ = upper;
+        gridUpToDate_ = false;
+    }
+
+    /*!
+     * \brief Restrict the output to a set of elements.
+     *
+     * The indices are the global element indices defined by
+     * forEachElementOfGlobalIndices(), i.e., they do not depend on the partition of
+     * the grid and the same indices must be specified on all processes. If a box has
+     * been specified as well, only the elements which are both in the set and in the
+     * box are written.
+     */
+    void setOutputElements(std::vector<unsigned> elemIndices)
+    {
+        regionElements_ = std::move(elemIndices);
+        gridUpToDate_ = false;
+    }
+
+    /*!
+     * \brief Called whenever a new report step must be written.
+     */
+    void beginWrite(double t)
+    {
+        curTime_ = t;
+        fields_.clear();
+
+#if HAVE_HDF5
+        if (!fileIsOpen_)
+            openFile_();
+
+        if (!gridUpToDate_) {
+            if (curWriterNum_ > 0 || appendToFile_)
+                ++gridNum_;
+            writeGrid_();
+            gridUpToDate_ = true;
+        }
+#endif
+    }
+
+    /*!
+     * \brief Add a finished vertex centered scalar field to the output.
+     *
+     * The buffer must exist at least until the call to endWrite() finishes.
+     */
+    void attachScalarVertexData(ScalarBuffer& buf, std::string name)
+    {
+        if (fieldSelected(name))
+            fields_.push_back(Field{name, Centering::Vertex, 1, &buf, nullptr, nullptr, 0});
+    }
+
+    /*!
+     * \brief Add a finished element centered scalar field to the output.
+     *
+     * The buffer must exist at least until the call to endWrite() finishes.
+     */
+    void attachScalarElementData(ScalarBuffer& buf, std::string name)
+    {
+        if (fieldSelected(name))
+            fields_.push_back(Field{name, Centering::Cell, 1, &buf, nullptr, nullptr, 0});
+    }
+
+    /*!
+     * \brief Add a finished vertex centered vector field to the output.
+     *
+     * The buffer must exist at least until the call to endWrite() finishes.
+     */
+    void attachVectorVertexData(VectorBuffer& buf, std::string name)
+    {
+        if (fieldSelected(name))
+            fields_.push_back(Field{name, Centering::Vertex, 3, nullptr, &buf, nullptr, 0});
+    }
+
+    /*!
+     * \brief Add a finished element centered vector field to the output.
+     *
+     * The buffer must exist at least until the call to endWrite() finishes.
+     */
+    void attachVectorElementData(VectorBuffer& buf, std::string name)
+    {
+        if (fieldSelected(name))
+            fields_.push_back(Field{name, Centering::Cell, 3, nullptr, &buf, nullptr, 0});
+    }
+
+    /*!
+     * \brief Add a finished vertex-centered tensor field to the output.
+     *
+     * Like for the VTK output, each column of the tensor is written as a separate
+     * vector field.
+     */
+    void attachTensorVertexData(TensorBuffer& buf, std::string name)
+    {
+        if (!fieldSelected(name))
+            return;
+
+        for (unsigned colIdx = 0; colIdx < buf[0].N(); ++colIdx) {
+            std::ostringstream oss;
+            oss << name << "[" << colIdx << "]";
+            fields_.push_back(Field{oss.str(), Centering::Vertex, 3, nullptr, nullptr, &buf, colIdx});
+        }
+    }
+
+    /*!
+     * \brief Add a finished element-centered tensor field to the output.
+     *
+     * Like for the VTK output, each column of the tensor is written as a separate
+     * vector field.
+     */
+    void attachTensorElementData(TensorBuffer& buf, std::string name)
+    {
+        if (!fieldSelected(name))
+            return;
+
+        for (unsigned colIdx = 0; colIdx < buf[0].N(); ++colIdx) {
+            std::ostringstream oss;
+            oss << name << "[" << colIdx << "]";
+            fields_.push_back(Field{oss.str(), Centering::Cell, 3, nullptr, nullptr, &buf, colIdx});
+        }
+    }
+
+    /*!
+     * \brief Finalizes the current report step.
+     *
+     * This means that all attached fields are written to the HDF5 file and the XDMF
+     * descriptor is updated, except if the onlyDiscard argument is true. In this case
+     * the attached fields are simply forgotten.
+     */
+    void endWrite([[maybe_unused]] bool onlyDiscard = false)
+    {
+#if HAVE_HDF5
+        if (!onlyDiscard) {
+            writeStep_();
+            writeXdmf_();
+            ++curWriterNum_;
+        }
+#endif
+        fields_.clear();
+    }
+
+    /*!
+     * \brief Write the writer's state to a restart file.
+     */
+    template <class Restarter>
+    void serialize(Restarter& res)
+    {
+        res.serializeSectionBegin("HDF5MultiWriter");
+        res.serializeStream() << curWriterNum_ << " " << gridNum_ << " "
+                              << stepXml_.size() << "\n";
+        if (commRank_ == 0) {
+            for (const auto& xml : stepXml_) {
+                res.serializeStream() << xml.size() << "\n";
+                res.serializeStream().write(xml.data(), static_cast<std::streamsize>(xml.size()));
+                res.serializeStream() << "\n";
+            }
+        }
+        res.serializeSectionEnd();
+    }
+
+    /*!
+     * \brief Read the writer's state from a restart file.
+     */
+    template <class Restarter>
+    void deserialize(Restarter& res)
+    {
+        res.deserializeSectionBegin("HDF5MultiWriter");
+        std::size_t numSteps;
+        res.deserializeStream() >> curWriterNum_ >> gridNum_ >> numSteps;
+        std::string dummy;
+        std::getline(res.deserializeStream(), dummy);
+
+        stepXml_.clear();
+        if (commRank_ == 0) {
+            for (std::size_t stepIdx = 0; stepIdx < numSteps; ++stepIdx) {
+                std::size_t len;
+                res.deserializeStream() >> len;
+                std::getline(res.deserializeStream(), dummy);
+
+                std::string xml(len, ' ');
+                res.deserializeStream().read(&xml[0], static_cast<std::streamsize>(len));
+                std::getline(res.deserializeStream(), dummy);
+                stepXml_.push_back(xml);
+            }
+        }
+        res.deserializeSectionEnd();
+
+        // the existing file needs to be extended instead of being truncated and the
+        // grid needs to be written to a new group
+        appendToFile_ = true;
+        gridUpToDate_ = false;
+    }
+
+private:
+#if HAVE_HDF5
+    void openFile_()
+    {
+        std::string fileName = outputDir_ + "/" + h5FileName_;
+
+        hid_t fapl = H5Pcreate(H5P_FILE_ACCESS);
+#if HAVE_MPI && defined(H5_HAVE_PARALLEL)
+        if (commSize_ > 1)
+            H5Pset_fapl_mpio(fapl, Dune::MPIHelper::getCommunicator(), MPI_INFO_NULL);
+#endif
+
+        if (appendToFile_)
+            file_ = H5Fopen(fileName.c_str(), H5F_ACC_RDWR, fapl);
+        else
+            file_ = H5Fcreate(fileName.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, fapl);
+        H5Pclose(fapl);
+
+        if (file_ < 0)
+            throw std::runtime_error("Could not open HDF5 output file '"+fileName+"'");
+
+        fileIsOpen_ = true;
+    }
+
+    // determine the process-local elements and vertices which are written and their
+    // position in the global data sets
+    void updatePartition_()
+    {
+        localElements_.clear();
+        localVertices_.clear();
+        elementWritten_.assign(static_cast<std::size_t>(gridView_.size(0)), false);
+        vertexIndex_.assign(static_cast<std::size_t>(gridView_.size(dim)), -1);
+
+        // translate the global indices of the selected elements to the local ones
+        elementSelected_.clear();
+        if (!regionElements_.empty()) {
+            elementSelected_.assign(static_cast<std::size_t>(gridView_.size(0)), false);
+            forEachElementOfGlobalIndices(gridView_, regionElements_,
+                                          [this](std::size_t, const auto& elem)
+                                          { elementSelected_[elementMapper_.index(elem)] = true; });
+        }
+
+        for (const auto& elem : elements(gridView_, Dune::Partitions::interior)) {
+            unsigned elemIdx = static_cast<unsigned>(elementMapper_.index(elem));
+            if (!inOutputRegion_(elem, elemIdx))
+                continue;
+
+            elementWritten_[elemIdx] = true;
+            localElements_.push_back(elemIdx);
+
+            // the vertices are numbered in the order in which they are encountered
+            unsigned numCorners = static_cast<unsigned>(elem.subEntities(dim));
+            for (unsigned i = 0; i < numCorners; ++i) {
+                unsigned vIdx = static_cast<unsigned>(vertexMapper_.subIndex(elem, i, dim));
+                if (vertexIndex_[vIdx] < 0) {
+                    vertexIndex_[vIdx] = static_cast<long>(localVertices_.size());
+                    localVertices_.push_back(vIdx);
+                }
+            }
+        }
+
+        computeOffsets_(localElements_.size(), elemOffset_, numGlobalElements_);
+        computeOffsets_(localVertices_.size(), vertexOffset_, numGlobalVertices_);
+    }
+
+    template <class Element>
+    bool inOutputRegion_(const Element& elem, unsigned elemIdx) const
+    {
+        if (!elementSelected_.empty() && !elementSelected_[elemIdx])
+            return false;
+
+        if (hasRegionBox_) {
+            const auto& center = elem.geometry().center();
+            for (unsigned k = 0; k < dimWorld; ++k)
+                if (center[k] < regionLower_[k] || regionUpper_[k] < center[k])
+                    return false;
+        }
+
+        return true;
+    }
+
+    void computeOffsets_(std::size_t numLocal, hsize_t& offset, hsize_t& numGlobal) const
+    {
+        std::vector<unsigned long> allCounts(static_cast<std::size_t>(commSize_));
+        unsigned long n = numLocal;
+        gridView_.comm().allgather(&n, 1, allCounts.data());
+
+        offset = 0;
+        numGlobal = 0;
+        for (int rank = 0; rank < commSize_; ++rank) {
+            if (rank < commRank_)
+                offset += allCounts[static_cast<std::size_t>(rank)];
+            numGlobal += allCounts[static_cast<std::size_t>(rank)];
+        }
+    }
+
+    void writeGrid_()
+    {
+        updatePartition_();
+
+        // determine the element type. XDMF only supports grids with a single type of
+        // elements without resorting to "mixed" topologies.
+        cornersPerElement_ = 0;
+        for (const auto& elem : elements(gridView_, Dune::Partitions::interior)) {
+            unsigned n = static_cast<unsigned>(elem.subEntities(dim));
+            if (cornersPerElement_ == 0) {
+                cornersPerElement_ = n;
+                topologyName_ = xdmfTopologyName_(elem.type());
+            }
+            else if (n != cornersPerElement_)
+                throw std::runtime_error("The HDF5 output writer only supports grids "
+                                         "consisting of a single type of elements");
+        }
+        cornersPerElement_ = gridView_.comm().max(cornersPerElement_);
+
+        std::string groupName = "/grid_" + std::to_string(gridNum_);
+        hid_t group = createGroup_(groupName);
+
+        // vertex coordinates. XDMF requires three components even for 2D grids.
+        std::vector<double> coords(localVertices_.size()*3, 0.0);
+        for (const auto& vertex : vertices(gridView_)) {
+            long idx = vertexIndex_[static_cast<std::size_t>(vertexMapper_.index(vertex))];
+            if (idx < 0)
+                continue;
+
+            const auto& pos = vertex.geometry().corner(0);
+            for (unsigned k = 0; k < dimWorld; ++k)
+                coords[static_cast<std::size_t>(idx)*3 + k] = pos[k];
+        }
+        writeDataSet_(group, "coordinates", coords.data(), H5T_NATIVE_DOUBLE,
+                      localVertices_.size(), vertexOffset_, numGlobalVertices_, 3);
+
+        // element connectivity in terms of global vertex indices. The corners of DUNE
+        // elements are ordered differently than the ones of VTK and XDMF.
+        std::vector<std::int64_t> connectivity(localElements_.size()*cornersPerElement_);
+        std::size_t localElemIdx = 0;
+        for (const auto& elem : elements(gridView_, Dune::Partitions::interior)) {
+            if (!elementWritten_[static_cast<std::size_t>(elementMapper_.index(elem))])
+                continue;
+
+            for (unsigned i = 0; i < cornersPerElement_; ++i) {
+                int duneIdx = Dune::VTK::renumber(elem.type(), static_cast<int>(i));
+                auto vIdx = vertexMapper_.subIndex(elem, duneIdx, dim);
+                connectivity[localElemIdx*cornersPerElement_ + i] =
+                    static_cast<std::int64_t>(vertexOffset_) + vertexIndex_[vIdx];
+            }
+            ++localElemIdx;
+        }
+        writeDataSet_(group, "connectivity", connectivity.data(), H5T_NATIVE_INT64,
+                      localElements_.size(), elemOffset_, numGlobalElements_,
+                      cornersPerElement_);
+
+        H5Gclose(group);
+    }
+
+    void writeStep_()
+    {
+        std::string stepName = stepGroupName_(curWriterNum_);
+
+        // when continuing a restarted simulation, the step may already exist
+        if (H5Lexists(file_, stepName.c_str(), H5P_DEFAULT) > 0)
+            H5Ldelete(file_, stepName.c_str(), H5P_DEFAULT);
+
+        hid_t stepGroup = createGroup_(stepName);
+        hid_t cellGroup = createGroup_(stepName + "/cell");
+        hid_t vertexGroup = createGroup_(stepName + "/vertex");
+
+        hid_t attrSpace = H5Screate(H5S_SCALAR);
+        hid_t attr = H5Acreate2(stepGroup, "time", H5T_NATIVE_DOUBLE, attrSpace,
+                                H5P_DEFAULT, H5P_DEFAULT);
+        H5Awrite(attr, H5T_NATIVE_DOUBLE, &curTime_);
+        H5Aclose(attr);
+        H5Sclose(attrSpace);
+
+        std::vector<double> data;
+        std::vector<float> singlePrecisionData;
+        for (const auto& field : fields_) {
+            const auto& indices =
+                (field.centering == Centering::Cell) ? localElements_ : localVertices_;
+            extractField_(data, field, indices);
+
+            const void* buf = data.data();
+            hid_t type = H5T_NATIVE_DOUBLE;
+            if (singlePrecision()) {
+                singlePrecisionData.assign(data.begin(), data.end());
+                buf = singlePrecisionData.data();
+                type = H5T_NATIVE_FLOAT;
+            }
+
+            if (field.centering == Centering::Cell)
+                writeDataSet_(cellGroup, field.name, buf, type,
+                              indices.size(), elemOffset_, numGlobalElements_,
+                              field.numComponents);
+            else
+                writeDataSet_(vertexGroup, field.name, buf, type,
+                              indices.size(), vertexOffset_, numGlobalVertices_,
+                              field.numComponents);
+        }
+
+        H5Gclose(vertexGroup);
+        H5Gclose(cellGroup);
+        H5Gclose(stepGroup);
+
+        H5Fflush(file_, H5F_SCOPE_GLOBAL);
+
+        stepXml_.push_back(stepDescription_());
+    }
+
+    // copy the values of a field for the entities written by the local process into a
+    // contiguous buffer
+    void extractField_(std::vector<double>& data,
+                       const Field& field,
+                       const std::vector<unsigned>& indices) const
+    {
+        data.resize(indices.size()*field.numComponents);
+        for (std::size_t i = 0; i < indices.size(); ++i) {
+            unsigned idx = indices[i];
+            if (field.scalarBuf)
+                data[i] = (*field.scalarBuf)[idx];
+            else if (field.vectorBuf) {
+                const auto& v = (*field.vectorBuf)[idx];
+                for (unsigned k = 0; k < field.numComponents; ++k)
+                    data[i*field.numComponents + k] = (k < v.size()) ? v[k] : 0.0;
+            }
+            else {
+                const auto& t = (*field.tensorBuf)[idx];
+                for (unsigned k = 0; k < field.numComponents; ++k)
+                    data[i*field.numComponents + k] =
+                        (k < t.N()) ? t[k][field.tensorColumn] : 0.0;
+            }
+        }
+    }
+
+    hid_t createGroup_(const std::string& name)
+    {
+        hid_t group = H5Gcreate2(file_, name.c_str(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+        if (group < 0)
+            throw std::runtime_error("Could not create group '"+name+"' in HDF5 output file");
+        return group;
+    }
+
+    // collectively write a data set consisting of numGlobal rows of numComponents
+    // values each of which the local process contributes the rows [offset, offset +
+    // numLocal)
+    void writeDataSet_(hid_t group,
+                       const std::string& name,
+                       const void* data,
+                       hid_t memType,
+                       std::size_t numLocal,
+                       hsize_t offset,
+                       hsize_t numGlobal,
+                       unsigned numComponents)
+    {
+        int rank = (numComponents > 1) ? 2 : 1;
+        hsize_t globalDims[2] = { numGlobal, numComponents };
+        hsize_t start[2] = { offset, 0 };
+        hsize_t count[2] = { numLocal, numComponents };
+
+        hid_t fileSpace = H5Screate_simple(rank, globalDims, nullptr);
+        hid_t dataSet = H5Dcreate2(group, name.c_str(), memType, fileSpace,
+                                   H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+        if (dataSet < 0)
+            throw std::runtime_error("Could not create data set '"+name+"' in HDF5 output file");
+
+        hid_t memSpace = H5Screate_simple(rank, count, nullptr);
+        if (numLocal > 0)
+            H5Sselect_hyperslab(fileSpace, H5S_SELECT_SET, start, nullptr, count, nullptr);
+        else {
+            H5Sselect_none(fileSpace);
+            H5Sselect_none(memSpace);
+        }
+
+        hid_t dxpl = H5Pcreate(H5P_DATASET_XFER);
+#if HAVE_MPI && defined(H5_HAVE_PARALLEL)
+        if (commSize_ > 1)
+            H5Pset_dxpl_mpio(dxpl, H5FD_MPIO_COLLECTIVE);
+#endif
+
+        herr_t status = H5Dwrite(dataSet, memType, memSpace, fileSpace, dxpl, data);
+
+        H5Pclose(dxpl);
+        H5Sclose(memSpace);
+        H5Dclose(dataSet);
+        H5Sclose(fileSpace);
+
+        if (status < 0)
+            throw std::runtime_error("Could not write data set '"+name+"' to HDF5 output file");
+    }
+
+    static std::string xdmfTopologyName_(const Dune::GeometryType& type)
+    {
+        if (type.isLine())
+            return "Polyline";
+        else if (type.isTriangle())
+            return "Triangle";
+        else if (type.isQuadrilateral())
+            return "Quadrilateral";
+        else if (type.isTetrahedron())
+            return "Tetrahedron";
+        else if (type.isPyramid())
+            return "Pyramid";
+        else if (type.isPrism())
+            return "Wedge";
+        else if (type.isHexahedron())
+            return "Hexahedron";
+
+        throw std::runtime_error("The HDF5 output writer does not support elements of "
+                                 "type "+std::to_string(type.id()));
+    }
+
+    static std::string stepGroupName_(int stepIdx)
+    {
+        std::ostringstream oss;
+        oss << "/step_" << std::setw(5) << std::setfill('0') << stepIdx;
+        return oss.str();
+    }
+
+    // the XDMF description of the current report step
+    std::string stepDescription_() const
+    {
+        std::string stepName = stepGroupName_(curWriterNum_);
+        std::string gridName = "/grid_" + std::to_string(gridNum_);
+
+        std::ostringstream oss;
+        oss.precision(16);
+        oss << "   <Grid Name=\"" << stepName.substr(1) << "\" GridType=\"Uniform\">\n"
+            << "    <Time Value=\"" << curTime_ << "\"/>\n"
+            << "    <Topology TopologyType=\"" << topologyName_ << "\""
+            << " NumberOfElements=\"" << numGlobalElements_ << "\"";
+        if (topologyName_ == "Polyline")
+            oss << " NodesPerElement=\"" << cornersPerElement_ << "\"";
+        oss << ">\n"
+            << "     <DataItem Dimensions=\"" << numGlobalElements_ << " " << cornersPerElement_ << "\""
+            << " NumberType=\"Int\" Precision=\"8\" Format=\"HDF\">"
+            << h5FileName_ << ":" << gridName << "/connectivity</DataItem>\n"
+            << "    </Topology>\n"
+            << "    <Geometry GeometryType=\"XYZ\">\n"
+            << "     <DataItem Dimensions=\"" << numGlobalVertices_ << " 3\""
+            << " NumberType=\"Float\" Precision=\"8\" Format=\"HDF\">"
+            << h5FileName_ << ":" << gridName << "/coordinates</DataItem>\n"
+            << "    </Geometry>\n";
+
+        for (const auto& field : fields_) {
+            bool isCell = field.centering == Centering::Cell;
+            hsize_t n = isCell ? numGlobalElements_ : numGlobalVertices_;
+            oss << "    <Attribute Name=\"" << field.name << "\""
+                << " AttributeType=\"" << (field.numComponents > 1 ? "Vector" : "Scalar") << "\""
+                << " Center=\"" << (isCell ? "Cell" : "Node") << "\">\n"
+                << "     <DataItem Dimensions=\"" << n;
+            if (field.numComponents > 1)
+                oss << " " << field.numComponents;
+            oss << "\" NumberType=\"Float\" Precision=\"" << (singlePrecision() ? 4 : 8) << "\""
+                << " Format=\"HDF\">"
+                << h5FileName_ << ":" << stepName << (isCell ? "/cell/" : "/vertex/")
+                << field.name << "</DataItem>\n"
+                << "    </Attribute>\n";
+        }
+        oss << "   </Grid>\n";
+
+        return oss.str();
+    }
+
+    void writeXdmf_() const
+    {
+        // only the first process writes the XDMF descriptor
+        if (commRank_ != 0)
+            return;
+
+        // the descriptor is small, so we simply rewrite it completely after each
+        // report step. this makes sure that it is always valid even if the
+        // simulation is aborted.
+        std::ofstream xdmfFile(xdmfFileName_);
+        xdmfFile << "<?xml version=\"1.0\" ?>\n"
+                    "<!DOCTYPE Xdmf SYSTEM \"Xdmf.dtd\" []>\n"
+                    "<Xdmf Version=\"3.0\">\n"
+                    " <Domain>\n"
+                    "  <Grid Name=\"" << simName_ << "\" GridType=\"Collection\" CollectionType=\"Temporal\">\n";
+        for (const auto& xml : stepXml_)
+            xdmfFile << xml;
+        xdmfFile << "  </Grid>\n"
+                    " </Domain>\n"
+                    "</Xdmf>\n";
+    }
+
+    hid_t file_;
+    hsize_t elemOffset_;
+    hsize_t vertexOffset_;
+    hsize_t numGlobalElements_;
+    hsize_t numGlobalVertices_;
+#endif // HAVE_HDF5
+
+    const GridView gridView_;
+    ElementMapper elementMapper_;
+    VertexMapper vertexMapper_;
+
+    std::string outputDir_;
+    std::string simName_;
+    std::string h5FileName_;
+    std::string xdmfFileName_;
+
+    int commSize_; // number of processes in the communicator
+    int commRank_; // rank of the current process in the communicator
+
+    double curTime_;
+    int curWriterNum_;
+    int gridNum_;
+    bool gridUpToDate_;
+    bool fileIsOpen_;
+    bool appendToFile_;
+
+    unsigned cornersPerElement_;
+    std::string topologyName_;
+
+    std::vector<unsigned> localElements_;
+    std::vector<unsigned> localVertices_;
+    std::vector<bool> elementWritten_;
+    std::vector<long> vertexIndex_; // position of a vertex in the written data or -1
+
+    bool hasRegionBox_;
+    GlobalPosition regionLower_;
+    GlobalPosition regionUpper_;
+    std::vector<unsigned> regionElements_; // global indices
+    std::vector<bool> elementSelected_; // indexed by the local element index
+
+    std::vector<Field> fields_;
+    std::vector<std::string> stepXml_;
+};
+
+} // namespace Opm
+
+#endif
@@ -0,0 +1,442 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \copydoc Opm::ProbeOutputModule
+ */
+#ifndef EWOMS_PROBE_OUTPUT_MODULE_HH
+#define EWOMS_PROBE_OUTPUT_MODULE_HH
+
+#include <opm/models/utils/parametersystem.hh>
+#include <opm/models/utils/propertysystem.hh>
+#include <opm/models/common/multiphasebaseproperties.hh>
+#include <opm/models/discretization/common/fvbaseproperties.hh>
+#include <opm/models/parallel/globalelementindices.hh>
+#include <opm/models/parallel/tasklets.hh>
+
+#include <opm/material/common/MathToolbox.hpp>
+
+#include <dune/common/fvector.hh>
+#include <dune/geometry/referenceelements.hh>
+#include <dune/grid/common/partitionset.hh>
+
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Opm::Properties {
+
+template <class TypeTag, class MyTypeTag>
+struct FluidSystem;
+
+// the files which specify the locations of the probes
+template<class TypeTag, class MyTypeTag>
+struct ProbeElementsFile { using type = UndefinedProperty; };
+template<class TypeTag, class MyTypeTag>
+struct ProbePositionsFile { using type = UndefinedProperty; };
+
+// write the time series using a separate thread
+template<class TypeTag, class MyTypeTag>
+struct EnableAsyncProbeOutput { using type = UndefinedProperty; };
+
+template<class TypeTag>
+struct ProbeElementsFile<TypeTag, TTag::FvBaseDiscretization> { static constexpr auto value = ""; };
+template<class TypeTag>
+struct ProbePositionsFile<TypeTag, TTag::FvBaseDiscretization> { static constexpr auto value = ""; };
+template<class TypeTag>
+struct EnableAsyncProbeOutput<TypeTag, TTag::FvBaseDiscretization> { static constexpr bool value = true; };
+
+} // namespace Opm::Properties
+
+namespace Opm {
+
+/*!
+ * \ingroup Vtk
+ *
+ * \brief Records the time series of a few quantities at a set of probe locations.
+ *
+ * In contrast to the VTK or HDF5 output, which write all fields for all elements, this
+ * module only samples the phase pressures, the phase saturations and the temperature
+ * of a (typically small) set of elements after each time step and appends them as a
+ * line to the CSV file "$SIMNAME-probes.csv". The probes are either specified by the
+ * global indices of the elements (see forEachElementOfGlobalIndices()) or by
+ * positions, for which the element containing the position is looked up once at the
+ * beginning of the simulation.
+ *
+ * For vertex-centered discretizations, the quantities of the first degree of freedom of
+ * the element are recorded. In parallel runs, each probe is handled by a single
+ * process which owns its element and the values are gathered by the first process,
+ * which also writes the file.
+ */
+template<class TypeTag>
+class ProbeOutputModule
+{
+    using Simulator = GetPropType<TypeTag, Properties::Simulator>;
+    using Scalar = GetPropType<TypeTag, Properties::Scalar>;
+    using GridView = GetPropType<TypeTag, Properties::GridView>;
+    using ElementContext = GetPropType<TypeTag, Properties::ElementContext>;
+    using FluidSystem = GetPropType<TypeTag, Properties::FluidSystem>;
+
+    enum { numPhases = getPropValue<TypeTag, Properties::NumPhases>() };
+    enum { dim = GridView::dimension };
+    enum { dimWorld = GridView::dimensionworld };
+
+    // pressures and saturations of all phases plus the temperature
+    enum { numQuantities = 2*numPhases + 1 };
+
+    using CoordScalar = typename GridView::ctype;
+    using GlobalPosition = Dune::FieldVector<CoordScalar, dimWorld>;
+    using Element = typename GridView::template Codim<0>::Entity;
+    using EntitySeed = typename Element::EntitySeed;
+
+    // appends one line to the time series file
+    class WriteRowTasklet : public TaskletInterface
+    {
+    public:
+        WriteRowTasklet(std::ofstream& file, double time, std::vector<double>&& values)
+            : file_(file)
+            , time_(time)
+            , values_(std::move(values))
+        {}
+
+        void run() final
+        {
+            file_ << time_;
+            for (double value : values_)
+                file_ << "," << value;
+            file_ << "\n" << std::flush;
+        }
+
+    private:
+        std::ofstream& file_;
+        double time_;
+        std::vector<double> values_;
+    };
+
+public:
+    ProbeOutputModule(const Simulator& simulator,
+                      const std::string& outputDir,
+                      const std::string& simName)
+        : simulator_(simulator)
+        , gridView_(simulator.gridView())
+        , taskletRunner_(gridView_.comm().rank() == 0
+                         && EWOMS_GET_PARAM(TypeTag, bool, EnableAsyncProbeOutput) ? 1 : 0)
+    {
+        readProbes_();
+        locateProbes_();
+
+        if (gridView_.comm().rank() == 0) {
+            std::string fileName = outputDir + "/" + simName + "-probes.csv";
+            file_.open(fileName);
+            if (!file_)
+                throw std::runtime_error("Could not open probe output file '"+fileName+"'");
+
+            file_.precision(16);
+            writeHeader_();
+        }
+    }
+
+    /*!
+     * \brief Register all run-time parameters for the probe output module.
+     */
+    static void registerParameters()
+    {
+        EWOMS_REGISTER_PARAM(TypeTag, std::string, ProbeElementsFile,
+                             "A file containing the global (i.e., cartesian for "
+                             "structured grids) indices of the elements for which a "
+                             "time series is recorded");
+        EWOMS_REGISTER_PARAM(TypeTag, std::string, ProbePositionsFile,
+                             "A file containing the coordinates of the positions for "
+                             "which a time series is recorded");
+        EWOMS_REGISTER_PARAM(TypeTag, bool, EnableAsyncProbeOutput,
+                             "Dispatch a separate thread to write the probe time series");
+    }
+
+    /*!
+     * \brief Returns true if any probe locations have been specified.
+     */
+    static bool enabled()
+    {
+        return !EWOMS_GET_PARAM(TypeTag, std::string, ProbeElementsFile).empty()
+            || !EWOMS_GET_PARAM(TypeTag, std::string, ProbePositionsFile).empty();
+    }
+
+    /*!
+     * \brief Look up the elements of all probes again after the grid has been changed.
+     */
+    void gridChanged()
+    { locateProbes_(); }
+
+    /*!
+     * \brief Record the quantities at all probes for the current solution.
+     *
+     * The quantities are taken from the intensive quantities of the most recent time
+     * index. If the intensive quantity cache is enabled, these are not recomputed.
+     */
+    void sample(double time)
+    {
+        std::vector<double> localValues;
+        localValues.reserve(localProbeSeeds_.size()*numQuantities);
+
+        ElementContext elemCtx(simulator_);
+        for (const auto& seed : localProbeSeeds_) {
+            const auto& elem = gridView_.grid().entity(seed);
+            elemCtx.updatePrimaryStencil(elem);
+            elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
+
+            const auto& fs = elemCtx.intensiveQuantities(/*dofIdx=*/0, /*timeIdx=*/0).fluidState();
+            for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
+                localValues.push_back(getValue(fs.pressure(phaseIdx)));
+            for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
+                localValues.push_back(getValue(fs.saturation(phaseIdx)));
+            localValues.push_back(getValue(fs.temperature(/*phaseIdx=*/0)));
+        }
+
+        std::vector<double> allValues;
+        const auto& comm = gridView_.comm();
+        if (comm.size() > 1) {
+            if (comm.rank() == 0)
+                allValues.resize(gatheredProbeIdx_.size()*numQuantities);
+            comm.gatherv(localValues.data(), static_cast<int>(localValues.size()),
+                         allValues.data(), valueCounts_.data(), valueDisplacements_.data(),
+                         /*root=*/0);
+        }
+        else
+            allValues = std::move(localValues);
+
+        if (comm.rank() != 0)
+            return;
+
+        // bring the values into the order of the probes. probes which have not been
+        // found in the grid are reported as NaN.
+        std::vector<double> row(probeDescriptions_.size()*numQuantities,
+                                std::numeric_limits<double>::quiet_NaN());
+        for (std::size_t i = 0; i < gatheredProbeIdx_.size(); ++i) {
+            std::size_t probeIdx = static_cast<std::size_t>(gatheredProbeIdx_[i]);
+            std::copy(allValues.begin() + static_cast<std::ptrdiff_t>(i*numQuantities),
+                      allValues.begin() + static_cast<std::ptrdiff_t>((i + 1)*numQuantities),
+                      row.begin() + static_cast<std::ptrdiff_t>(probeIdx*numQuantities));
+        }
+
+        taskletRunner_.dispatch(std::make_shared<WriteRowTasklet>(file_, time, std::move(row)));
+    }
+
+private:
+    void readProbes_()
+    {
+        probeDescriptions_.clear();
+        probeElements_.clear();
+        probeElementProbeIdx_.clear();
+        probePositions_.clear();
+
+        const std::string elemFileName = EWOMS_GET_PARAM(TypeTag, std::string, ProbeElementsFile);
+        if (!elemFileName.empty()) {
+            std::ifstream elemFile(elemFileName);
+            if (!elemFile)
+                throw std::runtime_error("Could not open probe file '"+elemFileName+"'");
+
+            unsigned elemIdx;
+            while (elemFile >> elemIdx) {
+                probeElements_.push_back(elemIdx);
+                probeElementProbeIdx_.push_back(static_cast<int>(probeDescriptions_.size()));
+                probeDescriptions_.push_back("element " + std::to_string(elemIdx));
+            }
+        }
+
+        const std::string posFileName = EWOMS_GET_PARAM(TypeTag, std::string, ProbePositionsFile);
+        if (!posFileName.empty()) {
+            std::ifstream posFile(posFileName);
+            if (!posFile)
+                throw std::runtime_error("Could not open probe file '"+posFileName+"'");
+
+            GlobalPosition pos;
+            while (posFile >> pos[0]) {
+                for (unsigned k = 1; k < dimWorld; ++k)
+                    if (!(posFile >> pos[k]))
+                        throw std::runtime_error("Incomplete position in probe file '"+posFileName+"'");
+
+                std::ostringstream oss;
+                oss << "position (" << pos[0];
+                for (unsigned k = 1; k < dimWorld; ++k)
+                    oss << " " << pos[k];
+                oss << ")";
+
+                probePositions_.emplace_back(pos, static_cast<int>(probeDescriptions_.size()));
+                probeDescriptions_.push_back(oss.str());
+            }
+        }
+
+        // sort the positions so that the candidates for a given element can be found
+        // by bisection
+        std::sort(probePositions_.begin(), probePositions_.end(),
+                  [](const auto& a, const auto& b)
+                  { return a.first[0] < b.first[0]; });
+    }
+
+    // find the process-local elements of all probes
+    void locateProbes_()
+    {
+        std::vector<EntitySeed> probeSeeds(probeDescriptions_.size());
+        std::vector<bool> probeFound(probeDescriptions_.size(), false);
+
+        const auto addProbe = [&](int probeIdx, const Element& elem) {
+            if (probeFound[static_cast<std::size_t>(probeIdx)])
+                return;
+            probeFound[static_cast<std::size_t>(probeIdx)] = true;
+            probeSeeds[static_cast<std::size_t>(probeIdx)] = elem.seed();
+        };
+
+        // the global element indices are unique, so each of these probes is found by
+        // exactly one process
+        forEachElementOfGlobalIndices(gridView_, probeElements_,
+                                      [&](std::size_t i, const Element& elem)
+                                      { addProbe(probeElementProbeIdx_[i], elem); });
+
+        for (const auto& elem : elements(gridView_, Dune::Partitions::interior)) {
+            if (probePositions_.empty())
+                break;
+
+            // bounding box of the element
+            const auto& geom = elem.geometry();
+            GlobalPosition lower = geom.corner(0);
+            GlobalPosition upper = geom.corner(0);
+            for (int cornerIdx = 1; cornerIdx < geom.corners(); ++cornerIdx) {
+                const auto& corner = geom.corner(cornerIdx);
+                for (unsigned k = 0; k < dimWorld; ++k) {
+                    lower[k] = std::min(lower[k], corner[k]);
+                    upper[k] = std::max(upper[k], corner[k]);
+                }
+            }
+
+            const auto& refElem = Dune::ReferenceElements<CoordScalar, dim>::general(elem.type());
+            auto posIt = std::lower_bound(probePositions_.begin(), probePositions_.end(), lower[0],
+                                          [](const auto& a, CoordScalar x)
+                                          { return a.first[0] < x; });
+            for (; posIt != probePositions_.end() && posIt->first[0] <= upper[0]; ++posIt) {
+                const auto& pos = posIt->first;
+                bool inBox = true;
+                for (unsigned k = 1; k < dimWorld; ++k)
+                    inBox = inBox && lower[k] <= pos[k] && pos[k] <= upper[k];
+
+                if (inBox && refElem.checkInside(geom.local(pos)))
+                    addProbe(posIt->second, elem);
+            }
+        }
+
+        // a position on the boundary of the subdomains of several processes is found
+        // by all of them. it is handled by the process of lowest rank.
+        const auto& comm = gridView_.comm();
+        std::vector<int> probeOwner(probeDescriptions_.size(), comm.size());
+        for (std::size_t probeIdx = 0; probeIdx < probeFound.size(); ++probeIdx)
+            if (probeFound[probeIdx])
+                probeOwner[probeIdx] = comm.rank();
+        comm.min(probeOwner.data(), static_cast<int>(probeOwner.size()));
+
+        std::vector<int> localProbeIdx;
+        localProbeSeeds_.clear();
+        for (std::size_t probeIdx = 0; probeIdx < probeOwner.size(); ++probeIdx) {
+            if (probeOwner[probeIdx] != comm.rank())
+                continue;
+            localProbeIdx.push_back(static_cast<int>(probeIdx));
+            localProbeSeeds_.push_back(probeSeeds[probeIdx]);
+        }
+
+        // tell the first process which probes are handled by which process
+        if (comm.size() == 1) {
+            gatheredProbeIdx_ = std::move(localProbeIdx);
+            return;
+        }
+
+        int numLocal = static_cast<int>(localProbeIdx.size());
+        std::vector<int> counts(static_cast<std::size_t>(comm.size()));
+        comm.gather(&numLocal, counts.data(), 1, /*root=*/0);
+
+        std::vector<int> displacements(counts.size(), 0);
+        for (std::size_t rank = 1; rank < counts.size(); ++rank)
+            displacements[rank] = displacements[rank - 1] + counts[rank - 1];
+
+        if (comm.rank() == 0)
+            gatheredProbeIdx_.resize(static_cast<std::size_t>(displacements.back() + counts.back()));
+        else
+            gatheredProbeIdx_.clear();
+        comm.gatherv(localProbeIdx.data(), numLocal, gatheredProbeIdx_.data(),
+                     counts.data(), displacements.data(), /*root=*/0);
+
+        // the number of values sent by each process during sampling
+        valueCounts_.resize(counts.size());
+        valueDisplacements_.resize(counts.size());
+        for (std::size_t rank = 0; rank < counts.size(); ++rank) {
+            valueCounts_[rank] = counts[rank]*numQuantities;
+            valueDisplacements_[rank] = displacements[rank]*numQuantities;
+        }
+    }
+
+    void writeHeader_()
+    {
+        for (std::size_t probeIdx = 0; probeIdx < probeDescriptions_.size(); ++probeIdx)
+            file_ << "# probe " << probeIdx << ": " << probeDescriptions_[probeIdx] << "\n";
+
+        file_ << "time";
+        for (std::size_t probeIdx = 0; probeIdx < probeDescriptions_.size(); ++probeIdx) {
+            for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
+                file_ << ",probe" << probeIdx << "_pressure_" << FluidSystem::phaseName(phaseIdx);
+            for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
+                file_ << ",probe" << probeIdx << "_saturation_" << FluidSystem::phaseName(phaseIdx);
+            file_ << ",probe" << probeIdx << "_temperature";
+        }
+        file_ << "\n";
+    }
+
+    const Simulator& simulator_;
+    const GridView gridView_;
+
+    // the global element indices and the positions of all probes. for the positions,
+    // the probe index is stored alongside because they are sorted.
+    std::vector<std::string> probeDescriptions_;
+    std::vector<unsigned> probeElements_;
+    std::vector<int> probeElementProbeIdx_;
+    std::vector<std::pair<GlobalPosition, int>> probePositions_;
+
+    // the probes which are located on the local process
+    std::vector<EntitySeed> localProbeSeeds_;
+
+    // on the first process: the probe indices of the values received from all processes
+    std::vector<int> gatheredProbeIdx_;
+    std::vector<int> valueCounts_;
+    std::vector<int> valueDisplacements_;
+
+    // the file must outlive the tasklet runner which writes to it
+    std::ofstream file_;
+    TaskletRunner taskletRunner_;
+};
+
+} // namespace Opm
+
+#endif
@@ -33,15 +33,21 @@
 
 #include <dune/grid/yaspgrid.hh>
 #include <dune/grid/io/file/dgfparser/dgfyasp.hh>
+#include <dune/grid/utility/structuredgridfactory.hh>
 
 #if HAVE_DUNE_ALUGRID
 #include <dune/alugrid/grid.hh>
 #include <dune/alugrid/dgf.hh>
+#include <dune/alugrid/common/structuredgridfactory.hh>
 #endif
 
 #include <dune/common/fvector.hh>
 #include <dune/common/version.hh>
 
+#include <array>
+#include <bitset>
+#include <sstream>
+#include <type_traits>
 #include <vector>
 #include <memory>
 
@@ -100,6 +106,17 @@ class StructuredGridVanguard : public BaseVanguard<TypeTag>
 
     static const int dim = Grid::dimension;
 
+    static constexpr bool isYaspGrid_ = std::is_same_v<Grid, Dune::YaspGrid<dim>>;
+
+    // the grids besides YaspGrid which can be created without going through the DGF
+    // parser
+#if HAVE_DUNE_ALUGRID
+    static constexpr bool hasStructuredGridFactory_ =
+        std::is_same_v<Grid, Dune::ALUGrid<dim, dim, Dune::cube, Dune::nonconforming>>;
+#else
+    static constexpr bool hasStructuredGridFactory_ = false;
+#endif
+
 public:
     /*!
      * \brief Register all run-time parameters for the structured grid simulator vanguard.
@@ -133,7 +150,7 @@ public:
     StructuredGridVanguard(Simulator& simulator)
         : ParentType(simulator)
     {
-        Dune::FieldVector<int, dim> cellRes;
+        std::array<unsigned, dim> cellRes;
 
         using GridScalar = double;
         Dune::FieldVector<GridScalar, dim> upperRight;
@@ -149,21 +166,38 @@ public:
             cellRes[2] = EWOMS_GET_PARAM(TypeTag, unsigned, CellsZ);
         }
 
-        std::stringstream dgffile;
-        dgffile << "DGF" << std::endl;
-        dgffile << "INTERVAL" << std::endl;
-        dgffile << lowerLeft  << std::endl;
-        dgffile << upperRight << std::endl;
-        dgffile << cellRes    << std::endl;
-        dgffile << "#" << std::endl;
-        dgffile << "GridParameter" << std::endl;
-        dgffile << "overlap 1" << std::endl;
-        dgffile << "#" << std::endl;
-        dgffile << "Simplex" << std::endl;
-        dgffile << "#" << std::endl;
-
-        // use DGF parser to create a grid from interval block
-        gridPtr_.reset( Dune::GridPtr< Grid >( dgffile ).release() );
+        // create the grid directly instead of writing an interval block to a DGF string
+        // and parsing it again
+        if constexpr (isYaspGrid_) {
+            // the structured grid factory would create a YaspGrid without overlap,
+            // while the DGF parser used an overlap of one cell
+            std::array<int, dim> cells;
+            for (unsigned i = 0; i < dim; ++i)
+                cells[i] = static_cast<int>(cellRes[i]);
+            gridPtr_ = std::make_unique<Grid>(upperRight, cells, std::bitset<dim>(), /*overlap=*/1);
+        }
+        else if constexpr (hasStructuredGridFactory_)
+            gridPtr_ = Dune::StructuredGridFactory<Grid>::createCubeGrid(lowerLeft, upperRight, cellRes);
+        else {
+            // meta grids like GeometryGrid can only be created using DGF
+            std::stringstream dgffile;
+            dgffile << "DGF" << std::endl;
+            dgffile << "INTERVAL" << std::endl;
+            dgffile << lowerLeft  << std::endl;
+            dgffile << upperRight << std::endl;
+            for (unsigned i = 0; i < dim; ++i)
+                dgffile << cellRes[i] << " ";
+            dgffile << std::endl;
+            dgffile << "#" << std::endl;
+            dgffile << "GridParameter" << std::endl;
+            dgffile << "overlap 1" << std::endl;
+            dgffile << "#" << std::endl;
+            dgffile << "Simplex" << std::endl;
+            dgffile << "#" << std::endl;
+
+            // use DGF parser to create a grid from interval block
+            gridPtr_.reset( Dune::GridPtr< Grid >( dgffile ).release() );
+        }
 
         unsigned numRefinements = EWOMS_GET_PARAM(TypeTag, unsigned, GridGlobalRefinements);
         gridPtr_->globalRefine(static_cast<int>(numRefinements));
@@ -30,6 +30,7 @@
 #include <opm/material/densead/Math.hpp>
 
 #include "vtkmultiwriter.hh"
+#include "hdf5multiwriter.hh"
 #include "baseoutputmodule.hh"
 
 #include <opm/models/utils/propertysystem.hh>
@@ -91,6 +92,7 @@ class VtkBlackOilEnergyModule : public BaseOutputModule<TypeTag>
 
     static const int vtkFormat = getPropValue<TypeTag, Properties::VtkOutputFormat>();
     using VtkMultiWriter = ::Opm::VtkMultiWriter<GridView, vtkFormat>;
+    using Hdf5MultiWriter = ::Opm::Hdf5MultiWriter<GridView>;
 
     enum { enableEnergy = getPropValue<TypeTag, Properties::EnableEnergy>() };
     enum { numPhases = getPropValue<TypeTag, Properties::NumPhases>() };
@@ -191,8 +193,8 @@ public:
      */
     void commitBuffers(BaseOutputWriter& baseWriter)
     {
-        VtkMultiWriter *vtkWriter = dynamic_cast<VtkMultiWriter*>(&baseWriter);
-        if (!vtkWriter)
+        if (!dynamic_cast<VtkMultiWriter*>(&baseWriter) &&
+            !dynamic_cast<Hdf5MultiWriter*>(&baseWriter))
             return;
 
         if (!enableEnergy)
@@ -30,6 +30,7 @@
 #include <opm/material/densead/Math.hpp>
 
 #include "vtkmultiwriter.hh"
+#include "hdf5multiwriter.hh"
 #include "baseoutputmodule.hh"
 
 #include <opm/models/utils/propertysystem.hh>
@@ -94,6 +95,7 @@ class VtkBlackOilMICPModule : public BaseOutputModule<TypeTag>
 
     static const int vtkFormat = getPropValue<TypeTag, Properties::VtkOutputFormat>();
     using VtkMultiWriter = ::Opm::VtkMultiWriter<GridView, vtkFormat>;
+    using Hdf5MultiWriter = ::Opm::Hdf5MultiWriter<GridView>;
 
     enum { enableMICP = getPropValue<TypeTag, Properties::EnableMICP>() };
 
@@ -198,8 +200,8 @@ public:
      */
     void commitBuffers(BaseOutputWriter& baseWriter)
     {
-        VtkMultiWriter *vtkWriter = dynamic_cast<VtkMultiWriter*>(&baseWriter);
-        if (!vtkWriter)
+        if (!dynamic_cast<VtkMultiWriter*>(&baseWriter) &&
+            !dynamic_cast<Hdf5MultiWriter*>(&baseWriter))
             return;
 
         if (!enableMICP)
@@ -30,6 +30,7 @@
 #include <opm/material/densead/Math.hpp>
 
 #include "vtkmultiwriter.hh"
+#include "hdf5multiwriter.hh"
 #include "baseoutputmodule.hh"
 
 #include <opm/models/utils/propertysystem.hh>
@@ -119,6 +120,7 @@ class VtkBlackOilModule : public BaseOutputModule<TypeTag>
 
     static const int vtkFormat = getPropValue<TypeTag, Properties::VtkOutputFormat>();
     using VtkMultiWriter = ::Opm::VtkMultiWriter<GridView, vtkFormat>;
+    using Hdf5MultiWriter = ::Opm::Hdf5MultiWriter<GridView>;
 
     enum { oilPhaseIdx = FluidSystem::oilPhaseIdx };
     enum { gasPhaseIdx = FluidSystem::gasPhaseIdx };
@@ -308,8 +310,8 @@ public:
      */
     void commitBuffers(BaseOutputWriter& baseWriter)
     {
-        VtkMultiWriter *vtkWriter = dynamic_cast<VtkMultiWriter*>(&baseWriter);
-        if (!vtkWriter)
+        if (!dynamic_cast<VtkMultiWriter*>(&baseWriter) &&
+            !dynamic_cast<Hdf5MultiWriter*>(&baseWriter))
             return;
 
         if (gasDissolutionFactorOutput_())
@@ -30,6 +30,7 @@
 #include <opm/material/densead/Math.hpp>
 
 #include "vtkmultiwriter.hh"
+#include "hdf5multiwriter.hh"
 #include "baseoutputmodule.hh"
 
 #include <opm/models/utils/propertysystem.hh>
@@ -98,6 +99,7 @@ class VtkBlackOilPolymerModule : public BaseOutputModule<TypeTag>
 
     static const int vtkFormat = getPropValue<TypeTag, Properties::VtkOutputFormat>();
     using VtkMultiWriter = ::Opm::VtkMultiWriter<GridView, vtkFormat>;
+    using Hdf5MultiWriter = ::Opm::Hdf5MultiWriter<GridView>;
 
     enum { enablePolymer = getPropValue<TypeTag, Properties::EnablePolymer>() };
 
@@ -210,8 +212,8 @@ public:
      */
     void commitBuffers(BaseOutputWriter& baseWriter)
     {
-        VtkMultiWriter *vtkWriter = dynamic_cast<VtkMultiWriter*>(&baseWriter);
-        if (!vtkWriter)
+        if (!dynamic_cast<VtkMultiWriter*>(&baseWriter) &&
+            !dynamic_cast<Hdf5MultiWriter*>(&baseWriter))
             return;
 
         if (!enablePolymer)
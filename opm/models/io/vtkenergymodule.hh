@@ -28,6 +28,7 @@
 #define EWOMS_VTK_ENERGY_MODULE_HH
 
 #include "vtkmultiwriter.hh"
+#include "hdf5multiwriter.hh"
 #include "baseoutputmodule.hh"
 
 #include <opm/models/utils/propertysystem.hh>
@@ -99,6 +100,7 @@ class VtkEnergyModule : public BaseOutputModule<TypeTag>
 
     using Toolbox = typename Opm::MathToolbox<Evaluation>;
     using VtkMultiWriter = Opm::VtkMultiWriter<GridView, vtkFormat>;
+    using Hdf5MultiWriter = Opm::Hdf5MultiWriter<GridView>;
 
 public:
     VtkEnergyModule(const Simulator& simulator)
@@ -175,8 +177,8 @@ public:
      */
     void commitBuffers(BaseOutputWriter& baseWriter)
     {
-        VtkMultiWriter *vtkWriter = dynamic_cast<VtkMultiWriter*>(&baseWriter);
-        if (!vtkWriter) {
+        if (!dynamic_cast<VtkMultiWriter*>(&baseWriter) &&
+            !dynamic_cast<Hdf5MultiWriter*>(&baseWriter)) {
             return;
         }
 
@@ -240,6 +240,9 @@ public:
      */
     void attachScalarVertexData(ScalarBuffer& buf, std::string name)
     {
+        if (!fieldSelected(name))
+            return;
+
         sanitizeScalarBuffer_(buf);
 
         using VtkFn = VtkScalarFunction<GridView, VertexMapper>;
@@ -247,7 +250,8 @@ public:
                                     gridView_,
                                     vertexMapper_,
                                     buf,
-                                    /*codim=*/dim));
+                                    /*codim=*/dim,
+                                    singlePrecision()));
         curWriter_->addVertexData(fnPtr);
     }
 
@@ -268,6 +272,9 @@ public:
      */
     void attachScalarElementData(ScalarBuffer& buf, std::string name)
     {
+        if (!fieldSelected(name))
+            return;
+
         sanitizeScalarBuffer_(buf);
 
         using VtkFn = VtkScalarFunction<GridView, ElementMapper>;
@@ -275,7 +282,8 @@ public:
                                     gridView_,
                                     elementMapper_,
                                     buf,
-                                    /*codim=*/0));
+                                    /*codim=*/0,
+                                    singlePrecision()));
         curWriter_->addCellData(fnPtr);
     }
 
@@ -297,6 +305,9 @@ public:
      */
     void attachVectorVertexData(VectorBuffer& buf, std::string name)
     {
+        if (!fieldSelected(name))
+            return;
+
         sanitizeVectorBuffer_(buf);
 
         using VtkFn = VtkVectorFunction<GridView, VertexMapper>;
@@ -304,7 +315,8 @@ public:
                                     gridView_,
                                     vertexMapper_,
                                     buf,
-                                    /*codim=*/dim));
+                                    /*codim=*/dim,
+                                    singlePrecision()));
         curWriter_->addVertexData(fnPtr);
     }
 
@@ -313,6 +325,9 @@ public:
      */
     void attachTensorVertexData(TensorBuffer& buf, std::string name)
     {
+        if (!fieldSelected(name))
+            return;
+
         using VtkFn = VtkTensorFunction<GridView, VertexMapper>;
 
         for (unsigned colIdx = 0; colIdx < buf[0].N(); ++colIdx) {
@@ -324,7 +339,8 @@ public:
                                         vertexMapper_,
                                         buf,
                                         /*codim=*/dim,
-                                        colIdx));
+                                        colIdx,
+                                        singlePrecision()));
             curWriter_->addVertexData(fnPtr);
         }
     }
@@ -346,6 +362,9 @@ public:
      */
     void attachVectorElementData(VectorBuffer& buf, std::string name)
     {
+        if (!fieldSelected(name))
+            return;
+
         sanitizeVectorBuffer_(buf);
 
         using VtkFn = VtkVectorFunction<GridView, ElementMapper>;
@@ -353,7 +372,8 @@ public:
                                     gridView_,
                                     elementMapper_,
                                     buf,
-                                    /*codim=*/0));
+                                    /*codim=*/0,
+                                    singlePrecision()));
         curWriter_->addCellData(fnPtr);
     }
 
@@ -362,6 +382,9 @@ public:
      */
     void attachTensorElementData(TensorBuffer& buf, std::string name)
     {
+        if (!fieldSelected(name))
+            return;
+
         using VtkFn = VtkTensorFunction<GridView, ElementMapper>;
 
         for (unsigned colIdx = 0; colIdx < buf[0].N(); ++colIdx) {
@@ -373,7 +396,8 @@ public:
                                         elementMapper_,
                                         buf,
                                         /*codim=*/0,
-                                        colIdx));
+                                        colIdx,
+                                        singlePrecision()));
             curWriter_->addCellData(fnPtr);
         }
     }
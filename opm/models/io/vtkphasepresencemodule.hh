@@ -28,6 +28,7 @@
 #define EWOMS_VTK_PHASE_PRESENCE_MODULE_HH
 
 #include "vtkmultiwriter.hh"
+#include "hdf5multiwriter.hh"
 #include "baseoutputmodule.hh"
 
 #include <opm/models/utils/parametersystem.hh>
@@ -69,6 +70,7 @@ class VtkPhasePresenceModule : public BaseOutputModule<TypeTag>
 
     static const int vtkFormat = getPropValue<TypeTag, Properties::VtkOutputFormat>();
     using VtkMultiWriter = Opm::VtkMultiWriter<GridView, vtkFormat>;
+    using Hdf5MultiWriter = Opm::Hdf5MultiWriter<GridView>;
 
     using ScalarBuffer = typename ParentType::ScalarBuffer;
 
@@ -121,8 +123,8 @@ public:
      */
     void commitBuffers(BaseOutputWriter& baseWriter)
     {
-        VtkMultiWriter *vtkWriter = dynamic_cast<VtkMultiWriter*>(&baseWriter);
-        if (!vtkWriter) {
+        if (!dynamic_cast<VtkMultiWriter*>(&baseWriter) &&
+            !dynamic_cast<Hdf5MultiWriter*>(&baseWriter)) {
             return;
         }
 
@@ -28,6 +28,7 @@
 #define OPM_VTK_PTFLASH_MODULE_HH
 
 #include "vtkmultiwriter.hh"
+#include "hdf5multiwriter.hh"
 #include "baseoutputmodule.hh"
 
 #include <opm/models/utils/propertysystem.hh>
@@ -85,6 +86,7 @@ class VtkPTFlashModule: public BaseOutputModule<TypeTag>
 
     static const int vtkFormat = getPropValue<TypeTag, Properties::VtkOutputFormat>();
     using VtkMultiWriter = ::Opm::VtkMultiWriter<GridView, vtkFormat>;
+    using Hdf5MultiWriter = ::Opm::Hdf5MultiWriter<GridView>;
 
     using ComponentBuffer = typename ParentType::ComponentBuffer;
     using ScalarBuffer = typename ParentType::ScalarBuffer;
@@ -148,8 +150,8 @@ public:
      */
     void commitBuffers(BaseOutputWriter& baseWriter)
     {
-        auto *vtkWriter = dynamic_cast<VtkMultiWriter*>(&baseWriter);
-        if (!vtkWriter) {
+        if (!dynamic_cast<VtkMultiWriter*>(&baseWriter) &&
+            !dynamic_cast<Hdf5MultiWriter*>(&baseWriter)) {
             return;
         }
 
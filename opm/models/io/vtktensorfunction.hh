@@ -57,13 +57,15 @@ public:
                       const Mapper& mapper,
                       const TensorBuffer& buf,
                       unsigned codim,
-                      unsigned matrixColumnIdx)
+                      unsigned matrixColumnIdx,
+                      bool singlePrecision = true)
         : name_(name)
         , gridView_(gridView)
         , mapper_(mapper)
         , buf_(buf)
         , codim_(codim)
         , matrixColumnIdx_(matrixColumnIdx)
+        , singlePrecision_(singlePrecision)
     { assert(int(buf_.size()) == int(mapper_.size())); }
 
     virtual std::string name() const
@@ -108,9 +110,19 @@ public:
         unsigned i = static_cast<unsigned>(mycomp);
         unsigned j = static_cast<unsigned>(matrixColumnIdx_);
 
-        return static_cast<double>(static_cast<float>(buf_[idx][i][j]));
+        if (singlePrecision_)
+            return static_cast<double>(static_cast<float>(buf_[idx][i][j]));
+        return buf_[idx][i][j];
     }
 
+#if DUNE_VERSION_NEWER(DUNE_GRID, 2, 7)
+    virtual Dune::VTK::Precision precision() const
+    {
+        return singlePrecision_ ? Dune::VTK::Precision::float32
+                                : Dune::VTK::Precision::float64;
+    }
+#endif
+
 private:
     const std::string name_;
     const GridView gridView_;
@@ -118,6 +130,7 @@ private:
     const TensorBuffer& buf_;
     unsigned codim_;
     unsigned matrixColumnIdx_;
+    bool singlePrecision_;
 };
 
 } // namespace Opm
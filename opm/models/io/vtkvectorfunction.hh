@@ -59,12 +59,14 @@ public:
                       const GridView& gridView,
                       const Mapper& mapper,
                       const VectorBuffer& buf,
-                      unsigned codim)
+                      unsigned codim,
+                      bool singlePrecision = true)
         : name_(name)
         , gridView_(gridView)
         , mapper_(mapper)
         , buf_(buf)
         , codim_(codim)
+        , singlePrecision_(singlePrecision)
     { assert(int(buf_.size()) == int(mapper_.size())); }
 
     virtual std::string name() const
@@ -107,15 +109,26 @@ public:
             throw std::logic_error("Only element and vertex based vector fields are "
                                    "supported so far.");
 
-        return static_cast<double>(static_cast<float>(buf_[idx][static_cast<unsigned>(mycomp)]));
+        if (singlePrecision_)
+            return static_cast<double>(static_cast<float>(buf_[idx][static_cast<unsigned>(mycomp)]));
+        return buf_[idx][static_cast<unsigned>(mycomp)];
     }
 
+#if DUNE_VERSION_NEWER(DUNE_GRID, 2, 7)
+    virtual Dune::VTK::Precision precision() const
+    {
+        return singlePrecision_ ? Dune::VTK::Precision::float32
+                                : Dune::VTK::Precision::float64;
+    }
+#endif
+
 private:
     const std::string name_;
     const GridView gridView_;
     const Mapper& mapper_;
     const VectorBuffer& buf_;
     unsigned codim_;
+    bool singlePrecision_;
 };
 
 } // namespace Opm
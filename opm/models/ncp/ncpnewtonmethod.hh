@@ -30,8 +30,6 @@
 
 #include "ncpproperties.hh"
 
-#include <opm/common/Exceptions.hpp>
-
 #include <opm/models/nonlinear/newtonmethod.hh>
 
 #include <algorithm>
@@ -60,7 +58,6 @@ class NcpNewtonMethod : public GetPropType<TypeTag, Properties::DiscNewtonMethod
     using Scalar = GetPropType<TypeTag, Properties::Scalar>;
     using Indices = GetPropType<TypeTag, Properties::Indices>;
     using Simulator = GetPropType<TypeTag, Properties::Simulator>;
-    using SolutionVector = GetPropType<TypeTag, Properties::SolutionVector>;
     using GlobalEqVector = GetPropType<TypeTag, Properties::GlobalEqVector>;
 
     enum { numEq = getPropValue<TypeTag, Properties::NumEq>() };
@@ -82,45 +79,52 @@ protected:
     friend ParentType;
     friend NewtonMethod<TypeTag>;
 
-    void preSolve_(const SolutionVector&,
-                   const GlobalEqVector& currentResidual)
+    /*!
+     * \copydoc NewtonMethod::pressureVarIdx_
+     */
+    int pressureVarIdx_() const
+    { return pressure0Idx; }
+
+    /*!
+     * \copydoc NewtonMethod::residualError_
+     *
+     * The NCP equations are not considered.
+     */
+    Scalar residualError_(const GlobalEqVector& residual) const
     {
-        const auto& constraintsMap = this->model().linearizer().constraintsMap();
-        this->lastError_ = this->error_;
-
-        // calculate the error as the maximum weighted tolerance of
-        // the solution's residual
-        this->error_ = 0;
-        for (unsigned dofIdx = 0; dofIdx < currentResidual.size(); ++dofIdx) {
-            // do not consider auxiliary DOFs for the error
-            if (dofIdx >= this->model().numGridDof() || this->model().dofTotalVolume(dofIdx) <= 0.0)
-                continue;
-
-            // also do not consider DOFs which are constraint
-            if (this->enableConstraints_()) {
-                if (constraintsMap.count(dofIdx) > 0)
+        Scalar error = 0;
+        const unsigned numGridDof = this->model().numGridDof();
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        {
+            Scalar threadError = 0;
+#ifdef _OPENMP
+#pragma omp for
+#endif
+            for (unsigned dofIdx = 0; dofIdx < numGridDof; ++dofIdx) {
+                // do not consider DOFs which are constraint
+                if (this->model().dofTotalVolume(dofIdx) <= 0.0 || this->isConstraintDof_(dofIdx))
                     continue;
-            }
 
-            const auto& r = currentResidual[dofIdx];
-            for (unsigned eqIdx = 0; eqIdx < r.size(); ++eqIdx) {
-                if (ncp0EqIdx <= eqIdx && eqIdx < Indices::ncp0EqIdx + numPhases)
-                    continue;
-                this->error_ =
-                    std::max(std::abs(r[eqIdx]*this->model().eqWeight(dofIdx, eqIdx)),
-                             this->error_);
+                const auto& r = residual[dofIdx];
+                for (unsigned eqIdx = 0; eqIdx < r.size(); ++eqIdx) {
+                    if (ncp0EqIdx <= eqIdx && eqIdx < Indices::ncp0EqIdx + numPhases)
+                        continue;
+                    threadError =
+                        std::max(std::abs(r[eqIdx]*this->model().eqWeight(dofIdx, eqIdx)),
+                                 threadError);
+                }
             }
+
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+            error = std::max(threadError, error);
         }
 
         // take the other processes into account
-        this->error_ = this->comm_.max(this->error_);
-
-        // make sure that the error never grows beyond the maximum
-        // allowed one
-        if (this->error_ > EWOMS_GET_PARAM(TypeTag, Scalar, NewtonMaxError))
-            throw Opm::NumericalProblem("Newton: Error "+std::to_string(double(this->error_))+
-                                        + " is larger than maximum allowed error of "
-                                        + std::to_string(double(EWOMS_GET_PARAM(TypeTag, Scalar, NewtonMaxError))));
+        return this->comm_.max(error);
     }
 
     /*!
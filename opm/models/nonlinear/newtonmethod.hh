@@ -30,6 +30,7 @@
 #include "nullconvergencewriter.hh"
 
 #include "newtonmethodproperties.hh"
+#include "sequentialimplicitsystems.hh"
 
 #include <opm/common/Exceptions.hpp>
 
@@ -45,8 +46,16 @@
 #include <dune/common/classname.hh>
 #include <dune/common/parallel/mpihelper.hh>
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <exception>
 #include <iostream>
+#include <limits>
 #include <sstream>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #include <unistd.h>
 
@@ -54,11 +63,51 @@ namespace Opm {
 // forward declaration of classes
 template <class TypeTag>
 class NewtonMethod;
+
+namespace detail {
+//! Detects linear solver backends whose tolerance can be changed at run time.
+template <class LinearSolverBackend, class = void>
+struct HasAdjustableTolerance : std::false_type {};
+
+template <class LinearSolverBackend>
+struct HasAdjustableTolerance<LinearSolverBackend,
+                              std::void_t<decltype(std::declval<LinearSolverBackend&>().setTolerance(0.0))>>
+    : std::true_type {};
+
+//! Detects linear solver backends which can solve with the matrix of the last solve.
+template <class LinearSolverBackend, class = void>
+struct CanKeepMatrix : std::false_type {};
+
+template <class LinearSolverBackend>
+struct CanKeepMatrix<LinearSolverBackend,
+                     std::void_t<decltype(std::declval<LinearSolverBackend&>().keepMatrix())>>
+    : std::true_type {};
+
+//! Detects linearizers which can evaluate the residual without the Jacobian matrix.
+template <class Linearizer, class = void>
+struct HasResidualLinearization : std::false_type {};
+
+template <class Linearizer>
+struct HasResidualLinearization<Linearizer,
+                                std::void_t<decltype(std::declval<Linearizer&>().linearizeResidual())>>
+    : std::true_type {};
+
+//! Yields the index of the pressure primary variable for models whose indices call it
+//! pressure0Idx and -1 for all other models.
+template <class Indices, class = void>
+struct PressureVarIdx : std::integral_constant<int, -1> {};
+
+template <class Indices>
+struct PressureVarIdx<Indices, std::void_t<decltype(Indices::pressure0Idx)>>
+    : std::integral_constant<int, Indices::pressure0Idx> {};
+} // namespace detail
 }
 
-namespace Opm {
+namespace Opm::Properties {
 // forward declaration of property tags
-} // namespace Opm
+template<class TypeTag, class MyTypeTag>
+struct Indices;
+} // namespace Opm::Properties
 
 namespace Opm::Properties {
 
@@ -97,6 +146,40 @@ template<class TypeTag>
 struct NewtonTargetIterations<TypeTag, TTag::NewtonMethod> { static constexpr int value = 10; };
 template<class TypeTag>
 struct NewtonMaxIterations<TypeTag, TTag::NewtonMethod> { static constexpr int value = 20; };
+template<class TypeTag>
+struct NewtonSequentialImplicit<TypeTag, TTag::NewtonMethod> { static constexpr bool value = false; };
+template<class TypeTag>
+struct NewtonSequentialStageIterations<TypeTag, TTag::NewtonMethod> { static constexpr int value = 5; };
+template<class TypeTag>
+struct NewtonSequentialLinearTolerance<TypeTag, TTag::NewtonMethod>
+{
+    using type = GetPropType<TypeTag, Scalar>;
+    static constexpr type value = 1e-4;
+};
+template<class TypeTag>
+struct NewtonSequentialLinearMaxIterations<TypeTag, TTag::NewtonMethod> { static constexpr int value = 500; };
+template<class TypeTag>
+struct NewtonEisenstatWalker<TypeTag, TTag::NewtonMethod> { static constexpr bool value = false; };
+template<class TypeTag>
+struct NewtonMaxLinearTolerance<TypeTag, TTag::NewtonMethod>
+{
+    using type = GetPropType<TypeTag, Scalar>;
+    static constexpr type value = 0.1;
+};
+template<class TypeTag>
+struct NewtonChord<TypeTag, TTag::NewtonMethod> { static constexpr bool value = false; };
+template<class TypeTag>
+struct NewtonChordMaxContraction<TypeTag, TTag::NewtonMethod>
+{
+    using type = GetPropType<TypeTag, Scalar>;
+    static constexpr type value = 0.25;
+};
+template<class TypeTag>
+struct NewtonPredictorOrder<TypeTag, TTag::NewtonMethod> { static constexpr int value = 0; };
+template<class TypeTag>
+struct NewtonLineSearch<TypeTag, TTag::NewtonMethod> { static constexpr bool value = false; };
+template<class TypeTag>
+struct NewtonLineSearchMaxBacktracks<TypeTag, TTag::NewtonMethod> { static constexpr int value = 4; };
 
 } // namespace Opm::Properties
 
@@ -126,6 +209,10 @@ class NewtonMethod
     using LinearSolverBackend = GetPropType<TypeTag, Properties::LinearSolverBackend>;
     using ConvergenceWriter = GetPropType<TypeTag, Properties::NewtonConvergenceWriter>;
 
+    using SequentialSystems = SequentialImplicitSystems<TypeTag>;
+
+    enum { numEq = getPropValue<TypeTag, Properties::NumEq>() };
+
     using Communicator = typename Dune::MPIHelper::MPICommunicator;
     using CollectiveCommunication = typename Dune::Communication<typename Dune::MPIHelper::MPICommunicator>;
 
@@ -136,6 +223,7 @@ public:
         , linearSolver_(simulator)
         , comm_(Dune::MPIHelper::getCommunicator())
         , convergenceWriter_(asImp_())
+        , sequentialSystems_(simulator)
     {
         lastError_ = 1e100;
         error_ = 1e100;
@@ -170,6 +258,40 @@ public:
         EWOMS_REGISTER_PARAM(TypeTag, Scalar, NewtonMaxError,
                              "The maximum error tolerated by the Newton "
                              "method to which does not cause an abort");
+        EWOMS_REGISTER_PARAM(TypeTag, bool, NewtonSequentialImplicit,
+                             "Replace each Newton iteration by a pressure and a "
+                             "transport stage (sequential implicit scheme)");
+        EWOMS_REGISTER_PARAM(TypeTag, int, NewtonSequentialStageIterations,
+                             "The maximum number of iterations of each stage of the "
+                             "sequential implicit scheme");
+        EWOMS_REGISTER_PARAM(TypeTag, Scalar, NewtonSequentialLinearTolerance,
+                             "The relative residual reduction of the linear solver "
+                             "for the pressure and transport systems");
+        EWOMS_REGISTER_PARAM(TypeTag, int, NewtonSequentialLinearMaxIterations,
+                             "The maximum number of iterations of the linear solver "
+                             "for the pressure and transport systems");
+        EWOMS_REGISTER_PARAM(TypeTag, bool, NewtonEisenstatWalker,
+                             "Adapt the tolerance of the linear solver to the "
+                             "convergence of the Newton method");
+        EWOMS_REGISTER_PARAM(TypeTag, Scalar, NewtonMaxLinearTolerance,
+                             "The largest relative tolerance of the linear solver "
+                             "if it is adapted to the convergence of the Newton method");
+        EWOMS_REGISTER_PARAM(TypeTag, bool, NewtonChord,
+                             "Reuse the Jacobian matrix and the preconditioner of the "
+                             "last iteration while the Newton method converges fast");
+        EWOMS_REGISTER_PARAM(TypeTag, Scalar, NewtonChordMaxContraction,
+                             "The largest ratio between the errors of two consecutive "
+                             "iterations for which the Jacobian matrix is reused");
+        EWOMS_REGISTER_PARAM(TypeTag, int, NewtonPredictorOrder,
+                             "The order of the extrapolation of the initial solution of "
+                             "a time step from the last time steps (0: no extrapolation, "
+                             "1: linear, 2: quadratic)");
+        EWOMS_REGISTER_PARAM(TypeTag, bool, NewtonLineSearch,
+                             "Shorten the update of the solution until the error is "
+                             "reduced sufficiently (backtracking line search)");
+        EWOMS_REGISTER_PARAM(TypeTag, int, NewtonLineSearchMaxBacktracks,
+                             "The maximum number of times which the step length of the "
+                             "line search is halved");
     }
 
     /*!
@@ -229,6 +351,17 @@ public:
     void setIterationIndex(int value)
     { numIterations_ = value; }
 
+    /*!
+     * \brief Returns true if the initial solution of the current time step has been
+     *        extrapolated from the solutions of the last time steps.
+     *
+     * In this case, the solution of the first iteration differs from the one of the
+     * last time step, i.e., its storage term must not be recycled as the one of the
+     * last time step.
+     */
+    bool solutionPredicted() const
+    { return predicted_; }
+
     /*!
      * \brief Return the current tolerance at which the Newton method considers itself to
      *        be converged.
@@ -266,12 +399,19 @@ public:
         solveTimer_.halt();
         updateTimer_.halt();
 
+        // the solution at the beginning of an iteration is kept in the model. the
+        // update is written to a second buffer which is then swapped with the
+        // model's solution, so the solution never needs to be copied as a whole.
         SolutionVector& nextSolution = model().solution(/*historyIdx=*/0);
-        SolutionVector currentSolution(nextSolution);
-        GlobalEqVector solutionUpdate(nextSolution.size());
+        if (workSolution_.size() != nextSolution.size()) {
+            workSolution_.resize(nextSolution.size());
+            solutionUpdate_.resize(nextSolution.size());
+        }
 
         Linearizer& linearizer = model().linearizer();
 
+        const bool sequentialImplicit = asImp_().useSequentialImplicit_();
+
         TimerGuard prePostProcessTimerGuard(prePostProcessTimer_);
 
         // tell the implementation that we begin solving
@@ -288,6 +428,11 @@ public:
             // execute the method as long as the implementation thinks
             // that we should do another iteration
             while (asImp_().proceed_()) {
+                // decide whether the Jacobian of the last iteration is reused. this needs
+                // to be done before the implementation is notified about the new
+                // iteration because it may discard the information about the last one.
+                const bool chordStep = asImp_().useChordStep_(sequentialImplicit);
+
                 // linearize the problem at the current solution
 
                 // notify the implementation that we're about to start
@@ -296,9 +441,6 @@ public:
                 asImp_().beginIteration_();
                 prePostProcessTimer_.stop();
 
-                // make the current solution to the old one
-                currentSolution = nextSolution;
-
                 if (asImp_().verbose_()) {
                     std::cout << "Linearize: r(x^k) = dS/dt + div F - q;   M = grad r"
                               << clearRemainingLine
@@ -307,8 +449,14 @@ public:
 
                 // do the actual linearization
                 linearizeTimer_.start();
-                asImp_().linearizeDomain_();
-                asImp_().linearizeAuxiliaryEquations_();
+                if (chordStep) {
+                    asImp_().linearizeResidual_();
+                    endIterMsg() << ", reused Jacobian";
+                }
+                else {
+                    asImp_().linearizeDomain_();
+                    asImp_().linearizeAuxiliaryEquations_();
+                }
                 linearizeTimer_.stop();
 
                 solveTimer_.start();
@@ -323,8 +471,9 @@ public:
                 // something else in addition. TODO: should its costs be counted to
                 // the linearization or to the update?
                 updateTimer_.start();
-                asImp_().preSolve_(currentSolution, residual);
+                asImp_().preSolve_(nextSolution, residual);
                 updateTimer_.stop();
+                lastContraction_ = (numIterations_ > 0 && lastError_ > 0.0) ? error_/lastError_ : 1.0;
 
                 if (!asImp_().proceed_()) {
                     if (asImp_().verbose_() && isatty(fileno(stdout)))
@@ -333,12 +482,33 @@ public:
 
                     // tell the implementation that we're done with this iteration
                     prePostProcessTimer_.start();
-                    asImp_().endIteration_(nextSolution, currentSolution);
+                    asImp_().endIteration_(nextSolution, nextSolution);
                     prePostProcessTimer_.stop();
 
                     break;
                 }
 
+                if (sequentialImplicit) {
+                    // the pressure and transport stages replace the solution of the
+                    // fully implicit system and the update of the solution. afterwards,
+                    // the work buffer holds the solution before the last stage update.
+                    if (!asImp_().solveSequentially_(nextSolution)) {
+                        if (asImp_().verbose_())
+                            std::cout << "Newton: Linear solver did not converge\n" << std::flush;
+
+                        prePostProcessTimer_.start();
+                        asImp_().failed_();
+                        prePostProcessTimer_.stop();
+
+                        return false;
+                    }
+
+                    prePostProcessTimer_.start();
+                    asImp_().endIteration_(nextSolution, workSolution_);
+                    prePostProcessTimer_.stop();
+                    continue;
+                }
+
                 // solve the resulting linear equation system
                 if (asImp_().verbose_()) {
                     std::cout << "Solve: M deltax^k = r"
@@ -349,9 +519,22 @@ public:
                 solveTimer_.start();
                 // solve A x = b, where b is the residual, A is its Jacobian and x is the
                 // update of the solution
-                linearSolver_.setMatrix(jacobian);
-                solutionUpdate = 0.0;
-                bool converged = linearSolver_.solve(solutionUpdate);
+                if constexpr (detail::CanKeepMatrix<LinearSolverBackend>::value) {
+                    if (chordStep)
+                        linearSolver_.keepMatrix();
+                    else
+                        linearSolver_.setMatrix(jacobian);
+                }
+                else
+                    linearSolver_.setMatrix(jacobian);
+                if constexpr (detail::HasAdjustableTolerance<LinearSolverBackend>::value) {
+                    if (EWOMS_GET_PARAM(TypeTag, bool, NewtonEisenstatWalker))
+                        linearSolver_.setTolerance(asImp_().forcingTerm_());
+                }
+                solutionUpdate_ = 0.0;
+                bool converged = linearSolver_.solve(solutionUpdate_);
+                if constexpr (detail::HasAdjustableTolerance<LinearSolverBackend>::value)
+                    countLinearIterations_();
                 solveTimer_.stop();
 
                 if (!converged) {
@@ -373,13 +556,19 @@ public:
                               << std::flush;
                 }
 
-                // update the current solution (i.e. uOld) with the delta
-                // (i.e. u). The result is stored in u
+                // update the current solution (i.e. uOld) with the delta (i.e. u). The
+                // result is stored in the work buffer, which then becomes the model's
+                // solution while the buffer keeps the solution of the last iteration.
                 updateTimer_.start();
-                asImp_().postSolve_(currentSolution,
+                asImp_().postSolve_(nextSolution,
                                     residual,
-                                    solutionUpdate);
-                asImp_().update_(nextSolution, currentSolution, solutionUpdate, residual);
+                                    solutionUpdate_);
+                if (asImp_().useLineSearch_())
+                    asImp_().lineSearch_(nextSolution, residual);
+                else {
+                    asImp_().update_(workSolution_, nextSolution, solutionUpdate_, residual);
+                    std::swap(nextSolution, workSolution_);
+                }
                 updateTimer_.stop();
 
                 if (asImp_().verbose_() && isatty(fileno(stdout)))
@@ -389,7 +578,7 @@ public:
 
                 // tell the implementation that we're done with this iteration
                 prePostProcessTimer_.start();
-                asImp_().endIteration_(nextSolution, currentSolution);
+                asImp_().endIteration_(nextSolution, workSolution_);
                 prePostProcessTimer_.stop();
             }
         }
@@ -442,6 +631,24 @@ public:
                       << updateTimer_.realTimeElapsed() << "("
                       << 100 * updateTimer_.realTimeElapsed()/elapsedTot << "%)"
                       << "\n" << std::flush;
+
+            if (linearIterations_ > 0) {
+                std::cout << "Linear iterations: " << linearIterations_;
+                if (EWOMS_GET_PARAM(TypeTag, bool, NewtonEisenstatWalker))
+                    std::cout << " (about " << static_cast<long>(fixedToleranceIterations_)
+                              << " with the fixed tolerance)";
+                std::cout << "\n" << std::flush;
+            }
+
+            if (EWOMS_GET_PARAM(TypeTag, int, NewtonPredictorOrder) > 0) {
+                const auto average = [](std::size_t iterations, std::size_t steps)
+                { return (steps > 0) ? static_cast<double>(iterations)/steps : 0.0; };
+                std::cout << "Average Newton iterations per time step with/without "
+                          << "extrapolated initial solution: "
+                          << average(predictedIterations_, predictedSteps_) << "/"
+                          << average(unpredictedIterations_, unpredictedSteps_) << "\n"
+                          << std::flush;
+            }
         }
 
 
@@ -500,7 +707,10 @@ public:
      *        equations the next time it is called.
      */
     void eraseMatrix()
-    { linearSolver_.eraseMatrix(); }
+    {
+        linearSolver_.eraseMatrix();
+        sequentialSystems_.reset();
+    }
 
     /*!
      * \brief Returns the linear solver backend object for external use.
@@ -544,6 +754,11 @@ protected:
     void begin_(const SolutionVector&)
     {
         numIterations_ = 0;
+        lastContraction_ = 1.0;
+        linearIterations_ = 0;
+        fixedToleranceIterations_ = 0.0;
+
+        predicted_ = asImp_().predictSolution_();
 
         if (EWOMS_GET_PARAM(TypeTag, bool, NewtonWriteConvergence))
             convergenceWriter_.beginTimeStep();
@@ -592,34 +807,64 @@ protected:
         model().linearizer().finalize();
     }
 
+    /*!
+     * \brief Evaluate the residual of the global non-linear system of equations while
+     *        keeping the Jacobian matrix of the last linearization.
+     */
+    void linearizeResidual_()
+    {
+        if constexpr (detail::HasResidualLinearization<Linearizer>::value)
+            model().linearizer().linearizeResidual();
+    }
+
+    /*!
+     * \brief Returns true if the current iteration only evaluates the residual and
+     *        solves the linear system with the Jacobian matrix and the preconditioner of
+     *        the last iteration (chord method).
+     *
+     * The Jacobian is reused as long as each iteration reduces the error at least by
+     * the factor given by the NewtonChordMaxContraction parameter. It is never reused by
+     * the first iteration of a time step because it depends on the time step size, and
+     * neither if the model features auxiliary equations.
+     */
+    bool useChordStep_([[maybe_unused]] bool sequentialImplicit)
+    {
+        if constexpr (!detail::CanKeepMatrix<LinearSolverBackend>::value
+                      || !detail::HasResidualLinearization<Linearizer>::value)
+            return false;
+        else {
+            if (!EWOMS_GET_PARAM(TypeTag, bool, NewtonChord)
+                || sequentialImplicit
+                || numIterations_ == 0
+                || model().numAuxiliaryModules() > 0
+                || !linearSolver_.canKeepMatrix()
+                || !asImp_().jacobianIsReusable_())
+                return false;
+
+            return lastContraction_ <= EWOMS_GET_PARAM(TypeTag, Scalar, NewtonChordMaxContraction);
+        }
+    }
+
+    /*!
+     * \brief Returns false if the Jacobian matrix of the last iteration must not be
+     *        reused regardless of the convergence rate.
+     *
+     * Models which change the meaning of their primary variables during the update
+     * need to overload this method because the columns of the old Jacobian do not
+     * correspond to the new primary variables.
+     */
+    bool jacobianIsReusable_() const
+    { return true; }
+
     void preSolve_(const SolutionVector&,
                    const GlobalEqVector& currentResidual)
     {
-        const auto& constraintsMap = model().linearizer().constraintsMap();
         lastError_ = error_;
         Scalar newtonMaxError = EWOMS_GET_PARAM(TypeTag, Scalar, NewtonMaxError);
 
-        // calculate the error as the maximum weighted tolerance of
-        // the solution's residual
-        error_ = 0;
-        for (unsigned dofIdx = 0; dofIdx < currentResidual.size(); ++dofIdx) {
-            // do not consider auxiliary DOFs for the error
-            if (dofIdx >= model().numGridDof() || model().dofTotalVolume(dofIdx) <= 0.0)
-                continue;
-
-            // also do not consider DOFs which are constraint
-            if (enableConstraints_()) {
-                if (constraintsMap.count(dofIdx) > 0)
-                    continue;
-            }
-
-            const auto& r = currentResidual[dofIdx];
-            for (unsigned eqIdx = 0; eqIdx < r.size(); ++eqIdx)
-                error_ = max(std::abs(r[eqIdx] * model().eqWeight(dofIdx, eqIdx)), error_);
-        }
+        updateConstraintFlags_();
 
-        // take the other processes into account
-        error_ = comm_.max(error_);
+        error_ = asImp_().residualError_(currentResidual);
 
         // make sure that the error never grows beyond the maximum
         // allowed one
@@ -629,6 +874,45 @@ protected:
                                    + std::to_string(double(newtonMaxError)));
     }
 
+    /*!
+     * \brief Returns the error of a residual.
+     *
+     * The error is the maximum of the weighted residual over all processes. Auxiliary
+     * DOFs and DOFs which are constraint are not considered. Models for which some
+     * equations do not contribute to the error need to overload this method.
+     */
+    Scalar residualError_(const GlobalEqVector& residual) const
+    {
+        Scalar error = 0;
+        const unsigned numGridDof = model().numGridDof();
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        {
+            Scalar threadError = 0;
+#ifdef _OPENMP
+#pragma omp for
+#endif
+            for (unsigned dofIdx = 0; dofIdx < numGridDof; ++dofIdx) {
+                // do not consider DOFs which are constraint
+                if (model().dofTotalVolume(dofIdx) <= 0.0 || isConstraintDof_(dofIdx))
+                    continue;
+
+                const auto& r = residual[dofIdx];
+                for (unsigned eqIdx = 0; eqIdx < r.size(); ++eqIdx)
+                    threadError = max(std::abs(r[eqIdx] * model().eqWeight(dofIdx, eqIdx)), threadError);
+            }
+
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+            error = max(threadError, error);
+        }
+
+        // take the other processes into account
+        return comm_.max(error);
+    }
+
     /*!
      * \brief Update the error of the solution given the previous
      *        iteration.
@@ -700,15 +984,23 @@ protected:
         if (!std::isfinite(solutionUpdate.one_norm()))
             throw NumericalProblem("Non-finite update!");
 
-        size_t numGridDof = model().numGridDof();
+        // the DOFs are updated independently of each other, so this can be done by
+        // multiple threads. exceptions must not leave the parallel region, so they
+        // are passed on afterwards.
+        std::exception_ptr exceptionPtr = nullptr;
+        const unsigned numGridDof = model().numGridDof();
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
         for (unsigned dofIdx = 0; dofIdx < numGridDof; ++dofIdx) {
-            if (enableConstraints_()) {
-                if (constraintsMap.count(dofIdx) > 0) {
-                    const auto& constraints = constraintsMap.at(dofIdx);
+            try {
+                // updatePrimaryVariables_() may only overwrite parts of the primary
+                // variables object, so it must start from the current value
+                nextSolution[dofIdx] = currentSolution[dofIdx];
+                if (isConstraintDof_(dofIdx))
                     asImp_().updateConstraintDof_(dofIdx,
                                                   nextSolution[dofIdx],
-                                                  constraints);
-                }
+                                                  constraintsMap.at(dofIdx));
                 else
                     asImp_().updatePrimaryVariables_(dofIdx,
                                                      nextSolution[dofIdx],
@@ -716,14 +1008,17 @@ protected:
                                                      solutionUpdate[dofIdx],
                                                      currentResidual[dofIdx]);
             }
-            else
-                asImp_().updatePrimaryVariables_(dofIdx,
-                                                 nextSolution[dofIdx],
-                                                 currentSolution[dofIdx],
-                                                 solutionUpdate[dofIdx],
-                                                 currentResidual[dofIdx]);
+            catch (...) {
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+                exceptionPtr = std::current_exception();
+            }
         }
 
+        if (exceptionPtr)
+            std::rethrow_exception(exceptionPtr);
+
         // update the DOFs of the auxiliary equations
         size_t numDof = model().numTotalDof();
         for (size_t dofIdx = numGridDof; dofIdx < numDof; ++dofIdx) {
@@ -753,6 +1048,292 @@ protected:
         nextValue -= update;
     }
 
+    /*!
+     * \brief Returns true if the step length of the current iteration is determined by
+     *        a backtracking line search.
+     *
+     * This requires that the residual can be evaluated without linearizing the
+     * system. Since only the residual of the domain is evaluated, the line search is
+     * not used if the model features auxiliary equations.
+     */
+    bool useLineSearch_() const
+    {
+        if constexpr (!detail::HasResidualLinearization<Linearizer>::value)
+            return false;
+        else
+            return EWOMS_GET_PARAM(TypeTag, bool, NewtonLineSearch)
+                && model().numAuxiliaryModules() == 0;
+    }
+
+    /*!
+     * \brief Update the solution with the largest fraction of the solution update which
+     *        reduces the error sufficiently.
+     *
+     * Starting with the full update, the step length is halved until the error of the
+     * residual at the updated solution satisfies the Armijo condition or until the
+     * maximum number of backtracking steps is reached. The updates are done by
+     * update_(), i.e., all trial solutions obey the limits imposed by the
+     * implementation.
+     *
+     * \param nextSolution The solution at the beginning of the current iteration. On
+     *                     return, it holds the updated solution.
+     * \param currentResidual The residual of the current iteration. Since the trial
+     *                        solutions are evaluated by the linearizer, this reference
+     *                        becomes invalid.
+     */
+    void lineSearch_(SolutionVector& nextSolution, const GlobalEqVector& currentResidual)
+    {
+        // the linearizer overwrites the residual while it evaluates the trial solutions
+        lineSearchResidual_ = currentResidual;
+
+        // the trial solutions need to be the solution of the model, so the solution of
+        // the last iteration is kept by the work buffer
+        std::swap(nextSolution, workSolution_);
+        const SolutionVector& currentSolution = workSolution_;
+
+        // the residuals of the trial solutions are evaluated as if they were the
+        // linearization of the next iteration. in particular, this means that the
+        // storage term of the last time step which has been cached by the first
+        // iteration is not overwritten.
+        const int iterationIdx = numIterations_;
+        const int maxBacktracks = EWOMS_GET_PARAM(TypeTag, int, NewtonLineSearchMaxBacktracks);
+        const Scalar sufficientDecrease = 1e-4;
+
+        asImp_().storeUpdateState_();
+        Scalar stepLength = 1.0;
+        for (int backtrackIdx = 0; ; ++backtrackIdx) {
+            asImp_().update_(nextSolution, currentSolution, solutionUpdate_, lineSearchResidual_);
+
+            // a trial solution for which the residual cannot be evaluated is treated
+            // like one which does not reduce the error
+            Scalar trialError = std::numeric_limits<Scalar>::infinity();
+            numIterations_ = iterationIdx + 1;
+            try {
+                asImp_().linearizeResidual_();
+                trialError = asImp_().residualError_(model().linearizer().residual());
+            }
+            catch (const NumericalProblem&) {
+                if (backtrackIdx >= maxBacktracks)
+                    throw;
+            }
+            numIterations_ = iterationIdx;
+
+            if (asImp_().verbose_())
+                std::cout << "Line search: step length " << stepLength
+                          << " error " << trialError << "\n" << std::flush;
+
+            if (trialError <= (1.0 - sufficientDecrease*stepLength)*error_
+                || backtrackIdx >= maxBacktracks)
+                break;
+
+            asImp_().restoreUpdateState_();
+            stepLength /= 2;
+            solutionUpdate_ *= 0.5;
+        }
+
+        if (stepLength < 1.0)
+            endIterMsg() << ", step length: " << stepLength;
+    }
+
+    /*!
+     * \brief Save the state of the implementation which is modified by update_().
+     *
+     * This is called before the first trial update of the line search.
+     */
+    void storeUpdateState_()
+    { }
+
+    /*!
+     * \brief Revert the state of the implementation to the one saved by
+     *        storeUpdateState_().
+     *
+     * This is called before update_() is called again for the next trial update of the
+     * line search.
+     */
+    void restoreUpdateState_()
+    { }
+
+    /*!
+     * \brief Returns the relative tolerance of the linear solver for the current
+     *        iteration.
+     *
+     * This is the second forcing term of Eisenstat and Walker: The tolerance follows
+     * the square of the reduction of the nonlinear residual of the last iteration, so
+     * the linear system is solved loosely as long as the Newton method is far from the
+     * solution. The safeguards of Eisenstat and Walker prevent the tolerance from
+     * decreasing too fast, and the system is never solved more accurately than
+     * required to reach the Newton tolerance. The result is bounded by the
+     * LinearSolverTolerance and NewtonMaxLinearTolerance parameters.
+     */
+    Scalar forcingTerm_()
+    {
+        const Scalar gamma = 0.9;
+        const Scalar alpha = 2.0;
+        const Scalar minTolerance = EWOMS_GET_PARAM(TypeTag, Scalar, LinearSolverTolerance);
+        const Scalar maxTolerance = std::max(minTolerance,
+                                             EWOMS_GET_PARAM(TypeTag, Scalar, NewtonMaxLinearTolerance));
+
+        Scalar eta = maxTolerance;
+        if (numIterations_ > 0 && lastError_ > 0.0) {
+            eta = gamma*std::pow(error_/lastError_, alpha);
+
+            const Scalar safeguard = gamma*std::pow(linearTolerance_, alpha);
+            if (safeguard > 0.1)
+                eta = std::max(eta, safeguard);
+        }
+
+        if (error_ > 0.0)
+            eta = std::max(eta, 0.5*tolerance_/error_);
+
+        linearTolerance_ = std::clamp(eta, minTolerance, maxTolerance);
+        endIterMsg() << ", linear tolerance: " << linearTolerance_;
+        return linearTolerance_;
+    }
+
+    /*!
+     * \brief Add the iterations of the last linear solve to the statistics.
+     *
+     * For comparison, the number of iterations which would have been required to
+     * reach the fixed tolerance is estimated assuming a constant rate of convergence.
+     */
+    void countLinearIterations_()
+    {
+        const Scalar fixedTolerance = EWOMS_GET_PARAM(TypeTag, Scalar, LinearSolverTolerance);
+        const auto numIterations = linearSolver_.iterations();
+        linearIterations_ += numIterations;
+        if (linearTolerance_ < 1.0 && fixedTolerance < 1.0)
+            fixedToleranceIterations_ += numIterations*std::log(fixedTolerance)/std::log(linearTolerance_);
+        else
+            fixedToleranceIterations_ += numIterations;
+    }
+
+    /*!
+     * \brief Returns the index of the primary variable which is updated by the pressure
+     *        stage of the sequential implicit scheme.
+     *
+     * By default, this is the pressure0Idx primary variable of the model's indices. Models
+     * which call their pressure variable differently need to overload this method, and a
+     * negative value means that the model does not exhibit a pressure primary variable.
+     */
+    int pressureVarIdx_() const
+    { return detail::PressureVarIdx<GetPropType<TypeTag, Properties::Indices>>::value; }
+
+    /*!
+     * \brief Returns true if the sequential implicit scheme ought to be used.
+     *
+     * The scheme requires a pressure primary variable and at least two equations, and it
+     * does not consider auxiliary equations, so the fully implicit scheme is used
+     * otherwise.
+     */
+    bool useSequentialImplicit_()
+    {
+        if (!EWOMS_GET_PARAM(TypeTag, bool, NewtonSequentialImplicit))
+            return false;
+
+        if (numEq > 1
+            && model().numAuxiliaryModules() == 0
+            && asImp_().pressureVarIdx_() >= 0)
+            return true;
+
+        if (!sequentialFallbackReported_ && asImp_().verbose_())
+            std::cout << "Newton: The sequential implicit scheme is not applicable to "
+                      << "this model, using the fully implicit one\n" << std::flush;
+        sequentialFallbackReported_ = true;
+        return false;
+    }
+
+    /*!
+     * \brief Run the pressure and the transport stage of one outer iteration of the
+     *        sequential implicit scheme.
+     *
+     * The linearization of the fully implicit system at the current solution must be
+     * available. Each stage does Newton iterations on its reduced system until the
+     * system is converged or the maximum number of stage iterations is reached. On
+     * return, the work buffer holds the solution before the last stage update.
+     *
+     * \return false if a reduced system could not be solved.
+     */
+    bool solveSequentially_(SolutionVector& nextSolution)
+    {
+        using Stage = typename SequentialSystems::Stage;
+
+        Linearizer& linearizer = model().linearizer();
+        GlobalEqVector& solutionUpdate = solutionUpdate_;
+
+        const int maxStageIterations = EWOMS_GET_PARAM(TypeTag, int, NewtonSequentialStageIterations);
+        const Scalar linearTolerance = EWOMS_GET_PARAM(TypeTag, Scalar, NewtonSequentialLinearTolerance);
+        const int linearMaxIterations = EWOMS_GET_PARAM(TypeTag, int, NewtonSequentialLinearMaxIterations);
+
+        const int iterationIdx = numIterations_;
+        bool linearizationIsCurrent = true;
+        std::array<int, 2> stageIterations = {0, 0};
+        for (Stage stage : {SequentialSystems::pressureStage, SequentialSystems::transportStage}) {
+            int& numStageIterations = stageIterations[stage];
+            while (true) {
+                if (!linearizationIsCurrent) {
+                    // like the trial solutions of the line search, the stage updates
+                    // are linearized as if they were the next iteration, so that the
+                    // cached storage term of the last time step is not overwritten
+                    linearizeTimer_.start();
+                    numIterations_ = iterationIdx + 1;
+                    asImp_().linearizeDomain_();
+                    asImp_().linearizeAuxiliaryEquations_();
+                    numIterations_ = iterationIdx;
+                    linearizeTimer_.stop();
+
+                    solveTimer_.start();
+                    auto& residual = linearizer.residual();
+                    linearSolver_.prepare(linearizer.jacobian(), residual);
+                    linearSolver_.setResidual(residual);
+                    linearSolver_.getResidual(residual);
+                    solveTimer_.stop();
+
+                    linearizationIsCurrent = true;
+                }
+
+                solveTimer_.start();
+                Scalar stageError = sequentialSystems_.assemble(stage,
+                                                                linearizer.jacobian(),
+                                                                linearizer.residual(),
+                                                                asImp_().pressureVarIdx_());
+                solveTimer_.stop();
+                if (stageError <= tolerance() || numStageIterations >= maxStageIterations)
+                    break;
+
+                solveTimer_.start();
+                bool converged = sequentialSystems_.solve(stage,
+                                                          solutionUpdate,
+                                                          asImp_().pressureVarIdx_(),
+                                                          linearTolerance,
+                                                          linearMaxIterations);
+                solveTimer_.stop();
+                if (!converged)
+                    return false;
+
+                // like for the fully implicit scheme, the updated solution is written to
+                // the work buffer which is then swapped with the model's solution
+                updateTimer_.start();
+                asImp_().update_(workSolution_, nextSolution, solutionUpdate, linearizer.residual());
+                std::swap(nextSolution, workSolution_);
+                updateTimer_.stop();
+
+                ++numStageIterations;
+                linearizationIsCurrent = false;
+            }
+        }
+
+        // if no stage changed the solution, the solution of the last iteration is the
+        // current one. this is the only case where the solution needs to be copied.
+        if (stageIterations[SequentialSystems::pressureStage] == 0
+            && stageIterations[SequentialSystems::transportStage] == 0)
+            workSolution_ = nextSolution;
+
+        endIterMsg() << ", pressure/transport iterations: "
+                     << stageIterations[SequentialSystems::pressureStage] << "/"
+                     << stageIterations[SequentialSystems::transportStage];
+        return true;
+    }
+
     /*!
      * \brief Write the convergence behaviour of the newton method to
      *        disk.
@@ -852,7 +1433,153 @@ protected:
      * This method is called _after_ end_()
      */
     void succeeded_()
-    {}
+    {
+        if (EWOMS_GET_PARAM(TypeTag, int, NewtonPredictorOrder) > 0) {
+            if (predicted_) {
+                ++predictedSteps_;
+                predictedIterations_ += static_cast<std::size_t>(numIterations_);
+            }
+            else {
+                ++unpredictedSteps_;
+                unpredictedIterations_ += static_cast<std::size_t>(numIterations_);
+            }
+
+            recordPredictorSolution_();
+        }
+    }
+
+    /*!
+     * \brief Extrapolate the initial solution of the time step from the solutions of the
+     *        last time steps.
+     *
+     * The extrapolation is applied like a Newton update, i.e., the limits which the
+     * implementation imposes on the update of the primary variables of a degree of
+     * freedom are obeyed. Degrees of freedom whose primary variables have changed
+     * their meaning in between the time steps are not extrapolated.
+     *
+     * \return true if the initial solution has been extrapolated.
+     */
+    bool predictSolution_()
+    {
+        const int order = std::min(EWOMS_GET_PARAM(TypeTag, int, NewtonPredictorOrder),
+                                   numPredictorSolutions_);
+        if (order < 1)
+            return false;
+
+        // the solutions of the history must belong to the time steps which directly
+        // precede the current one
+        const Scalar t0 = simulator_.time();
+        const Scalar t = t0 + simulator_.timeStepSize();
+        SolutionVector& solution = model().solution(/*timeIdx=*/0);
+        bool historyIsValid = std::abs(predictorEndTime_ - t0) <= 1e-8*std::max(Scalar(1.0), std::abs(t0));
+        for (int histIdx = 0; histIdx < order; ++histIdx)
+            historyIsValid = historyIsValid && predictorHistory_[histIdx].size() == solution.size();
+        if (!historyIsValid) {
+            numPredictorSolutions_ = 0;
+            return false;
+        }
+
+        // the Lagrange weights of the solutions of the history. the weight of the
+        // current solution is one minus their sum.
+        const Scalar t1 = predictorTimes_[0];
+        std::array<Scalar, 2> weights = {0.0, 0.0};
+        if (order == 1)
+            weights[0] = -(t - t0)/(t0 - t1);
+        else {
+            const Scalar t2 = predictorTimes_[1];
+            weights[0] = (t - t0)*(t - t2)/((t1 - t0)*(t1 - t2));
+            weights[1] = (t - t0)*(t - t1)/((t2 - t0)*(t2 - t1));
+        }
+
+        std::exception_ptr exceptionPtr = nullptr;
+        const unsigned numGridDof = model().numGridDof();
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        {
+            EqVector update;
+            EqVector residual(0.0);
+            PrimaryVariables currentValue;
+#ifdef _OPENMP
+#pragma omp for
+#endif
+            for (unsigned dofIdx = 0; dofIdx < numGridDof; ++dofIdx) {
+                try {
+                    currentValue = solution[dofIdx];
+                    bool compatible = true;
+                    for (int histIdx = 0; histIdx < order; ++histIdx)
+                        compatible = compatible
+                            && asImp_().primaryVariablesCompatible_(currentValue,
+                                                                    predictorHistory_[histIdx][dofIdx]);
+                    if (!compatible)
+                        continue;
+
+                    // the update is subtracted from the current value
+                    for (unsigned pvIdx = 0; pvIdx < numEq; ++pvIdx) {
+                        Scalar delta = 0.0;
+                        for (int histIdx = 0; histIdx < order; ++histIdx)
+                            delta += weights[histIdx]*(predictorHistory_[histIdx][dofIdx][pvIdx]
+                                                       - currentValue[pvIdx]);
+                        update[pvIdx] = -delta;
+                    }
+
+                    asImp_().updatePrimaryVariables_(dofIdx,
+                                                     solution[dofIdx],
+                                                     currentValue,
+                                                     update,
+                                                     residual);
+                }
+                catch (...) {
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+                    exceptionPtr = std::current_exception();
+                }
+            }
+        }
+
+        int succeeded = exceptionPtr ? 0 : 1;
+        succeeded = comm_.min(succeeded);
+        if (!succeeded) {
+            // fall back to the solution of the last time step
+            solution = model().solution(/*timeIdx=*/1);
+            model().invalidateAndUpdateIntensiveQuantities(/*timeIdx=*/0);
+            return false;
+        }
+
+        model().invalidateAndUpdateIntensiveQuantities(/*timeIdx=*/0);
+        return true;
+    }
+
+    /*!
+     * \brief Add the solution at the beginning of the time step which was just
+     *        completed to the history of the extrapolation.
+     */
+    void recordPredictorSolution_()
+    {
+        // the history is only valid if it contains the directly preceding time step
+        if (std::abs(predictorEndTime_ - simulator_.time())
+            > 1e-8*std::max(Scalar(1.0), std::abs(simulator_.time())))
+            numPredictorSolutions_ = 0;
+
+        // recycle the storage of the oldest solution
+        std::swap(predictorHistory_[0], predictorHistory_[1]);
+        std::swap(predictorTimes_[0], predictorTimes_[1]);
+        predictorHistory_[0] = model().solution(/*timeIdx=*/1);
+        predictorTimes_[0] = simulator_.time();
+        predictorEndTime_ = simulator_.time() + simulator_.timeStepSize();
+        numPredictorSolutions_ = std::min(numPredictorSolutions_ + 1, 2);
+    }
+
+    /*!
+     * \brief Returns true if two primary variable objects of a degree of freedom can be
+     *        interpolated, i.e., if their variables have the same meaning.
+     *
+     * Models which switch their primary variables need to overload this method.
+     */
+    bool primaryVariablesCompatible_(const PrimaryVariables&,
+                                     const PrimaryVariables&) const
+    { return true; }
 
     // optimal number of iterations we want to achieve
     int targetIterations_() const
@@ -864,6 +1591,31 @@ protected:
     static bool enableConstraints_()
     { return getPropValue<TypeTag, Properties::EnableConstraints>(); }
 
+    /*!
+     * \brief Update the flags which indicate the constraint degrees of freedom.
+     *
+     * The constraints are determined by the linearization, so this needs to be called
+     * after the system has been linearized. It is done by preSolve_().
+     */
+    void updateConstraintFlags_()
+    {
+        if (!enableConstraints_())
+            return;
+
+        constraintDofFlags_.assign(model().numGridDof(), 0);
+        for (const auto& constraint : model().linearizer().constraintsMap())
+            constraintDofFlags_[constraint.first] = 1;
+    }
+
+    /*!
+     * \brief Returns true if a degree of freedom is constraint.
+     *
+     * In contrast to the constraints map of the linearizer, this can be called
+     * concurrently by multiple threads without looking up a tree.
+     */
+    bool isConstraintDof_(unsigned dofIdx) const
+    { return enableConstraints_() && constraintDofFlags_[dofIdx]; }
+
     Simulator& simulator_;
 
     Timer prePostProcessTimer_;
@@ -877,6 +1629,30 @@ protected:
     Scalar lastError_;
     Scalar tolerance_;
 
+    // the ratio between the error of the current and the one of the last iteration
+    Scalar lastContraction_ = 1.0;
+
+    // the solutions at the beginning of the last time steps and their times, which are
+    // used to extrapolate the initial solution of a time step
+    std::array<SolutionVector, 2> predictorHistory_;
+    std::array<Scalar, 2> predictorTimes_ = {0.0, 0.0};
+    Scalar predictorEndTime_ = 0.0;
+    int numPredictorSolutions_ = 0;
+
+    // the Newton iterations required by the time steps which started with an
+    // extrapolated solution and by the remaining ones
+    bool predicted_ = false;
+    std::size_t predictedSteps_ = 0;
+    std::size_t predictedIterations_ = 0;
+    std::size_t unpredictedSteps_ = 0;
+    std::size_t unpredictedIterations_ = 0;
+
+    // the relative tolerance of the last linear solve and the number of linear
+    // iterations of the current time step if the tolerance is adapted
+    Scalar linearTolerance_ = 1.0;
+    std::size_t linearIterations_ = 0;
+    Scalar fixedToleranceIterations_ = 0.0;
+
     // actual number of iterations done so far
     int numIterations_;
 
@@ -891,6 +1667,23 @@ protected:
     // method to disk
     ConvergenceWriter convergenceWriter_;
 
+    // the pressure and transport systems of the sequential implicit scheme
+    SequentialSystems sequentialSystems_;
+    bool sequentialFallbackReported_ = false;
+
+    // the buffer for the solution which is not currently held by the model and the
+    // update of the solution. they are kept to avoid allocating them for each time
+    // step.
+    SolutionVector workSolution_;
+    GlobalEqVector solutionUpdate_;
+
+    // the residual at the beginning of an iteration while the line search evaluates
+    // the residuals of the trial solutions
+    GlobalEqVector lineSearchResidual_;
+
+    // flags for the degrees of freedom which are constraint
+    std::vector<unsigned char> constraintDofFlags_;
+
 private:
     Implementation& asImp_()
     { return *static_cast<Implementation *>(this); }
@@ -82,6 +82,79 @@ struct NewtonTargetIterations { using type = UndefinedProperty; };
 template<class TypeTag, class MyTypeTag>
 struct NewtonMaxIterations { using type = UndefinedProperty; };
 
+/*!
+ * \brief Specifies whether each Newton iteration is replaced by a pressure stage and a
+ *        transport stage
+ *
+ * In the pressure stage, only the pressure is updated while the remaining primary
+ * variables are kept fixed. In the transport stage, the pressure is kept fixed. The
+ * outer iterations continue until the fully implicit system is converged.
+ */
+template<class TypeTag, class MyTypeTag>
+struct NewtonSequentialImplicit { using type = UndefinedProperty; };
+
+//! The maximum number of iterations of each stage of the sequential implicit scheme
+template<class TypeTag, class MyTypeTag>
+struct NewtonSequentialStageIterations { using type = UndefinedProperty; };
+
+//! The relative residual reduction required from the linear solver of the pressure and
+//! transport systems
+template<class TypeTag, class MyTypeTag>
+struct NewtonSequentialLinearTolerance { using type = UndefinedProperty; };
+
+//! The maximum number of iterations of the linear solver of the pressure and transport
+//! systems
+template<class TypeTag, class MyTypeTag>
+struct NewtonSequentialLinearMaxIterations { using type = UndefinedProperty; };
+
+//! Specifies whether the tolerance of the linear solver should be adapted to the
+//! convergence of the Newton method (Eisenstat-Walker forcing terms)
+template<class TypeTag, class MyTypeTag>
+struct NewtonEisenstatWalker { using type = UndefinedProperty; };
+
+//! The largest relative tolerance which the linear solver is allowed to use if the
+//! tolerance is adapted to the convergence of the Newton method
+template<class TypeTag, class MyTypeTag>
+struct NewtonMaxLinearTolerance { using type = UndefinedProperty; };
+
+/*!
+ * \brief Specifies whether the Jacobian matrix and the preconditioner of the last
+ *        iteration may be reused while the Newton method converges fast (chord method)
+ *
+ * In this case, only the residual is evaluated for the iteration.
+ */
+template<class TypeTag, class MyTypeTag>
+struct NewtonChord { using type = UndefinedProperty; };
+
+//! The largest ratio between the errors of two consecutive iterations for which the
+//! Jacobian matrix is reused by the next iteration
+template<class TypeTag, class MyTypeTag>
+struct NewtonChordMaxContraction { using type = UndefinedProperty; };
+
+/*!
+ * \brief The order of the polynomial which is used to extrapolate the initial solution
+ *        of a time step from the solutions of the last time steps
+ *
+ * 0 means that the solution of the last time step is used as it is, 1 means linear
+ * and 2 quadratic extrapolation.
+ */
+template<class TypeTag, class MyTypeTag>
+struct NewtonPredictorOrder { using type = UndefinedProperty; };
+
+/*!
+ * \brief Specifies whether the update of the solution is shortened until the error is
+ *        reduced sufficiently (backtracking line search)
+ *
+ * The step length is halved until the error of the residual at the updated solution
+ * satisfies the Armijo condition.
+ */
+template<class TypeTag, class MyTypeTag>
+struct NewtonLineSearch { using type = UndefinedProperty; };
+
+//! The maximum number of times which the step length of the line search is halved
+template<class TypeTag, class MyTypeTag>
+struct NewtonLineSearchMaxBacktracks { using type = UndefinedProperty; };
+
 } // end namespace  Opm::Properties
 
 #endif
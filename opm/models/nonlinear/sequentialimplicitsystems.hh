@@ -0,0 +1,388 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \copydoc Opm::SequentialImplicitSystems
+ */
+#ifndef EWOMS_SEQUENTIAL_IMPLICIT_SYSTEMS_HH
+#define EWOMS_SEQUENTIAL_IMPLICIT_SYSTEMS_HH
+
+#include <opm/models/utils/basicproperties.hh>
+#include <opm/models/utils/propertysystem.hh>
+
+#include <opm/simulators/linalg/linalgproperties.hh>
+#include <opm/simulators/linalg/matrixblock.hh>
+#include <opm/simulators/linalg/overlappingbcrsmatrix.hh>
+#include <opm/simulators/linalg/overlappingblockvector.hh>
+#include <opm/simulators/linalg/overlappingoperator.hh>
+#include <opm/simulators/linalg/overlappingpreconditioner.hh>
+#include <opm/simulators/linalg/overlappingscalarproduct.hh>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+#include <dune/istl/preconditioners.hh>
+#include <dune/istl/solvers.hh>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+namespace Opm {
+
+/*!
+ * \ingroup Newton
+ *
+ * \brief Forms and solves the reduced systems of equations of the sequential implicit
+ *        scheme from the fully implicit linearization.
+ *
+ * The pressure system consists of a single equation per degree of freedom. It is a
+ * linear combination of the equations of the degree of freedom whose weights are chosen
+ * such that the derivatives with regard to the local non-pressure primary variables
+ * vanish (quasi-IMPES weights). Only the derivatives with regard to the pressure are
+ * kept.
+ *
+ * The transport system keeps the pressure fixed. It consists of all equations of a
+ * degree of freedom except the one which dominates the pressure equation, and it only
+ * considers the derivatives with regard to the non-pressure primary variables.
+ *
+ * Both systems are solved using the overlapping BiCGStab solver preconditioned by
+ * ILU(0), i.e., they use the same parallelization as the fully implicit system.
+ */
+template <class TypeTag>
+class SequentialImplicitSystems
+{
+    using Scalar = GetPropType<TypeTag, Properties::Scalar>;
+    using Simulator = GetPropType<TypeTag, Properties::Simulator>;
+    using SparseMatrixAdapter = GetPropType<TypeTag, Properties::SparseMatrixAdapter>;
+    using GlobalEqVector = GetPropType<TypeTag, Properties::GlobalEqVector>;
+    using BorderListCreator = GetPropType<TypeTag, Properties::BorderListCreator>;
+
+    enum { numEq = getPropValue<TypeTag, Properties::NumEq>() };
+    enum { numTransportEq = (numEq > 1) ? numEq - 1 : 1 };
+
+    using EqVector = Dune::FieldVector<Scalar, numEq>;
+    using EqMatrix = Dune::FieldMatrix<Scalar, numEq, numEq>;
+
+    // a linear system with a fixed number of equations per degree of freedom and the
+    // overlapping data structures required to solve it in parallel
+    template <int blockSize>
+    class ReducedSystem
+    {
+        using Block = MatrixBlock<Scalar, blockSize, blockSize>;
+        using VectorBlock = Dune::FieldVector<Scalar, blockSize>;
+        using Matrix = Dune::BCRSMatrix<Block>;
+        using OverlappingMatrix = Linear::OverlappingBCRSMatrix<Matrix>;
+        using Overlap = typename OverlappingMatrix::Overlap;
+        using OverlappingVector = Linear::OverlappingBlockVector<VectorBlock, Overlap>;
+
+    public:
+        using Vector = Dune::BlockVector<VectorBlock>;
+
+        // create the matrix using the sparsity pattern of the fully implicit Jacobian
+        template <class IstlMatrix>
+        ReducedSystem(const Simulator& simulator, const IstlMatrix& jacobian)
+            : matrix_(jacobian.N(), jacobian.M(), jacobian.nonzeroes(), Matrix::row_wise)
+            , residual_(jacobian.N())
+            , solution_(jacobian.N())
+        {
+            for (auto row = matrix_.createbegin(); row != matrix_.createend(); ++row)
+                for (auto col = jacobian[row.index()].begin(); col != jacobian[row.index()].end(); ++col)
+                    row.insert(col.index());
+            matrix_ = 0.0;
+
+            BorderListCreator borderListCreator(simulator.gridView(),
+                                                simulator.model().dofMapper());
+            // ILU(0) only requires a single layer of overlap
+            overlappingMatrix_ = std::make_unique<OverlappingMatrix>(matrix_,
+                                                                     borderListCreator.borderList(),
+                                                                     borderListCreator.blackList(),
+                                                                     /*overlapSize=*/1);
+            overlappingb_ = std::make_unique<OverlappingVector>(overlappingMatrix_->overlap());
+            overlappingx_ = std::make_unique<OverlappingVector>(*overlappingb_);
+        }
+
+        Matrix& matrix()
+        { return matrix_; }
+
+        Vector& residual()
+        { return residual_; }
+
+        const Vector& solution() const
+        { return solution_; }
+
+        bool solve(Scalar tolerance, int maxIterations)
+        {
+            overlappingMatrix_->assignFromNative(matrix_);
+            overlappingMatrix_->syncAdd();
+            overlappingb_->assignAddBorder(residual_);
+            (*overlappingx_) = 0.0;
+
+            const auto& overlap = overlappingMatrix_->overlap();
+            using SequentialPreconditioner = Dune::SeqILU<OverlappingMatrix, OverlappingVector, OverlappingVector>;
+            using ParallelPreconditioner = Linear::OverlappingPreconditioner<SequentialPreconditioner, Overlap>;
+            using ParallelScalarProduct = Linear::OverlappingScalarProduct<OverlappingVector, Overlap>;
+            using ParallelOperator = Linear::OverlappingOperator<OverlappingMatrix,
+                                                                 OverlappingVector,
+                                                                 OverlappingVector>;
+
+            SequentialPreconditioner seqPreCond(*overlappingMatrix_, /*relaxation=*/1.0);
+            ParallelPreconditioner parPreCond(seqPreCond, overlap);
+            ParallelScalarProduct parScalarProduct(overlap);
+            ParallelOperator parOperator(*overlappingMatrix_);
+
+            Dune::BiCGSTABSolver<OverlappingVector> solver(parOperator,
+                                                           parScalarProduct,
+                                                           parPreCond,
+                                                           tolerance,
+                                                           maxIterations,
+                                                           /*verbosity=*/0);
+            Dune::InverseOperatorResult result;
+            solver.apply(*overlappingx_, *overlappingb_, result);
+
+            overlappingx_->assignTo(solution_);
+            return result.converged;
+        }
+
+    private:
+        Matrix matrix_;
+        Vector residual_;
+        Vector solution_;
+
+        std::unique_ptr<OverlappingMatrix> overlappingMatrix_;
+        std::unique_ptr<OverlappingVector> overlappingb_;
+        std::unique_ptr<OverlappingVector> overlappingx_;
+    };
+
+public:
+    enum Stage { pressureStage, transportStage };
+
+    explicit SequentialImplicitSystems(const Simulator& simulator)
+        : simulator_(simulator)
+    {}
+
+    /*!
+     * \brief Discard the reduced systems, e.g., because the grid has changed.
+     */
+    void reset()
+    {
+        pressureSystem_.reset();
+        transportSystem_.reset();
+    }
+
+    /*!
+     * \brief Form the reduced system of a stage from the fully implicit Jacobian and
+     *        residual.
+     *
+     * \return The maximum weighted residual of the reduced system.
+     */
+    Scalar assemble(Stage stage,
+                    const SparseMatrixAdapter& jacobian,
+                    const GlobalEqVector& residual,
+                    int pressureVarIdx)
+    {
+        const auto& istlJacobian = jacobian.istlMatrix();
+        if (!pressureSystem_ || pressureSystem_->matrix().N() != istlJacobian.N()) {
+            pressureSystem_ = std::make_unique<ReducedSystem<1>>(simulator_, istlJacobian);
+            transportSystem_ = std::make_unique<ReducedSystem<numTransportEq>>(simulator_, istlJacobian);
+        }
+
+        // the weights of the pressure equation and the equation which it replaces in
+        // the transport system are determined by the current linearization and are
+        // used by both stages
+        if (stage == pressureStage)
+            updateWeights_(istlJacobian, pressureVarIdx);
+
+        return (stage == pressureStage)
+            ? assemblePressure_(istlJacobian, residual, pressureVarIdx)
+            : assembleTransport_(istlJacobian, residual, pressureVarIdx);
+    }
+
+    /*!
+     * \brief Solve the reduced system of a stage and scatter its solution to the
+     *        corresponding entries of a fully implicit update vector.
+     *
+     * The remaining entries of the update vector are set to zero.
+     */
+    bool solve(Stage stage,
+               GlobalEqVector& update,
+               int pressureVarIdx,
+               Scalar tolerance,
+               int maxIterations)
+    {
+        update = 0.0;
+        if (stage == pressureStage) {
+            if (!pressureSystem_->solve(tolerance, maxIterations))
+                return false;
+
+            const auto& x = pressureSystem_->solution();
+            for (std::size_t dofIdx = 0; dofIdx < x.size(); ++dofIdx)
+                update[dofIdx][pressureVarIdx] = x[dofIdx][0];
+        }
+        else {
+            if (!transportSystem_->solve(tolerance, maxIterations))
+                return false;
+
+            const auto& x = transportSystem_->solution();
+            for (std::size_t dofIdx = 0; dofIdx < x.size(); ++dofIdx)
+                for (unsigned i = 0; i < numTransportEq; ++i)
+                    update[dofIdx][transportVarIdx_(i, pressureVarIdx)] = x[dofIdx][i];
+        }
+
+        return true;
+    }
+
+private:
+    // index of the i-th primary variable of the transport system
+    static unsigned transportVarIdx_(unsigned i, int pressureVarIdx)
+    { return (static_cast<int>(i) < pressureVarIdx) ? i : i + 1; }
+
+    // index of the i-th equation of the transport system of a degree of freedom
+    unsigned transportEqIdx_(std::size_t dofIdx, unsigned i) const
+    { return (i < droppedEqIdx_[dofIdx]) ? i : i + 1; }
+
+    template <class IstlMatrix>
+    void updateWeights_(const IstlMatrix& jacobian, int pressureVarIdx)
+    {
+        const auto& model = simulator_.model();
+        std::size_t numDof = jacobian.N();
+        weights_.resize(numDof);
+        droppedEqIdx_.resize(numDof);
+
+        EqVector unitPressure(0.0);
+        unitPressure[pressureVarIdx] = 1.0;
+        for (std::size_t dofIdx = 0; dofIdx < numDof; ++dofIdx) {
+            // solve D^T w = e_p, where D is the diagonal block of the Jacobian. rows of
+            // degrees of freedom which are not linearized by the local process are zero
+            // and get their values from the peer processes.
+            EqVector& w = weights_[dofIdx];
+            EqMatrix diagT;
+            const auto& diag = jacobian[dofIdx][dofIdx];
+            for (unsigned eqIdx = 0; eqIdx < numEq; ++eqIdx)
+                for (unsigned pvIdx = 0; pvIdx < numEq; ++pvIdx)
+                    diagT[pvIdx][eqIdx] = diag[eqIdx][pvIdx];
+
+            try {
+                diagT.solve(w, unitPressure);
+            }
+            catch (const Dune::FMatrixError&) {
+                w = 0.0;
+            }
+
+            // scale the weights such that the residual of the pressure equation is
+            // comparable to the weighted residuals of the fully implicit system
+            Scalar maxWeight = 0.0;
+            droppedEqIdx_[dofIdx] = 0;
+            for (unsigned eqIdx = 0; eqIdx < numEq; ++eqIdx) {
+                Scalar eqWeight = model.eqWeight(dofIdx, eqIdx);
+                Scalar scaledWeight = std::abs(w[eqIdx])/eqWeight;
+                if (scaledWeight > maxWeight) {
+                    maxWeight = scaledWeight;
+                    droppedEqIdx_[dofIdx] = eqIdx;
+                }
+            }
+            if (maxWeight > 0.0 && std::isfinite(maxWeight))
+                w /= maxWeight;
+            else
+                w = 0.0;
+        }
+    }
+
+    template <class IstlMatrix>
+    Scalar assemblePressure_(const IstlMatrix& jacobian,
+                             const GlobalEqVector& residual,
+                             int pressureVarIdx)
+    {
+        auto& matrix = pressureSystem_->matrix();
+        auto& b = pressureSystem_->residual();
+
+        Scalar error = 0.0;
+        for (std::size_t dofIdx = 0; dofIdx < jacobian.N(); ++dofIdx) {
+            const EqVector& w = weights_[dofIdx];
+
+            b[dofIdx] = w*residual[dofIdx];
+            if (isErrorDof_(dofIdx))
+                error = std::max(error, std::abs(b[dofIdx][0]));
+
+            auto destIt = matrix[dofIdx].begin();
+            for (auto srcIt = jacobian[dofIdx].begin(); srcIt != jacobian[dofIdx].end(); ++srcIt, ++destIt) {
+                Scalar value = 0.0;
+                for (unsigned eqIdx = 0; eqIdx < numEq; ++eqIdx)
+                    value += w[eqIdx]*(*srcIt)[eqIdx][pressureVarIdx];
+                (*destIt)[0][0] = value;
+            }
+        }
+
+        return simulator_.gridView().comm().max(error);
+    }
+
+    template <class IstlMatrix>
+    Scalar assembleTransport_(const IstlMatrix& jacobian,
+                              const GlobalEqVector& residual,
+                              int pressureVarIdx)
+    {
+        const auto& model = simulator_.model();
+        auto& matrix = transportSystem_->matrix();
+        auto& b = transportSystem_->residual();
+
+        Scalar error = 0.0;
+        for (std::size_t dofIdx = 0; dofIdx < jacobian.N(); ++dofIdx) {
+            for (unsigned i = 0; i < numTransportEq; ++i) {
+                unsigned eqIdx = transportEqIdx_(dofIdx, i);
+                b[dofIdx][i] = residual[dofIdx][eqIdx];
+                if (isErrorDof_(dofIdx))
+                    error = std::max(error, std::abs(b[dofIdx][i]*model.eqWeight(dofIdx, eqIdx)));
+            }
+
+            auto destIt = matrix[dofIdx].begin();
+            for (auto srcIt = jacobian[dofIdx].begin(); srcIt != jacobian[dofIdx].end(); ++srcIt, ++destIt)
+                for (unsigned i = 0; i < numTransportEq; ++i)
+                    for (unsigned j = 0; j < numTransportEq; ++j)
+                        (*destIt)[i][j] =
+                            (*srcIt)[transportEqIdx_(dofIdx, i)][transportVarIdx_(j, pressureVarIdx)];
+        }
+
+        return simulator_.gridView().comm().max(error);
+    }
+
+    // same criterion as used for the error of the fully implicit system
+    bool isErrorDof_(std::size_t dofIdx) const
+    {
+        const auto& model = simulator_.model();
+        return dofIdx < model.numGridDof() && model.dofTotalVolume(dofIdx) > 0.0;
+    }
+
+    const Simulator& simulator_;
+
+    std::unique_ptr<ReducedSystem<1>> pressureSystem_;
+    std::unique_ptr<ReducedSystem<numTransportEq>> transportSystem_;
+
+    std::vector<EqVector> weights_;
+    std::vector<unsigned> droppedEqIdx_;
+};
+
+} // namespace Opm
+
+#endif
@@ -0,0 +1,153 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \copydoc Opm::forEachElementOfGlobalIndices
+ */
+#ifndef EWOMS_GLOBAL_ELEMENT_INDICES_HH
+#define EWOMS_GLOBAL_ELEMENT_INDICES_HH
+
+#include <dune/grid/common/partitionset.hh>
+#include <dune/grid/common/rangegenerators.hh>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace Opm {
+
+/*!
+ * \brief Calls a functor for the interior elements of the local process which are
+ *        specified by indices that do not depend on the partition of the grid.
+ *
+ * The global index of an element is its position if all elements of the grid are
+ * sorted lexicographically by the coordinates of their centers, where the last
+ * coordinate is the most significant one. For structured grids, this is the cartesian
+ * index of the element, i.e., the index which the element has in a sequential run.
+ * Lists of element indices read from a file thus select the same elements for any
+ * number of processes.
+ *
+ * The functor is called with the position of the index within the globalIndices
+ * argument and the element. Each requested element is visited by exactly one process,
+ * indices which exceed the number of elements of the grid are ignored. The function
+ * must be called collectively with the same list of indices on all processes of the
+ * grid view's communicator. Since the centers of all elements are gathered by the
+ * first process, it is intended to be called once when setting up the output, not
+ * during each time step.
+ */
+template <class GridView, class Functor>
+void forEachElementOfGlobalIndices(const GridView& gridView,
+                                   const std::vector<unsigned>& globalIndices,
+                                   Functor&& functor)
+{
+    enum { dimWorld = GridView::dimensionworld };
+    using Center = std::array<double, dimWorld>;
+
+    const auto centerLess = [](const Center& a, const Center& b)
+    { return std::lexicographical_compare(a.rbegin(), a.rend(), b.rbegin(), b.rend()); };
+
+    const auto centerOf = [](const auto& elem) {
+        const auto& pos = elem.geometry().center();
+        Center center;
+        for (unsigned k = 0; k < dimWorld; ++k)
+            center[k] = pos[k];
+        return center;
+    };
+
+    // gather the centers of all elements on the first process
+    const auto& comm = gridView.comm();
+    std::vector<double> localCenters;
+    for (const auto& elem : elements(gridView, Dune::Partitions::interior)) {
+        const Center center = centerOf(elem);
+        localCenters.insert(localCenters.end(), center.begin(), center.end());
+    }
+
+    int numLocal = static_cast<int>(localCenters.size());
+    std::vector<int> counts(static_cast<std::size_t>(comm.size()), 0);
+    comm.gather(&numLocal, counts.data(), 1, /*root=*/0);
+
+    std::vector<int> displacements(counts.size(), 0);
+    for (std::size_t rank = 1; rank < counts.size(); ++rank)
+        displacements[rank] = displacements[rank - 1] + counts[rank - 1];
+
+    std::vector<double> allCenters;
+    if (comm.rank() == 0)
+        allCenters.resize(static_cast<std::size_t>(displacements.back() + counts.back()));
+    comm.gatherv(localCenters.data(), numLocal, allCenters.data(),
+                 counts.data(), displacements.data(), /*root=*/0);
+
+    // determine the centers of the requested elements and tell all processes about
+    // them. the centers of invalid indices are NaN.
+    std::vector<double> requestedCenters(globalIndices.size()*dimWorld,
+                                         std::numeric_limits<double>::quiet_NaN());
+    if (comm.rank() == 0) {
+        std::vector<Center> sortedCenters(allCenters.size()/dimWorld);
+        for (std::size_t elemIdx = 0; elemIdx < sortedCenters.size(); ++elemIdx)
+            std::copy_n(allCenters.begin() + static_cast<std::ptrdiff_t>(elemIdx*dimWorld),
+                        dimWorld, sortedCenters[elemIdx].begin());
+        std::sort(sortedCenters.begin(), sortedCenters.end(), centerLess);
+
+        for (std::size_t i = 0; i < globalIndices.size(); ++i)
+            if (globalIndices[i] < sortedCenters.size())
+                std::copy(sortedCenters[globalIndices[i]].begin(),
+                          sortedCenters[globalIndices[i]].end(),
+                          requestedCenters.begin() + static_cast<std::ptrdiff_t>(i*dimWorld));
+    }
+    comm.broadcast(requestedCenters.data(), static_cast<int>(requestedCenters.size()), /*root=*/0);
+
+    // the processes which own the requested elements compute exactly the same
+    // centers as the ones which they have sent to the first process
+    std::vector<std::pair<Center, std::size_t>> requested;
+    for (std::size_t i = 0; i < globalIndices.size(); ++i) {
+        if (std::isnan(requestedCenters[i*dimWorld]))
+            continue;
+
+        Center center;
+        std::copy_n(requestedCenters.begin() + static_cast<std::ptrdiff_t>(i*dimWorld),
+                    dimWorld, center.begin());
+        requested.emplace_back(center, i);
+    }
+    const auto requestLess = [&centerLess](const auto& a, const auto& b)
+    { return centerLess(a.first, b.first); };
+    std::sort(requested.begin(), requested.end(), requestLess);
+
+    if (requested.empty())
+        return;
+
+    for (const auto& elem : elements(gridView, Dune::Partitions::interior)) {
+        auto range = std::equal_range(requested.begin(), requested.end(),
+                                      std::make_pair(centerOf(elem), std::size_t(0)),
+                                      requestLess);
+        for (auto it = range.first; it != range.second; ++it)
+            functor(it->second, elem);
+    }
+}
+
+} // namespace Opm
+
+#endif
@@ -0,0 +1,223 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \copydoc Opm::WeightedBisectionPartitioner
+ */
+#ifndef EWOMS_WEIGHTED_BISECTION_PARTITIONER_HH
+#define EWOMS_WEIGHTED_BISECTION_PARTITIONER_HH
+
+#include <dune/common/fvector.hh>
+
+#include <algorithm>
+#include <fstream>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace Opm {
+
+/*!
+ * \brief Partitions the domain into parts of equal cost using recursive coordinate
+ *        bisection.
+ *
+ * The input is a set of points which carry a weight, e.g., the centers of the elements
+ * of a grid and the time which was required to linearize them. The bounding box of the
+ * points is recursively split perpendicular to its longest extent such that the total
+ * weights of both halves are proportional to the number of parts assigned to them. Any
+ * position of the domain can then be mapped to a part, so the points do not need to
+ * correspond to the elements of the grid which is eventually partitioned.
+ */
+template <class Scalar, int dimWorld>
+class WeightedBisectionPartitioner
+{
+public:
+    using GlobalPosition = Dune::FieldVector<Scalar, dimWorld>;
+
+    /*!
+     * \brief Compute the cut planes for a given number of parts.
+     */
+    WeightedBisectionPartitioner(const std::vector<GlobalPosition>& points,
+                                 const std::vector<Scalar>& weights,
+                                 int numParts)
+    {
+        if (points.size() != weights.size())
+            throw std::invalid_argument("The number of points and weights must be identical");
+        if (numParts < 1)
+            throw std::invalid_argument("At least one part is required");
+
+        points_ = points;
+        weights_ = weights;
+
+        // if no cost has been recorded, balance the number of points
+        if (std::accumulate(weights_.begin(), weights_.end(), Scalar(0.0)) <= 0.0)
+            std::fill(weights_.begin(), weights_.end(), Scalar(1.0));
+
+        std::vector<unsigned> pointIdx(points_.size());
+        std::iota(pointIdx.begin(), pointIdx.end(), 0);
+        bisect_(pointIdx.begin(), pointIdx.end(), /*firstPart=*/0, numParts);
+
+        points_.clear();
+        weights_.clear();
+    }
+
+    /*!
+     * \brief Read the weighted points from a text file and compute the partition.
+     *
+     * Each line of the file contains the coordinates of a point followed by its weight.
+     */
+    static WeightedBisectionPartitioner fromFile(const std::string& fileName, int numParts)
+    {
+        std::ifstream costFile(fileName);
+        if (!costFile)
+            throw std::runtime_error("Could not open cost file '"+fileName+"'");
+
+        std::vector<GlobalPosition> points;
+        std::vector<Scalar> weights;
+        GlobalPosition pos;
+        Scalar weight;
+        while (costFile >> pos[0]) {
+            for (int k = 1; k < dimWorld; ++k)
+                costFile >> pos[k];
+            if (!(costFile >> weight))
+                throw std::runtime_error("Incomplete entry in cost file '"+fileName+"'");
+            points.push_back(pos);
+            weights.push_back(weight);
+        }
+
+        return WeightedBisectionPartitioner(points, weights, numParts);
+    }
+
+    /*!
+     * \brief Returns the part to which a position belongs.
+     */
+    int part(const GlobalPosition& pos) const
+    {
+        std::size_t nodeIdx = 0;
+        while (nodes_[nodeIdx].part < 0) {
+            const auto& node = nodes_[nodeIdx];
+            nodeIdx = (pos[node.axis] < node.cut) ? node.left : node.right;
+        }
+        return nodes_[nodeIdx].part;
+    }
+
+private:
+    // a node of the bisection tree. leafs are identified by a non-negative part.
+    struct Node
+    {
+        int part;
+        int axis;
+        Scalar cut;
+        std::size_t left;
+        std::size_t right;
+    };
+
+    using Iterator = std::vector<unsigned>::iterator;
+
+    std::size_t bisect_(Iterator begin, Iterator end, int firstPart, int numParts)
+    {
+        std::size_t nodeIdx = nodes_.size();
+        nodes_.push_back(Node{firstPart, 0, 0.0, 0, 0});
+        if (numParts == 1 || end - begin < 2)
+            return nodeIdx;
+
+        // split perpendicular to the longest extent of the bounding box
+        GlobalPosition lower = points_[*begin];
+        GlobalPosition upper = points_[*begin];
+        for (auto it = begin; it != end; ++it) {
+            for (int k = 0; k < dimWorld; ++k) {
+                lower[k] = std::min(lower[k], points_[*it][k]);
+                upper[k] = std::max(upper[k], points_[*it][k]);
+            }
+        }
+        int axis = 0;
+        for (int k = 1; k < dimWorld; ++k)
+            if (upper[k] - lower[k] > upper[axis] - lower[axis])
+                axis = k;
+
+        std::sort(begin, end, [this, axis](unsigned a, unsigned b)
+                  { return points_[a][axis] < points_[b][axis]; });
+
+        // find the position where the left part gets its share of the total weight
+        int numLeftParts = numParts/2;
+        Scalar totalWeight = 0.0;
+        for (auto it = begin; it != end; ++it)
+            totalWeight += weights_[*it];
+        Scalar leftWeight = totalWeight*numLeftParts/numParts;
+
+        Iterator splitIt = begin;
+        Scalar weight = 0.0;
+        while (splitIt != end - 1 && weight + weights_[*splitIt]/2 < leftWeight) {
+            weight += weights_[*splitIt];
+            ++splitIt;
+        }
+        if (splitIt == begin) {
+            weight += weights_[*splitIt];
+            ++splitIt;
+        }
+
+        // the cut plane must not separate points which exhibit the same coordinate, so
+        // move the split to the nearest position where the coordinate changes
+        const auto coord = [this, axis](Iterator it) { return points_[*it][axis]; };
+        if (coord(splitIt - 1) == coord(splitIt)) {
+            Iterator lowIt = splitIt;
+            Scalar lowWeight = weight;
+            while (lowIt != begin && coord(lowIt - 1) == coord(lowIt)) {
+                --lowIt;
+                lowWeight -= weights_[*lowIt];
+            }
+
+            Iterator highIt = splitIt;
+            Scalar highWeight = weight;
+            while (highIt != end && coord(highIt - 1) == coord(highIt)) {
+                highWeight += weights_[*highIt];
+                ++highIt;
+            }
+
+            bool lowValid = lowIt != begin;
+            bool highValid = highIt != end;
+            if (lowValid && (!highValid || leftWeight - lowWeight <= highWeight - leftWeight))
+                splitIt = lowIt;
+            else if (highValid)
+                splitIt = highIt;
+        }
+
+        Scalar cut = (points_[*(splitIt - 1)][axis] + points_[*splitIt][axis])/2;
+
+        std::size_t left = bisect_(begin, splitIt, firstPart, numLeftParts);
+        std::size_t right = bisect_(splitIt, end, firstPart + numLeftParts, numParts - numLeftParts);
+
+        nodes_[nodeIdx] = Node{-1, axis, cut, left, right};
+        return nodeIdx;
+    }
+
+    std::vector<GlobalPosition> points_;
+    std::vector<Scalar> weights_;
+    std::vector<Node> nodes_;
+};
+
+} // namespace Opm
+
+#endif
@@ -130,6 +130,19 @@ protected:
         this->problem().model().switchPrimaryVars_();
     }
 
+    /*!
+     * \copydoc NewtonMethod::jacobianIsReusable_
+     */
+    bool jacobianIsReusable_() const
+    { return !this->problem().model().switched(); }
+
+    /*!
+     * \copydoc NewtonMethod::primaryVariablesCompatible_
+     */
+    bool primaryVariablesCompatible_(const PrimaryVariables& a,
+                                     const PrimaryVariables& b) const
+    { return a.phasePresence() == b.phasePresence(); }
+
     void clampValue_(Scalar& val, Scalar minVal, Scalar maxVal) const
     { val = std::max(minVal, std::min(val, maxVal)); }
 };
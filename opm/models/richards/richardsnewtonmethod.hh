@@ -71,6 +71,12 @@ protected:
     friend NewtonMethod<TypeTag>;
     friend ParentType;
 
+    /*!
+     * \copydoc NewtonMethod::pressureVarIdx_
+     */
+    int pressureVarIdx_() const
+    { return pressureWIdx; }
+
     /*!
      * \copydoc FvBaseNewtonMethod::updatePrimaryVariables_
      */
@@ -164,6 +164,14 @@ struct CellsZ { using type = UndefinedProperty; };
 template<class TypeTag, class MyTypeTag>
 struct GridFile { using type = UndefinedProperty; };
 
+//! store the grid read from the grid file in a binary cache and load it from there
+template<class TypeTag, class MyTypeTag>
+struct EnableGridCache { using type = UndefinedProperty; };
+
+//! file with the linearization cost of the elements used to balance the load
+template<class TypeTag, class MyTypeTag>
+struct LoadBalanceCostFile { using type = UndefinedProperty; };
+
 //! level of the grid view
 template<class TypeTag, class MyTypeTag>
 struct GridViewLevel { using type = UndefinedProperty; };
@@ -210,6 +218,14 @@ struct ModelParameterGroup<TypeTag, TTag::NumericModel> { static constexpr auto
 template<class TypeTag>
 struct GridFile<TypeTag, TTag::NumericModel> { static constexpr auto value = ""; };
 
+//! Parse the grid file on every run by default
+template<class TypeTag>
+struct EnableGridCache<TypeTag, TTag::NumericModel> { static constexpr bool value = false; };
+
+//! Use the default load balancing of the grid by default
+template<class TypeTag>
+struct LoadBalanceCostFile<TypeTag, TTag::NumericModel> { static constexpr auto value = ""; };
+
 #if HAVE_DUNE_FEM
 template<class TypeTag>
 struct GridPart<TypeTag, TTag::NumericModel>
@@ -263,6 +263,9 @@ public:
         EWOMS_REGISTER_PARAM(TypeTag, std::string, PredeterminedTimeStepsFile,
                              "A file with a list of predetermined time step sizes (one "
                              "time step per line)");
+        EWOMS_REGISTER_PARAM(TypeTag, std::string, LoadBalanceCostFile,
+                             "A file with the linearization cost of the elements of a "
+                             "previous run which is used to distribute the grid");
 
         Vanguard::registerParameters();
         Model::registerParameters();
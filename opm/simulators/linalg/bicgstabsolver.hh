@@ -114,8 +114,19 @@ public:
     void setRhs(const Vector* b)
     { b_ = b; }
 
+    /*!
+     * \brief Specify whether the initial solution is the zero vector.
+     *
+     * In this case, the initial residual is the right hand side and the solver does not
+     * need to multiply the initial solution with the matrix.
+     */
+    void setInitialGuessZero(bool value)
+    { initialGuessZero_ = value; }
+
     /*!
      * \brief Run the stabilized BiCG solver and store the result into the "x" vector.
+     *
+     * The value of "x" when this method is called is used as the initial solution.
      */
     bool apply(Vector& x)
     {
@@ -135,26 +146,14 @@ public:
         // See https://en.wikipedia.org/wiki/Biconjugate_gradient_stabilized_method,
         // (article date: December 19, 2016)
 
-        // set the initial solution to the zero vector
-        x = 0.0;
-
-        // prepare the preconditioner. to allow some optimizations, we assume that the
-        // preconditioner does not change the initial solution x if the initial solution
-        // is a zero vector.
+        // the value of x when this method is called is the initial solution. prepare
+        // the preconditioner for it.
         Vector r = *b_;
         preconditioner_.pre(x, r);
 
-#ifndef NDEBUG
-        // ensure that the preconditioner does not change the initial solution. since
-        // this is a debugging check, we don't care if it does not work properly in
-        // parallel. (because this goes wrong, it should be considered to be a bug in the
-        // code anyway.)
-        for (unsigned i = 0; i < x.size(); ++i) {
-            const auto& u = x[i];
-            if (u*u != 0.0)
-                throw std::logic_error("The preconditioner is assumed not to modify the initial solution!");
-        }
-#endif // NDEBUG
+        // r0 = b - Ax (i.e., r0 = b if x_0 == 0)
+        if (!initialGuessZero_)
+            A_->applyscaleadd(/*alpha=*/-1.0, x, r);
 
         convergenceCriterion_.setInitial(x, r);
         if (convergenceCriterion_.converged()) {
@@ -167,11 +166,8 @@ public:
             convergenceCriterion_.printInitial();
         }
 
-        // r0 = b - Ax (i.e., r -= A*x_0 = b, because x_0 == 0)
-        //A_->applyscaleadd(/*alpha=*/-1.0, x, r);
-
         // r0hat = r0
-        const Vector& r0hat = *b_;
+        const Vector r0hat(r);
 
         // rho0 = alpha = omega0 = 1
         Scalar rho = 1.0;
@@ -208,6 +204,12 @@ public:
             //
             // p_i = r_(i-1) + beta*(p_(i-1) - omega_(i-1)*v_(i-1))
             // y = p
+            //
+            // like all vector updates of this method, it is distributed over the
+            // threads because each entry is updated independently.
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
             for (unsigned i = 0; i < n; ++i) {
                 // p_i = r_(i-1) + beta*(p_(i-1) - omega_(i-1)*v_(i-1))
                 auto tmp = v[i];
@@ -237,6 +239,9 @@ public:
 
             // h = x_(i-1) + alpha*y
             // s = r_(i-1) - alpha*v_i
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
             for (unsigned i = 0; i < n; ++i) {
                 auto tmp = y[i];
                 tmp *= alpha;
@@ -276,11 +281,11 @@ public:
                 convergenceCriterion_.print(report_.iterations() + 0.5);
 
             // z = K^-1*s
-            z = s;
+            copy_(z, s);
             preconditioner_.apply(z, s);
 
-            // t = Az
-            t = z;
+            // t = Az; t does not need to be initialized because the operator
+            // overwrites it
             A_->apply(z, t);
 
             // omega_i = (t*s)/(t*t)
@@ -293,7 +298,7 @@ public:
 
             // x_i = h + omega_i*z
             // x = h; // not necessary because x and h are the same object
-            x.axpy(/*a=*/omega, /*y=*/z);
+            axpy_(x, omega, z);
 
             // do convergence check and print terminal output
             convergenceCriterion_.update(/*curSol=*/x, /*delta=*/z, r);
@@ -322,7 +327,7 @@ public:
 
             // r_i = s - omega*t
             // r = s; // not necessary because r and s are the same object
-            r.axpy(/*a=*/-omega, /*y=*/t);
+            axpy_(r, -omega, t);
         }
 
         report_.setConverged(false);
@@ -338,6 +343,28 @@ public:
     { return report_; }
 
 private:
+    // x = y
+    static void copy_(Vector& x, const Vector& y)
+    {
+        const unsigned n = x.size();
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (unsigned i = 0; i < n; ++i)
+            x[i] = y[i];
+    }
+
+    // x = x + a*y
+    static void axpy_(Vector& x, Scalar a, const Vector& y)
+    {
+        const unsigned n = x.size();
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (unsigned i = 0; i < n; ++i)
+            x[i].axpy(a, y[i]);
+    }
+
     const LinearOperator* A_;
     const Vector* b_;
 
@@ -348,6 +375,7 @@ private:
 
     unsigned maxIterations_;
     unsigned verbosity_;
+    bool initialGuessZero_ = false;
 };
 
 } // namespace Linear
@@ -61,12 +61,17 @@ public:
     /*!
      * \brief Constructs the foreign overlap given a BCRS matrix and
      *        an initial list of border indices.
+     *
+     * If the sequence of all native indices is given by 'nativeOrder', the local
+     * domestic indices are numbered in this order. Otherwise, they are numbered in the
+     * order of the native ones.
      */
     template <class BCRSMatrix>
     DomesticOverlapFromBCRSMatrix(const BCRSMatrix& A,
                                   const BorderList& borderList,
                                   const BlackList& blackList,
-                                  unsigned overlapSize)
+                                  unsigned overlapSize,
+                                  const std::vector<Index>& nativeOrder = {})
         : foreignOverlap_(A, borderList, blackList, overlapSize)
         , blackList_(blackList)
         , globalIndices_(foreignOverlap_)
@@ -84,6 +89,7 @@ public:
 
         buildDomesticOverlap_();
         updateMasterRanks_();
+        setupOrdering_(nativeOrder);
         blackList_.updateNativeToDomesticMap(*this);
 
         setupDebugMapping_();
@@ -453,12 +459,14 @@ protected:
         // indices stemming from the overlap (i.e. without the border
         // indices)
         size_t numIndices = foreignOverlap.size();
-        numIndicesSendBuffer_[peerRank] = new MpiBuffer<size_t>(1);
-        (*numIndicesSendBuffer_[peerRank])[0] = numIndices;
-        numIndicesSendBuffer_[peerRank]->send(peerRank);
+        auto& numIndicesSendBuffer = numIndicesSendBuffer_[peerRank];
+        numIndicesSendBuffer.resize(1);
+        numIndicesSendBuffer[0] = numIndices;
+        numIndicesSendBuffer.send(peerRank);
 
         // create MPI buffers
-        indicesSendBuffer_[peerRank] = new MpiBuffer<IndexDistanceNpeers>(numIndices);
+        auto& indicesSendBuffer = indicesSendBuffer_[peerRank];
+        indicesSendBuffer.resize(numIndices);
 
         // then send the additional indices themselfs
         auto overlapIt = foreignOverlap.begin();
@@ -473,20 +481,20 @@ protected:
             tmp.borderDistance = borderDistance;
             tmp.numPeers = static_cast<unsigned>(numPeers);
 
-            (*indicesSendBuffer_[peerRank])[i] = tmp;
+            indicesSendBuffer[i] = tmp;
         }
 
-        indicesSendBuffer_[peerRank]->send(peerRank);
+        indicesSendBuffer.send(peerRank);
 #endif // HAVE_MPI
     }
 
     void waitSendIndices_(ProcessRank peerRank)
     {
-        numIndicesSendBuffer_[peerRank]->wait();
-        delete numIndicesSendBuffer_[peerRank];
+        numIndicesSendBuffer_[peerRank].wait();
+        numIndicesSendBuffer_.erase(peerRank);
 
-        indicesSendBuffer_[peerRank]->wait();
-        delete indicesSendBuffer_[peerRank];
+        indicesSendBuffer_[peerRank].wait();
+        indicesSendBuffer_.erase(peerRank);
     }
 
     void receiveIndicesFromPeer_([[maybe_unused]] ProcessRank peerRank)
@@ -501,6 +509,9 @@ protected:
         // receive the additional indices themselfs
         MpiBuffer<IndexDistanceNpeers> recvBuff(static_cast<size_t>(numIndices));
         recvBuff.receive(peerRank);
+
+        auto& overlapWithPeer = domesticOverlapWithPeer_[peerRank];
+        overlapWithPeer.reserve(overlapWithPeer.size() + static_cast<size_t>(numIndices));
         for (unsigned i = 0; i < static_cast<unsigned>(numIndices); ++i) {
             Index globalIdx = recvBuff[i].index;
             BorderDistance borderDistance = recvBuff[i].borderDistance;
@@ -521,7 +532,7 @@ protected:
 
             // extend the domestic overlap
             domesticOverlapByIndex_[static_cast<unsigned>(domesticIdx)][static_cast<unsigned>(peerRank)] = borderDistance;
-            domesticOverlapWithPeer_[static_cast<unsigned>(peerRank)].push_back(domesticIdx);
+            overlapWithPeer.push_back(domesticIdx);
 
             //assert(borderDistance >= 0);
             assert(globalIdx >= 0);
@@ -534,6 +545,34 @@ protected:
 #endif // HAVE_MPI
     }
 
+    // number the local indices in the order of the native ones given by 'nativeOrder'.
+    // the remaining domestic indices are not reordered, i.e., the local indices stay
+    // in front of them.
+    void setupOrdering_(const std::vector<Index>& nativeOrder)
+    {
+        if (nativeOrder.size() != numNative())
+            return;
+
+        const size_t nLocal = numLocal();
+        const size_t nDomestic = numDomestic();
+        internalToExternal_.resize(nDomestic);
+        externalToInternal_.resize(nDomestic);
+
+        Index externalIdx = 0;
+        for (Index nativeIdx : nativeOrder) {
+            Index localIdx = foreignOverlap_.nativeToLocal(nativeIdx);
+            if (localIdx < 0)
+                continue;
+            internalToExternal_[static_cast<unsigned>(localIdx)] = externalIdx++;
+        }
+        assert(externalIdx == static_cast<Index>(nLocal));
+
+        for (size_t i = nLocal; i < nDomestic; ++i)
+            internalToExternal_[i] = static_cast<Index>(i);
+        for (size_t i = 0; i < nDomestic; ++i)
+            externalToInternal_[static_cast<unsigned>(internalToExternal_[i])] = static_cast<Index>(i);
+    }
+
     // this method is intended to set up the code mapping code for
     // mapping domestic indices to the same ones used by a sequential
     // grid. this requires detailed knowledge about how a grid
@@ -546,19 +585,25 @@ protected:
     void setupDebugMapping_()
     {}
 
-    // this method is intended to map domestic indices to the ones
-    // used by a sequential grid.
+    // map the indices used internally, i.e., those of the foreign overlap and the
+    // global indices, to the domestic indices which are exposed.
     //
-    // by default, this method does nothing
+    // by default, this is the identity. if an ordering has been specified, the local
+    // indices are permuted accordingly.
     Index mapInternalToExternal_(Index internalIdx) const
-    { return internalIdx; }
+    {
+        if (internalToExternal_.empty() || internalIdx < 0)
+            return internalIdx;
+        return internalToExternal_[static_cast<unsigned>(internalIdx)];
+    }
 
-    // this method is intended to map the indices used by a sequential
-    // to grid domestic indices ones.
-    //
-    // by default, this method does nothing
+    // map the exposed domestic indices to the ones used internally.
     Index mapExternalToInternal_(Index externalIdx) const
-    { return externalIdx; }
+    {
+        if (externalToInternal_.empty() || externalIdx < 0)
+            return externalIdx;
+        return externalToInternal_[static_cast<unsigned>(externalIdx)];
+    }
 
     ProcessRank myRank_;
     unsigned worldSize_;
@@ -571,10 +616,14 @@ protected:
     std::vector<BorderDistance> borderDistance_;
     std::vector<ProcessRank> masterRank_;
 
-    std::map<ProcessRank, MpiBuffer<size_t> *> numIndicesSendBuffer_;
-    std::map<ProcessRank, MpiBuffer<IndexDistanceNpeers> *> indicesSendBuffer_;
+    std::map<ProcessRank, MpiBuffer<size_t> > numIndicesSendBuffer_;
+    std::map<ProcessRank, MpiBuffer<IndexDistanceNpeers> > indicesSendBuffer_;
     GlobalIndices globalIndices_;
     PeerSet peerSet_;
+
+    // the permutation of the domestic indices (empty if they are not reordered)
+    std::vector<Index> internalToExternal_;
+    std::vector<Index> externalToInternal_;
 };
 
 } // namespace Linear
@@ -40,6 +40,7 @@
 #include <algorithm>
 #include <iostream>
 #include <map>
+#include <tuple>
 #include <vector>
 
 #if HAVE_MPI
@@ -90,6 +91,7 @@ public:
 
         // calculate the set of local indices on the border (beware:
         // _not_ the native ones)
+        isLocalBorderIndex_.resize(numLocal_, 0);
         auto it = borderList.begin();
         const auto& endIt = borderList.end();
         for (; it != endIt; ++it) {
@@ -97,9 +99,13 @@ public:
             if (localIdx < 0)
                 continue;
 
-            localBorderIndices_.insert(localIdx);
+            isLocalBorderIndex_[static_cast<unsigned>(localIdx)] = 1;
         }
 
+        // create a sorted array of the border indices which allows to
+        // quickly find the index of a border entity on the peer process
+        createPeerIndices_();
+
         // compute the set of processes which are neighbors of the
         // local process ...
         neighborPeerSet_.update(borderList);
@@ -147,7 +153,11 @@ public:
      * \brief Returns true iff a local index is a border index.
      */
     bool isBorder(Index localIdx) const
-    { return localBorderIndices_.count(localIdx) > 0; }
+    {
+        return localIdx >= 0
+            && static_cast<size_t>(localIdx) < isLocalBorderIndex_.size()
+            && isLocalBorderIndex_[static_cast<unsigned>(localIdx)] != 0;
+    }
 
     /*!
      * \brief Returns true iff a local index is a border index shared with a
@@ -400,21 +410,9 @@ protected:
                 else if (foreignOverlapByLocalIndex_[static_cast<unsigned>(localColIdx)].count(peerRank) > 0)
                     continue;
 
-                // check whether the new index is already in the overlap
-                bool hasIndex = false;
-                typename SeedList::iterator sIt = nextSeedList.begin();
-                typename SeedList::iterator sEndIt = nextSeedList.end();
-                for (; sIt != sEndIt; ++sIt) {
-                    if (sIt->index == nativeColIdx && sIt->peerRank == peerRank) {
-                        hasIndex = true;
-                        break;
-                    }
-                }
-                if (hasIndex)
-                    continue; // we already have this index
-
                 // add the current processes to the seed list for the
-                // next overlap level
+                // next overlap level. indices which are added more than
+                // once are removed below.
                 IndexRankDist newTuple;
                 newTuple.index = nativeColIdx;
                 newTuple.peerRank = peerRank;
@@ -422,6 +420,7 @@ protected:
                 nextSeedList.push_back(newTuple);
             }
         }
+        removeDuplicateSeeds_(nextSeedList);
 
         // clear the old seed list to save some memory
         seedList.clear();
@@ -451,16 +450,53 @@ protected:
         numLocal_ = localToNativeIndices_.size();
     }
 
-    Index localToPeerIdx_(Index localIdx, ProcessRank peerRank) const
+    // sort the (local index, peer rank, peer index) tuples of the
+    // border list, so that localToPeerIdx_() does not need to search
+    // the whole list
+    void createPeerIndices_()
     {
+        peerIndices_.clear();
+        peerIndices_.reserve(borderList_.size());
         auto it = borderList_.begin();
         const auto& endIt = borderList_.end();
-        for (; it != endIt; ++it) {
-            if (it->localIdx == localIdx && it->peerRank == peerRank)
-                return it->peerIdx;
-        }
+        for (; it != endIt; ++it)
+            peerIndices_.push_back(*it);
+
+        // the sort is stable, so the first matching entry of the
+        // border list is found for duplicates
+        std::stable_sort(peerIndices_.begin(), peerIndices_.end(),
+                         [](const BorderIndex& a, const BorderIndex& b)
+                         {
+                             return std::tie(a.localIdx, a.peerRank)
+                                 < std::tie(b.localIdx, b.peerRank);
+                         });
+    }
 
-        return -1;
+    Index localToPeerIdx_(Index localIdx, ProcessRank peerRank) const
+    {
+        auto it = std::lower_bound(peerIndices_.begin(), peerIndices_.end(),
+                                   std::make_tuple(localIdx, peerRank),
+                                   [](const BorderIndex& a, const std::tuple<Index, ProcessRank>& b)
+                                   { return std::tie(a.localIdx, a.peerRank) < b; });
+        if (it == peerIndices_.end() || it->localIdx != localIdx || it->peerRank != peerRank)
+            return -1;
+
+        return it->peerIdx;
+    }
+
+    // remove all entries of a seed list which refer to the same index
+    // and peer rank as an earlier entry
+    static void removeDuplicateSeeds_(SeedList& seedList)
+    {
+        const auto lessFn =
+            [](const IndexRankDist& a, const IndexRankDist& b)
+            { return std::tie(a.peerRank, a.index) < std::tie(b.peerRank, b.index); };
+        const auto equalFn =
+            [](const IndexRankDist& a, const IndexRankDist& b)
+            { return a.peerRank == b.peerRank && a.index == b.index; };
+
+        std::stable_sort(seedList.begin(), seedList.end(), lessFn);
+        seedList.erase(std::unique(seedList.begin(), seedList.end(), equalFn), seedList.end());
     }
 
     template <class BCRSMatrix>
@@ -575,19 +611,8 @@ protected:
                 if (distIt != foreignOverlapByLocalIndex_[static_cast<unsigned>(localIdx)].end())
                     continue;
 
-                // make sure the index is not already in the seed list
-                bool inSeedList = false;
-                auto seedIt = seedList.begin();
-                const auto& seedEndIt = seedList.end();
-                for (; seedIt != seedEndIt; ++seedIt) {
-                    if (seedIt->index == localIdx && seedIt->peerRank == peerRank) {
-                        inSeedList = true;
-                        break;
-                    }
-                }
-                if (inSeedList)
-                    continue;
-
+                // indices which are already in the seed list are removed
+                // after all peers have been processed
                 IndexRankDist seedEntry;
                 seedEntry.index = localIdx;
                 seedEntry.peerRank = peerRank;
@@ -599,6 +624,8 @@ protected:
             }
         }
 
+        removeDuplicateSeeds_(seedList);
+
         // make sure all data was send
         peerIt = neighborPeerSet().begin();
         for (; peerIt != peerEndIt; ++peerIt) {
@@ -679,9 +706,12 @@ protected:
     // index
     std::vector<ProcessRank> masterRank_;
 
-    // set of all local indices which are on the border of some remote
-    // process
-    std::set<Index> localBorderIndices_;
+    // specifies for each local index whether it is on the border of
+    // some remote process
+    std::vector<unsigned char> isLocalBorderIndex_;
+
+    // the entries of the border list sorted by local index and peer rank
+    std::vector<BorderIndex> peerIndices_;
 
     // stores the set of process ranks which are in the overlap for a
     // given row index "owned" by the current rank. The second value
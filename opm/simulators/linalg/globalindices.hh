@@ -33,10 +33,10 @@
 #include <dune/istl/operators.hh>
 
 #include <algorithm>
-#include <set>
-#include <map>
 #include <iostream>
 #include <tuple>
+#include <unordered_map>
+#include <vector>
 
 #if HAVE_MPI
 #include <mpi.h>
@@ -56,8 +56,8 @@ class GlobalIndices
 {
     GlobalIndices(const GlobalIndices& ) = delete;
 
-    using GlobalToDomesticMap = std::map<Index, Index>;
-    using DomesticToGlobalMap = std::map<Index, Index>;
+    using GlobalToDomesticMap = std::unordered_map<Index, Index>;
+    using DomesticToGlobalMap = std::vector<Index>;
 
 public:
     GlobalIndices(const ForeignOverlap& foreignOverlap)
@@ -87,9 +87,10 @@ public:
      */
     Index domesticToGlobal(Index domesticIdx) const
     {
-        assert(domesticToGlobal_.find(domesticIdx) != domesticToGlobal_.end());
+        assert(static_cast<size_t>(domesticIdx) < domesticToGlobal_.size());
+        assert(domesticToGlobal_[static_cast<size_t>(domesticIdx)] >= 0);
 
-        return domesticToGlobal_.find(domesticIdx)->second;
+        return domesticToGlobal_[static_cast<size_t>(domesticIdx)];
     }
 
     /*!
@@ -126,11 +127,13 @@ public:
      */
     void addIndex(Index domesticIdx, Index globalIdx)
     {
-        domesticToGlobal_[domesticIdx] = globalIdx;
+        // the local indices are not added in ascending order, so the array may
+        // temporarily contain some holes
+        if (static_cast<size_t>(domesticIdx) >= domesticToGlobal_.size())
+            domesticToGlobal_.resize(static_cast<size_t>(domesticIdx) + 1, -1);
+        domesticToGlobal_[static_cast<size_t>(domesticIdx)] = globalIdx;
         globalToDomestic_[globalIdx] = domesticIdx;
-        numDomestic_ = domesticToGlobal_.size();
-
-        assert(domesticToGlobal_.size() == globalToDomestic_.size());
+        numDomestic_ = globalToDomestic_.size();
     }
 
     /*!
@@ -192,9 +195,11 @@ public:
         std::cout << "(domestic index, global index, domestic->global->domestic)"
                   << " list for rank " << myRank_ << "\n";
 
-        for (size_t domIdx = 0; domIdx < domesticToGlobal_.size(); ++domIdx)
-            std::cout << "(" << domIdx << ", " << domesticToGlobal(domIdx)
-                      << ", " << globalToDomestic(domesticToGlobal(domIdx)) << ") ";
+        for (size_t domIdx = 0; domIdx < domesticToGlobal_.size(); ++domIdx) {
+            Index globalIdx = domesticToGlobal_[domIdx];
+            std::cout << "(" << domIdx << ", " << globalIdx
+                      << ", " << globalToDomestic(globalIdx) << ") ";
+        }
         std::cout << "\n" << std::flush;
     }
 
@@ -228,6 +233,8 @@ protected:
 
         // create maps for all indices for which the current process
         // is the master
+        domesticToGlobal_.reserve(foreignOverlap_.numLocal());
+        globalToDomestic_.reserve(foreignOverlap_.numLocal());
         int numMaster = 0;
         for (unsigned i = 0; i < foreignOverlap_.numLocal(); ++i) {
             if (!foreignOverlap_.iAmMasterOf(static_cast<Index>(i)))
@@ -285,8 +292,10 @@ protected:
     void sendBorderTo_([[maybe_unused]] ProcessRank peerRank)
     {
 #if HAVE_MPI
-        // send (local index on myRank, global index) pairs to the
-        // peers
+        // send (local index on the peer, global index) pairs of all
+        // border indices for which we are master to the peer using a
+        // single message
+        std::vector<PeerIndexGlobalIndex> sendBuf;
         BorderList::const_iterator borderIt = borderList_().begin();
         BorderList::const_iterator borderEndIt = borderList_().end();
         for (; borderIt != borderEndIt; ++borderIt) {
@@ -296,20 +305,30 @@ protected:
                 continue;
 
             Index localIdx = foreignOverlap_.nativeToLocal(borderIt->localIdx);
-            Index peerIdx = borderIt->peerIdx;
             assert(localIdx >= 0);
             if (foreignOverlap_.iAmMasterOf(localIdx)) {
-                sendBorderIndex(borderPeer, localIdx, peerIdx);
+                PeerIndexGlobalIndex tmp;
+                tmp.peerIdx = borderIt->peerIdx;
+                tmp.globalIdx = domesticToGlobal(localIdx);
+                sendBuf.push_back(tmp);
             }
         }
+
+        MPI_Send(sendBuf.data(),                                             // buff
+                 static_cast<int>(sendBuf.size()*sizeof(PeerIndexGlobalIndex)), // count
+                 MPI_BYTE,                                                   // data type
+                 static_cast<int>(peerRank),                                 // peer process
+                 0,                                                          // tag
+                 MPI_COMM_WORLD);                                            // communicator
 #endif // HAVE_MPI
     }
 
     void receiveBorderFrom_([[maybe_unused]] ProcessRank peerRank)
     {
 #if HAVE_MPI
-        // retrieve the global indices for which we are not master
-        // from the processes with lower rank
+        // retrieve the global indices for which the peer is the
+        // master. the peer sends all of them using a single message.
+        size_t numIndices = 0;
         BorderList::const_iterator borderIt = borderList_().begin();
         BorderList::const_iterator borderEndIt = borderList_().end();
         for (; borderIt != borderEndIt; ++borderIt) {
@@ -321,7 +340,22 @@ protected:
             Index nativeIdx = borderIt->localIdx;
             Index localIdx = foreignOverlap_.nativeToLocal(nativeIdx);
             if (localIdx >= 0 && foreignOverlap_.masterRank(localIdx) == borderPeer)
-                receiveBorderIndex(borderPeer);
+                ++numIndices;
+        }
+
+        std::vector<PeerIndexGlobalIndex> recvBuf(numIndices);
+        MPI_Recv(recvBuf.data(),                                              // buff
+                 static_cast<int>(recvBuf.size()*sizeof(PeerIndexGlobalIndex)), // count
+                 MPI_BYTE,                                                    // data type
+                 static_cast<int>(peerRank),                                  // peer process
+                 0,                                                           // tag
+                 MPI_COMM_WORLD,                                              // communicator
+                 MPI_STATUS_IGNORE);                                          // status
+
+        for (const auto& tmp : recvBuf) {
+            Index domesticIdx = foreignOverlap_.nativeToLocal(tmp.peerIdx);
+            if (domesticIdx >= 0)
+                addIndex(domesticIdx, tmp.globalIdx);
         }
 #endif // HAVE_MPI
     }
@@ -40,6 +40,17 @@
  * - \c SOR: A successive overrelaxation (SOR) preconditioner
  * - \c ILUn: An ILU(n) preconditioner
  * - \c ILU0: A specialized (and optimized) ILU(0) preconditioner
+ * - \c MultiColorGaussSeidel: A Gauss-Seidel preconditioner which processes the rows
+ *   of each color of the matrix graph concurrently
+ * - \c MultiColorSOR: The same for successive overrelaxation (SOR)
+ * - \c MultiColorSSOR: The same for symmetric successive overrelaxation (SSOR)
+ * - \c MultiColorILU0: An ILU(0) preconditioner for the matrix reordered by color
+ * - \c BlockJacobiILU0: A block Jacobi preconditioner with one ILU(0) block per thread
+ *
+ * The preconditioners use the floating point type specified by the
+ * PreconditionerScalar property. If it differs from the LinearSolverScalar property,
+ * they are set up for a copy of the matrix which uses this type, see
+ * Opm::Linear::MixedPrecisionPreconditioner.
  */
 #ifndef EWOMS_ISTL_PRECONDITIONER_WRAPPERS_HH
 #define EWOMS_ISTL_PRECONDITIONER_WRAPPERS_HH
@@ -48,25 +59,76 @@
 #include <opm/models/utils/parametersystem.hh>
 #include <opm/simulators/linalg/linalgproperties.hh>
 #include <opm/simulators/linalg/ilufirstelement.hh> //definitions needed in next header
+#include <opm/simulators/linalg/matrixblock.hh>
+#include <opm/simulators/linalg/mixedprecisionpreconditioner.hh>
+#include <opm/simulators/linalg/threadedpreconditioners.hh>
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
 #include <dune/istl/preconditioners.hh>
 
+#include <dune/common/fvector.hh>
 #include <dune/common/version.hh>
 
+#include <type_traits>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace Opm {
 namespace Linear {
+/*!
+ * \brief Specifies the types of the matrix and the vectors for which a sequential
+ *        preconditioner is set up.
+ *
+ * If the PreconditionerScalar property is the same as the LinearSolverScalar one, these
+ * are the overlapping matrix and vector. Else, the sequential preconditioner is set up
+ * for a copy of the matrix which uses PreconditionerScalar and it is wrapped by
+ * MixedPrecisionPreconditioner.
+ */
+template <class TypeTag>
+class SequentialPreconditionerTraits
+{
+    using LinearSolverScalar = GetPropType<TypeTag, Properties::LinearSolverScalar>;
+    using PreconditionerScalar = GetPropType<TypeTag, Properties::PreconditionerScalar>;
+    using OverlappingMatrix = GetPropType<TypeTag, Properties::OverlappingMatrix>;
+    using OverlappingVector = GetPropType<TypeTag, Properties::OverlappingVector>;
+
+    static constexpr int numEq = OverlappingVector::block_type::dimension;
+    static constexpr bool isMixedPrecision =
+        !std::is_same<LinearSolverScalar, PreconditionerScalar>::value;
+
+public:
+    using Matrix = std::conditional_t<isMixedPrecision,
+                                      Dune::BCRSMatrix<MatrixBlock<PreconditionerScalar, numEq, numEq> >,
+                                      OverlappingMatrix>;
+    using Vector = std::conditional_t<isMixedPrecision,
+                                      Dune::BlockVector<Dune::FieldVector<PreconditionerScalar, numEq> >,
+                                      OverlappingVector>;
+
+    //! The preconditioner which is used by the linear solver given the sequential one
+    //! for Matrix and Vector
+    template <class SeqPreCond>
+    using Preconditioner = std::conditional_t<isMixedPrecision,
+                                              MixedPrecisionPreconditioner<SeqPreCond,
+                                                                           OverlappingMatrix,
+                                                                           OverlappingVector>,
+                                              SeqPreCond>;
+};
+
 #define EWOMS_WRAP_ISTL_PRECONDITIONER(PREC_NAME, ISTL_PREC_TYPE)               \
     template <class TypeTag>                                                    \
     class PreconditionerWrapper##PREC_NAME                                      \
     {                                                                           \
         using Scalar = GetPropType<TypeTag, Properties::Scalar>;                 \
-        using SparseMatrixAdapter = GetPropType<TypeTag, Properties::SparseMatrixAdapter>; \
-        using IstlMatrix = typename SparseMatrixAdapter::IstlMatrix;            \
-        using OverlappingVector = GetPropType<TypeTag, Properties::OverlappingVector>; \
+        using OverlappingMatrix = GetPropType<TypeTag, Properties::OverlappingMatrix>; \
+        using Traits = SequentialPreconditionerTraits<TypeTag>;                 \
+        using Matrix = typename Traits::Matrix;                                 \
+        using Vector = typename Traits::Vector;                                 \
                                                                                 \
     public:                                                                     \
-        using SequentialPreconditioner = ISTL_PREC_TYPE<IstlMatrix,             \
-                                                        OverlappingVector,      \
-                                                        OverlappingVector>;     \
+        using SequentialPreconditioner = typename Traits::template              \
+            Preconditioner<ISTL_PREC_TYPE<Matrix, Vector, Vector> >;            \
         PreconditionerWrapper##PREC_NAME()                                      \
         {}                                                                      \
                                                                                 \
@@ -79,7 +141,7 @@ namespace Linear {
                                  "preconditioner");                             \
         }                                                                       \
                                                                                 \
-        void prepare(IstlMatrix& matrix)                                        \
+        void prepare(OverlappingMatrix& matrix)                                 \
         {                                                                       \
             int order = EWOMS_GET_PARAM(TypeTag, int, PreconditionerOrder);     \
             Scalar relaxationFactor = EWOMS_GET_PARAM(TypeTag, Scalar, PreconditionerRelaxation);   \
@@ -91,10 +153,13 @@ namespace Linear {
         { return *seqPreCond_; }                                                \
                                                                                 \
         void cleanup()                                                          \
-        { delete seqPreCond_; }                                                 \
+        {                                                                       \
+            delete seqPreCond_;                                                 \
+            seqPreCond_ = nullptr;                                              \
+        }                                                                       \
                                                                                 \
     private:                                                                    \
-        SequentialPreconditioner *seqPreCond_;                                  \
+        SequentialPreconditioner *seqPreCond_ = nullptr;                        \
     };
 
 // the same as the EWOMS_WRAP_ISTL_PRECONDITIONER macro, but without
@@ -105,12 +170,13 @@ namespace Linear {
     {                                                                           \
         using Scalar = GetPropType<TypeTag, Properties::Scalar>;                 \
         using OverlappingMatrix = GetPropType<TypeTag, Properties::OverlappingMatrix>; \
-        using OverlappingVector = GetPropType<TypeTag, Properties::OverlappingVector>; \
+        using Traits = SequentialPreconditionerTraits<TypeTag>;                 \
+        using Matrix = typename Traits::Matrix;                                 \
+        using Vector = typename Traits::Vector;                                 \
                                                                                 \
     public:                                                                     \
-        using SequentialPreconditioner = ISTL_PREC_TYPE<OverlappingMatrix,      \
-                                                        OverlappingVector,      \
-                                                        OverlappingVector>;     \
+        using SequentialPreconditioner = typename Traits::template              \
+            Preconditioner<ISTL_PREC_TYPE<Matrix, Vector, Vector> >;            \
         PreconditionerWrapper##PREC_NAME()                                      \
         {}                                                                      \
                                                                                 \
@@ -133,10 +199,13 @@ namespace Linear {
         { return *seqPreCond_; }                                                \
                                                                                 \
         void cleanup()                                                          \
-        { delete seqPreCond_; }                                                 \
+        {                                                                       \
+            delete seqPreCond_;                                                 \
+            seqPreCond_ = nullptr;                                              \
+        }                                                                       \
                                                                                 \
     private:                                                                    \
-        SequentialPreconditioner *seqPreCond_;                                  \
+        SequentialPreconditioner *seqPreCond_ = nullptr;                        \
     };
 
 EWOMS_WRAP_ISTL_PRECONDITIONER(Jacobi, Dune::SeqJac)
@@ -152,12 +221,15 @@ class PreconditionerWrapperILU
 {
     using Scalar = GetPropType<TypeTag, Properties::Scalar>;
     using OverlappingMatrix = GetPropType<TypeTag, Properties::OverlappingMatrix>;
-    using OverlappingVector = GetPropType<TypeTag, Properties::OverlappingVector>;
+    using Traits = SequentialPreconditionerTraits<TypeTag>;
+    using Matrix = typename Traits::Matrix;
+    using Vector = typename Traits::Vector;
 
     static constexpr int order = getPropValue<TypeTag, Properties::PreconditionerOrder>();
 
 public:
-    using SequentialPreconditioner = Dune::SeqILU<OverlappingMatrix, OverlappingVector, OverlappingVector, order>;
+    using SequentialPreconditioner =
+        typename Traits::template Preconditioner<Dune::SeqILU<Matrix, Vector, Vector, order> >;
 
     PreconditionerWrapperILU()
     {}
@@ -180,12 +252,123 @@ public:
     { return *seqPreCond_; }
 
     void cleanup()
-    { delete seqPreCond_; }
+    {
+        delete seqPreCond_;
+        seqPreCond_ = nullptr;
+    }
+
+private:
+    SequentialPreconditioner *seqPreCond_ = nullptr;
+};
+
+// the preconditioners of threadedpreconditioners.hh take a different set of arguments
+// than the ones of dune-istl, so they need custom wrappers, too.
+template <class TypeTag, bool symmetric, bool relaxed>
+class PreconditionerWrapperMultiColorSORBase
+{
+    using Scalar = GetPropType<TypeTag, Properties::Scalar>;
+    using OverlappingMatrix = GetPropType<TypeTag, Properties::OverlappingMatrix>;
+    using Traits = SequentialPreconditionerTraits<TypeTag>;
+    using Matrix = typename Traits::Matrix;
+    using Vector = typename Traits::Vector;
+
+public:
+    using SequentialPreconditioner =
+        typename Traits::template Preconditioner<MultiColorSOR<Matrix, Vector, Vector> >;
+
+    static void registerParameters()
+    {
+        EWOMS_REGISTER_PARAM(TypeTag, int, PreconditionerOrder,
+                             "The order of the preconditioner");
+        if (relaxed)
+            EWOMS_REGISTER_PARAM(TypeTag, Scalar, PreconditionerRelaxation,
+                                 "The relaxation factor of the preconditioner");
+    }
+
+    void prepare(OverlappingMatrix& matrix)
+    {
+        int order = EWOMS_GET_PARAM(TypeTag, int, PreconditionerOrder);
+        Scalar relaxationFactor = 1.0;
+        if (relaxed)
+            relaxationFactor = EWOMS_GET_PARAM(TypeTag, Scalar, PreconditionerRelaxation);
+
+        seqPreCond_ = new SequentialPreconditioner(matrix, order, relaxationFactor, symmetric);
+    }
+
+    SequentialPreconditioner& get()
+    { return *seqPreCond_; }
+
+    void cleanup()
+    {
+        delete seqPreCond_;
+        seqPreCond_ = nullptr;
+    }
+
+private:
+    SequentialPreconditioner *seqPreCond_ = nullptr;
+};
+
+template <class TypeTag>
+using PreconditionerWrapperMultiColorGaussSeidel =
+    PreconditionerWrapperMultiColorSORBase<TypeTag, /*symmetric=*/false, /*relaxed=*/false>;
+template <class TypeTag>
+using PreconditionerWrapperMultiColorSOR =
+    PreconditionerWrapperMultiColorSORBase<TypeTag, /*symmetric=*/false, /*relaxed=*/true>;
+template <class TypeTag>
+using PreconditionerWrapperMultiColorSSOR =
+    PreconditionerWrapperMultiColorSORBase<TypeTag, /*symmetric=*/true, /*relaxed=*/true>;
+
+template <class TypeTag, template <class, class, class> class ILU0Type>
+class PreconditionerWrapperThreadedILU0
+{
+    using Scalar = GetPropType<TypeTag, Properties::Scalar>;
+    using OverlappingMatrix = GetPropType<TypeTag, Properties::OverlappingMatrix>;
+    using Traits = SequentialPreconditionerTraits<TypeTag>;
+    using Matrix = typename Traits::Matrix;
+    using Vector = typename Traits::Vector;
+
+public:
+    using SequentialPreconditioner =
+        typename Traits::template Preconditioner<ILU0Type<Matrix, Vector, Vector> >;
+
+    static void registerParameters()
+    {
+        EWOMS_REGISTER_PARAM(TypeTag, Scalar, PreconditionerRelaxation,
+                             "The relaxation factor of the preconditioner");
+    }
+
+    void prepare(OverlappingMatrix& matrix)
+    {
+        Scalar relaxationFactor = EWOMS_GET_PARAM(TypeTag, Scalar, PreconditionerRelaxation);
+
+        unsigned numThreads = 1;
+#ifdef _OPENMP
+        numThreads = static_cast<unsigned>(omp_get_max_threads());
+#endif
+
+        seqPreCond_ = new SequentialPreconditioner(matrix, relaxationFactor, numThreads);
+    }
+
+    SequentialPreconditioner& get()
+    { return *seqPreCond_; }
+
+    void cleanup()
+    {
+        delete seqPreCond_;
+        seqPreCond_ = nullptr;
+    }
 
 private:
-    SequentialPreconditioner *seqPreCond_;
+    SequentialPreconditioner *seqPreCond_ = nullptr;
 };
 
+template <class TypeTag>
+using PreconditionerWrapperMultiColorILU0 =
+    PreconditionerWrapperThreadedILU0<TypeTag, MultiColorILU0>;
+template <class TypeTag>
+using PreconditionerWrapperBlockJacobiILU0 =
+    PreconditionerWrapperThreadedILU0<TypeTag, BlockJacobiILU0>;
+
 #undef EWOMS_WRAP_ISTL_PRECONDITIONER
 }} // namespace Linear, Opm
 
@@ -40,6 +40,8 @@
  * - \c BiCGStab: A stabilized bi-conjugated gradients solver
  * - \c MinRes: A solver based on the  minimized residual algorithm
  * - \c RestartedGMRes: A restarted GMRES solver
+ * - \c RecyclingGMRes: A restarted GMRES solver which retains a subspace across
+ *                      linear solves
  */
 #ifndef EWOMS_ISTL_SOLVER_WRAPPERS_HH
 #define EWOMS_ISTL_SOLVER_WRAPPERS_HH
@@ -47,6 +49,7 @@
 #include <opm/models/utils/propertysystem.hh>
 #include <opm/models/utils/parametersystem.hh>
 #include <opm/simulators/linalg/linalgproperties.hh>
+#include <opm/simulators/linalg/recyclinggmressolver.hh>
 
 #include <dune/istl/solvers.hh>
 
@@ -75,10 +78,9 @@ namespace Opm::Linear {
         template <class LinearOperator, class ScalarProduct, class Preconditioner> \
         std::shared_ptr<RawSolver> get(LinearOperator& parOperator,                \
                                        ScalarProduct& parScalarProduct,            \
-                                       Preconditioner& parPreCond)                 \
+                                       Preconditioner& parPreCond,                 \
+                                       Scalar tolerance)                           \
         {                                                                          \
-            Scalar tolerance = EWOMS_GET_PARAM(TypeTag, Scalar,                    \
-                                               LinearSolverTolerance);             \
             int maxIter = EWOMS_GET_PARAM(TypeTag, int, LinearSolverMaxIterations);\
                                                                                    \
             int verbosity = 0;                                                     \
@@ -131,9 +133,9 @@ public:
     template <class LinearOperator, class ScalarProduct, class Preconditioner>
     std::shared_ptr<RawSolver> get(LinearOperator& parOperator,
                                    ScalarProduct& parScalarProduct,
-                                   Preconditioner& parPreCond)
+                                   Preconditioner& parPreCond,
+                                   Scalar tolerance)
     {
-        Scalar tolerance = EWOMS_GET_PARAM(TypeTag, Scalar, LinearSolverTolerance);
         int maxIter = EWOMS_GET_PARAM(TypeTag, int, LinearSolverMaxIterations);
 
         int verbosity = 0;
@@ -158,6 +160,66 @@ private:
     std::shared_ptr<RawSolver> solver_;
 };
 
+/*!
+ * \brief Solver wrapper for the GMRES solver which recycles a Krylov subspace.
+ *
+ * The recycled subspace is owned by the wrapper, i.e., it is kept between the linear
+ * solves of the simulation.
+ */
+template <class TypeTag>
+class SolverWrapperRecyclingGMRes
+{
+    using Scalar = GetPropType<TypeTag, Properties::Scalar>;
+    using OverlappingVector = GetPropType<TypeTag, Properties::OverlappingVector>;
+
+public:
+    using RawSolver = Opm::Linear::RecyclingGMResSolver<OverlappingVector>;
+
+    SolverWrapperRecyclingGMRes()
+    {}
+
+    static void registerParameters()
+    {
+        EWOMS_REGISTER_PARAM(TypeTag, int, GMResRestart,
+                             "Number of iterations after which the GMRES linear solver is restarted");
+        EWOMS_REGISTER_PARAM(TypeTag, int, GMResRecycledVectors,
+                             "Maximum number of vectors which the GMRES linear solver retains between linear solves");
+    }
+
+    template <class LinearOperator, class ScalarProduct, class Preconditioner>
+    std::shared_ptr<RawSolver> get(LinearOperator& parOperator,
+                                   ScalarProduct& parScalarProduct,
+                                   Preconditioner& parPreCond,
+                                   Scalar tolerance)
+    {
+        int maxIter = EWOMS_GET_PARAM(TypeTag, int, LinearSolverMaxIterations);
+
+        int verbosity = 0;
+        if (parOperator.overlap().myRank() == 0)
+            verbosity = EWOMS_GET_PARAM(TypeTag, int, LinearSolverVerbosity);
+        int restartAfter = EWOMS_GET_PARAM(TypeTag, int, GMResRestart);
+        int maxRecycled = EWOMS_GET_PARAM(TypeTag, int, GMResRecycledVectors);
+        solver_ = std::make_shared<RawSolver>(parOperator,
+                                              parScalarProduct,
+                                              parPreCond,
+                                              tolerance,
+                                              restartAfter,
+                                              maxIter,
+                                              verbosity,
+                                              recycledSpace_,
+                                              maxRecycled);
+
+        return solver_;
+    }
+
+    void cleanup()
+    { solver_.reset(); }
+
+private:
+    std::shared_ptr<RawSolver> solver_;
+    std::vector<typename RawSolver::RecycledVector> recycledSpace_;
+};
+
 #undef EWOMS_WRAP_ISTL_SOLVER
 
 } // namespace Opm::Linear
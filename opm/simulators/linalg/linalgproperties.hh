@@ -46,6 +46,10 @@ struct PreconditionerWrapper { using type = UndefinedProperty; };
 template<class TypeTag, class MyTypeTag>
 struct LinearSolverScalar { using type = UndefinedProperty; };
 
+//! The floating point type used by the preconditioner
+template<class TypeTag, class MyTypeTag>
+struct PreconditionerScalar { using type = UndefinedProperty; };
+
 /*!
  * \brief The size of the algebraic overlap of the linear solver.
  *
@@ -94,6 +98,20 @@ struct PreconditionerRelaxation { using type = UndefinedProperty; };
 template<class TypeTag, class MyTypeTag>
 struct GMResRestart { using type = UndefinedProperty; };
 
+//! The maximum number of vectors which the recycling GMRES solver retains between
+//! linear solves
+template<class TypeTag, class MyTypeTag>
+struct GMResRecycledVectors { using type = UndefinedProperty; };
+
+//! Use the solution of the previous linear solve as the initial guess instead of zero
+template<class TypeTag, class MyTypeTag>
+struct LinearSolverUsePreviousSolution { using type = UndefinedProperty; };
+
+//! Reorder the linear system to reduce the fill-in of incomplete factorizations and to
+//! improve the data locality
+template<class TypeTag, class MyTypeTag>
+struct LinearSolverReordering { using type = UndefinedProperty; };
+
 //! The class that allows to manipulate sparse matrices
 template<class TypeTag, class MyTypeTag>
 struct SparseMatrixAdapter { using type = UndefinedProperty; };
@@ -104,6 +122,17 @@ struct GlobalEqVector { using type = UndefinedProperty; };
 
 template<class TypeTag, class MyTypeTag>
 struct AmgCoarsenTarget { using type = UndefinedProperty; };
+
+//! The index of the primary variable which is used as the pressure by the CPR
+//! preconditioner
+template<class TypeTag, class MyTypeTag>
+struct CprPressureIndex { using type = UndefinedProperty; };
+
+//! The number of matrices for which the aggregates of the pressure AMG of the CPR
+//! preconditioner are reused before they are recomputed
+template<class TypeTag, class MyTypeTag>
+struct CprAmgReuseInterval { using type = UndefinedProperty; };
+
 template<class TypeTag, class MyTypeTag>
 struct LinearSolverMaxError { using type = UndefinedProperty; };
 template<class TypeTag, class MyTypeTag>
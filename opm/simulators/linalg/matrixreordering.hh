@@ -0,0 +1,195 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief Computes orderings of the rows of a sparse matrix.
+ */
+#ifndef EWOMS_MATRIX_REORDERING_HH
+#define EWOMS_MATRIX_REORDERING_HH
+
+#include "overlaptypes.hh"
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace Opm {
+namespace Linear {
+
+/*!
+ * \brief Computes the reverse Cuthill-McKee ordering of the rows of a sparse matrix.
+ *
+ * The rows are numbered by a breadth-first search through the graph of the matrix
+ * which visits the neighbors of a row in the order of increasing degree. Each
+ * connected component of the graph is started at a pseudo-peripheral row which is
+ * determined using the heuristic of George and Liu. Reversing the resulting sequence
+ * reduces the bandwidth of the matrix, which typically reduces the fill-in of
+ * incomplete factorizations and improves the cache reuse of the matrix-vector product.
+ *
+ * Since an entry couples two rows regardless of whether it is above or below the
+ * diagonal, the pattern of the matrix does not need to be symmetric.
+ *
+ * \param order Receives the indices of the rows in their new order, i.e., order[i] is
+ *              the index of the row which becomes the i-th one
+ */
+template <class Matrix>
+void reverseCuthillMcKee(const Matrix& A, std::vector<Index>& order)
+{
+    const std::size_t numRows = A.N();
+
+    // the off-diagonal pattern of the symmetrized matrix in compressed row format
+    std::vector<std::size_t> adjOffsets(numRows + 1, 0);
+    for (auto rowIt = A.begin(); rowIt != A.end(); ++rowIt) {
+        for (auto colIt = rowIt->begin(); colIt != rowIt->end(); ++colIt) {
+            if (colIt.index() == rowIt.index())
+                continue;
+            ++adjOffsets[rowIt.index() + 1];
+            ++adjOffsets[colIt.index() + 1];
+        }
+    }
+    for (std::size_t i = 0; i < numRows; ++i)
+        adjOffsets[i + 1] += adjOffsets[i];
+
+    std::vector<unsigned> adj(adjOffsets.back());
+    std::vector<std::size_t> fillPos(adjOffsets.begin(), adjOffsets.end() - 1);
+    for (auto rowIt = A.begin(); rowIt != A.end(); ++rowIt) {
+        for (auto colIt = rowIt->begin(); colIt != rowIt->end(); ++colIt) {
+            if (colIt.index() == rowIt.index())
+                continue;
+            adj[fillPos[rowIt.index()]++] = static_cast<unsigned>(colIt.index());
+            adj[fillPos[colIt.index()]++] = static_cast<unsigned>(rowIt.index());
+        }
+    }
+
+    // entries which are present in both triangles appear twice, so remove the
+    // duplicates in place
+    std::size_t numAdj = 0;
+    std::vector<std::size_t> degree(numRows);
+    for (std::size_t rowIdx = 0; rowIdx < numRows; ++rowIdx) {
+        const auto first = adj.begin() + static_cast<std::ptrdiff_t>(adjOffsets[rowIdx]);
+        const auto last = adj.begin() + static_cast<std::ptrdiff_t>(adjOffsets[rowIdx + 1]);
+        std::sort(first, last);
+        const auto uniqueEnd = std::unique(first, last);
+
+        adjOffsets[rowIdx] = numAdj;
+        for (auto it = first; it != uniqueEnd; ++it)
+            adj[numAdj++] = *it;
+        degree[rowIdx] = numAdj - adjOffsets[rowIdx];
+    }
+    adjOffsets[numRows] = numAdj;
+
+    const auto lessDegree = [&degree](unsigned a, unsigned b)
+    { return degree[a] < degree[b] || (degree[a] == degree[b] && a < b); };
+
+    // compute the level structure rooted at a row, i.e., the breadth-first order of
+    // the rows of its connected component and their distance to the root. returns the
+    // number of the last level.
+    std::vector<int> level(numRows, -1);
+    std::vector<unsigned> levelQueue;
+    const auto computeLevels = [&](unsigned root) {
+        for (unsigned rowIdx : levelQueue)
+            level[rowIdx] = -1;
+        levelQueue.clear();
+
+        levelQueue.push_back(root);
+        level[root] = 0;
+        for (std::size_t k = 0; k < levelQueue.size(); ++k) {
+            const unsigned rowIdx = levelQueue[k];
+            for (std::size_t j = adjOffsets[rowIdx]; j < adjOffsets[rowIdx + 1]; ++j) {
+                const unsigned neighborIdx = adj[j];
+                if (level[neighborIdx] < 0) {
+                    level[neighborIdx] = level[rowIdx] + 1;
+                    levelQueue.push_back(neighborIdx);
+                }
+            }
+        }
+        return level[levelQueue.back()];
+    };
+
+    // the connected components are numbered one after the other. the search for the
+    // start row of a component begins at its row of minimum degree.
+    std::vector<unsigned> rowsByDegree(numRows);
+    for (std::size_t i = 0; i < numRows; ++i)
+        rowsByDegree[i] = static_cast<unsigned>(i);
+    std::sort(rowsByDegree.begin(), rowsByDegree.end(), lessDegree);
+
+    std::vector<unsigned> cmOrder;
+    cmOrder.reserve(numRows);
+    std::vector<unsigned char> isNumbered(numRows, 0);
+    for (unsigned seed : rowsByDegree) {
+        if (isNumbered[seed])
+            continue;
+
+        // find a pseudo-peripheral row: restart the search at the row of minimum degree
+        // in the last level as long as this increases the number of levels
+        unsigned root = seed;
+        int eccentricity = computeLevels(root);
+        while (true) {
+            unsigned candidate = levelQueue.back();
+            for (std::size_t k = levelQueue.size();
+                 k > 0 && level[levelQueue[k - 1]] == eccentricity;
+                 --k)
+            {
+                if (lessDegree(levelQueue[k - 1], candidate))
+                    candidate = levelQueue[k - 1];
+            }
+
+            const int candidateEccentricity = computeLevels(candidate);
+            if (candidateEccentricity <= eccentricity)
+                break;
+            root = candidate;
+            eccentricity = candidateEccentricity;
+        }
+
+        // Cuthill-McKee: number the rows in breadth-first order, where the neighbors of
+        // a row are visited in the order of increasing degree
+        std::size_t head = cmOrder.size();
+        cmOrder.push_back(root);
+        isNumbered[root] = 1;
+        while (head < cmOrder.size()) {
+            const unsigned rowIdx = cmOrder[head++];
+            const std::size_t neighborsBegin = cmOrder.size();
+            for (std::size_t j = adjOffsets[rowIdx]; j < adjOffsets[rowIdx + 1]; ++j) {
+                const unsigned neighborIdx = adj[j];
+                if (!isNumbered[neighborIdx]) {
+                    isNumbered[neighborIdx] = 1;
+                    cmOrder.push_back(neighborIdx);
+                }
+            }
+            std::sort(cmOrder.begin() + static_cast<std::ptrdiff_t>(neighborsBegin),
+                      cmOrder.end(),
+                      lessDegree);
+        }
+    }
+
+    // reverse the ordering
+    order.resize(numRows);
+    for (std::size_t i = 0; i < numRows; ++i)
+        order[i] = static_cast<Index>(cmOrder[numRows - 1 - i]);
+}
+
+} // namespace Linear
+} // namespace Opm
+
+#endif
@@ -0,0 +1,157 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \copydoc Opm::Linear::MixedPrecisionPreconditioner
+ */
+#ifndef EWOMS_MIXED_PRECISION_PRECONDITIONER_HH
+#define EWOMS_MIXED_PRECISION_PRECONDITIONER_HH
+
+#include <dune/istl/preconditioner.hh>
+#include <dune/istl/solvercategory.hh>
+
+#include <cstddef>
+#include <utility>
+
+namespace Opm {
+namespace Linear {
+
+/*!
+ * \brief Applies a sequential preconditioner which uses a different floating point
+ *        type than the linear solver.
+ *
+ * The preconditioner is set up for a copy of the matrix whose entries are converted to
+ * the floating point type of the preconditioner, and the vectors are converted whenever
+ * the preconditioner is applied. If this type is less precise than the one of the
+ * linear solver, e.g., float instead of double, the memory which needs to be accessed
+ * to apply the preconditioner is reduced accordingly.
+ */
+template <class SeqPreCond, class Matrix, class Vector>
+class MixedPrecisionPreconditioner : public Dune::Preconditioner<Vector, Vector>
+{
+    using LowPrecisionMatrix = typename SeqPreCond::matrix_type;
+    using LowPrecisionVector = typename SeqPreCond::domain_type;
+
+public:
+    using matrix_type = Matrix;
+    using domain_type = Vector;
+    using range_type = Vector;
+    using field_type = typename Vector::field_type;
+
+    /*!
+     * \brief Create the preconditioner.
+     *
+     * \param A The matrix to be preconditioned
+     * \param args The remaining arguments of the constructor of the wrapped preconditioner
+     */
+    template <class... Args>
+    MixedPrecisionPreconditioner(const Matrix& A, Args&&... args)
+        : matrix_(convertMatrix_(A))
+        , seqPreCond_(matrix_, std::forward<Args>(args)...)
+        , x_(A.N())
+        , b_(A.N())
+    {}
+
+    Dune::SolverCategory::Category category() const override
+    { return Dune::SolverCategory::sequential; }
+
+    void pre(domain_type& x, range_type& b) override
+    {
+        convertVector_(x_, x);
+        convertVector_(b_, b);
+        seqPreCond_.pre(x_, b_);
+        convertVector_(x, x_);
+        convertVector_(b, b_);
+    }
+
+    void apply(domain_type& v, const range_type& d) override
+    {
+        convertVector_(x_, v);
+        convertVector_(b_, d);
+        seqPreCond_.apply(x_, b_);
+        convertVector_(v, x_);
+    }
+
+    void post(domain_type& x) override
+    {
+        convertVector_(x_, x);
+        seqPreCond_.post(x_);
+        convertVector_(x, x_);
+    }
+
+private:
+    // create a copy of a matrix with the floating point type of the preconditioner
+    static LowPrecisionMatrix convertMatrix_(const Matrix& A)
+    {
+        const std::size_t numRows = A.N();
+        LowPrecisionMatrix result(numRows, A.M(), A.nonzeroes(), LowPrecisionMatrix::random);
+        for (std::size_t rowIdx = 0; rowIdx < numRows; ++rowIdx)
+            result.setrowsize(rowIdx, A[rowIdx].size());
+        result.endrowsizes();
+        for (std::size_t rowIdx = 0; rowIdx < numRows; ++rowIdx) {
+            const auto& row = A[rowIdx];
+            for (auto colIt = row.begin(); colIt != row.end(); ++colIt)
+                result.addindex(rowIdx, colIt.index());
+        }
+        result.endindices();
+
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (std::size_t rowIdx = 0; rowIdx < numRows; ++rowIdx) {
+            const auto& row = A[rowIdx];
+            auto resultColIt = result[rowIdx].begin();
+            for (auto colIt = row.begin(); colIt != row.end(); ++colIt, ++resultColIt) {
+                const auto& block = *colIt;
+                auto& resultBlock = *resultColIt;
+                for (std::size_t i = 0; i < block.N(); ++i)
+                    for (std::size_t j = 0; j < block.M(); ++j)
+                        resultBlock[i][j] = block[i][j];
+            }
+        }
+
+        return result;
+    }
+
+    template <class DestVector, class SourceVector>
+    static void convertVector_(DestVector& dest, const SourceVector& source)
+    {
+        const std::size_t size = source.size();
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (std::size_t i = 0; i < size; ++i)
+            for (std::size_t j = 0; j < source[i].size(); ++j)
+                dest[i][j] = source[i][j];
+    }
+
+    LowPrecisionMatrix matrix_;
+    SeqPreCond seqPreCond_;
+    LowPrecisionVector x_;
+    LowPrecisionVector b_;
+};
+
+} // namespace Linear
+} // namespace Opm
+
+#endif
@@ -37,9 +37,10 @@
 #include <dune/istl/scalarproducts.hh>
 #include <dune/istl/io.hh>
 #include <algorithm>
-#include <set>
+#include <functional>
 #include <map>
 #include <iostream>
+#include <utility>
 #include <vector>
 #include <memory>
 
@@ -56,28 +57,54 @@ class OverlappingBCRSMatrix : public BCRSMatrix
 
 public:
     using Overlap = Opm::Linear::DomesticOverlapFromBCRSMatrix;
-
-private:
-    using Entries = std::vector<std::set<Index> >;
-
-public:
     using ColIterator = typename ParentType::ColIterator;
     using ConstColIterator = typename ParentType::ConstColIterator;
     using block_type = typename ParentType::block_type;
     using field_type = typename ParentType::field_type;
 
+private:
+    // the (row, column) indices of a set of matrix entries
+    using EntryIndices = std::vector<std::pair<Index, Index> >;
+
+    // the matrix entries whose values are exchanged with a peer process
+    struct PeerEntries
+    {
+        // the domestic (row, column) indices of the entries in the order in which
+        // they are communicated. these are only required until the structure of the
+        // matrix is known.
+        EntryIndices indices;
+
+        // the entries of the matrix in the order in which they are communicated
+        // (nullptr if an entry is unknown to the local process)
+        std::vector<block_type*> entries;
+
+        // the buffer for the values of the entries
+        MpiBuffer<block_type> values;
+    };
+
+public:
     // no real copying done at the moment
     OverlappingBCRSMatrix(const OverlappingBCRSMatrix& other)
         : ParentType(other)
+        , borderRows_(other.borderRows_)
+        , interiorRows_(other.interiorRows_)
     {}
 
+    /*!
+     * \brief Create the overlapping matrix from the matrix of the local process.
+     *
+     * If the sequence of all native indices is given by 'nativeOrder', the rows and
+     * columns of the local indices are arranged in this order.
+     */
     template <class NativeBCRSMatrix>
     OverlappingBCRSMatrix(const NativeBCRSMatrix& nativeMatrix,
                           const BorderList& borderList,
                           const BlackList& blackList,
-                          unsigned overlapSize)
+                          unsigned overlapSize,
+                          const std::vector<Index>& nativeOrder = {})
     {
-        overlap_ = std::make_shared<Overlap>(nativeMatrix, borderList, blackList, overlapSize);
+        overlap_ = std::make_shared<Overlap>(nativeMatrix, borderList, blackList,
+                                             overlapSize, nativeOrder);
         myRank_ = 0;
 #if HAVE_MPI
         MPI_Comm_rank(MPI_COMM_WORLD, &myRank_);
@@ -95,31 +122,6 @@ public:
                           typename BCRSMatrix::BuildMode)
     { throw std::logic_error("OverlappingBCRSMatrix objects cannot be build from scratch!"); }
 
-    ~OverlappingBCRSMatrix()
-    {
-        if (overlap_.use_count() == 0)
-            return;
-
-        // delete all MPI buffers
-        const PeerSet& peerSet = overlap_->peerSet();
-        typename PeerSet::const_iterator peerIt = peerSet.begin();
-        typename PeerSet::const_iterator peerEndIt = peerSet.end();
-        for (; peerIt != peerEndIt; ++peerIt) {
-            ProcessRank peerRank = *peerIt;
-
-            delete rowSizesRecvBuff_[peerRank];
-            delete rowIndicesRecvBuff_[peerRank];
-            delete entryColIndicesRecvBuff_[peerRank];
-            delete entryValuesRecvBuff_[peerRank];
-
-            delete numRowsSendBuff_[peerRank];
-            delete rowSizesSendBuff_[peerRank];
-            delete rowIndicesSendBuff_[peerRank];
-            delete entryColIndicesSendBuff_[peerRank];
-            delete entryValuesSendBuff_[peerRank];
-        }
-    }
-
     ParentType& asParent()
     { return *this; }
 
@@ -132,6 +134,66 @@ public:
     const Overlap& overlap() const
     { return *overlap_; }
 
+    /*!
+     * \brief Returns the rows whose values are sent to the peer processes when a
+     *        vector is syncronized.
+     */
+    const std::vector<unsigned>& borderRows() const
+    { return borderRows_; }
+
+    /*!
+     * \brief Returns the rows which are not sent to any peer process.
+     */
+    const std::vector<unsigned>& interiorRows() const
+    { return interiorRows_; }
+
+    /*!
+     * \brief Compute \f$ y = A x \f$ for a subset of the rows.
+     *
+     * The rows are distributed over the threads.
+     */
+    template <class X, class Y>
+    void mvRows(const std::vector<unsigned>& rows, const X& x, Y& y) const
+    {
+        const size_t numRows = rows.size();
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (size_t i = 0; i < numRows; ++i) {
+            const unsigned rowIdx = rows[i];
+            auto& yRow = y[rowIdx];
+            yRow = 0.0;
+
+            const auto& row = (*this)[rowIdx];
+            const auto& endIt = row.end();
+            for (auto colIt = row.begin(); colIt != endIt; ++colIt)
+                colIt->umv(x[colIt.index()], yRow);
+        }
+    }
+
+    /*!
+     * \brief Compute \f$ y = y + \alpha A x \f$ for a subset of the rows.
+     *
+     * The rows are distributed over the threads.
+     */
+    template <class X, class Y>
+    void usmvRows(const std::vector<unsigned>& rows, field_type alpha, const X& x, Y& y) const
+    {
+        const size_t numRows = rows.size();
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (size_t i = 0; i < numRows; ++i) {
+            const unsigned rowIdx = rows[i];
+            auto& yRow = y[rowIdx];
+
+            const auto& row = (*this)[rowIdx];
+            const auto& endIt = row.end();
+            for (auto colIt = row.begin(); colIt != endIt; ++colIt)
+                colIt->usmv(alpha, x[colIt.index()], yRow);
+        }
+    }
+
     /*!
      * \brief Assign and syncronize the overlapping matrix from a non-overlapping one.
      */
@@ -216,44 +278,39 @@ public:
                                 "row");
     }
 
+    /*!
+     * \brief Assign the entries of the overlapping matrix from a non-overlapping one.
+     *
+     * The entries which do not correspond to an entry of the non-overlapping matrix are
+     * set to zero. When this is called for the first time, the position of each entry
+     * of the non-overlapping matrix within the overlapping one is determined, so that
+     * the following calls only need to sweep over both matrices once.
+     */
     template <class NativeBCRSMatrix>
     void assignFromNative(const NativeBCRSMatrix& nativeMatrix)
     {
-        // first, set everything to 0,
-        BCRSMatrix::operator=(0.0);
-
-        // then copy the domestic entries of the native matrix to the overlapping matrix
-        for (unsigned nativeRowIdx = 0; nativeRowIdx < nativeMatrix.N(); ++nativeRowIdx) {
-            Index domesticRowIdx = overlap_->nativeToDomestic(static_cast<Index>(nativeRowIdx));
-            if (domesticRowIdx < 0) {
-                continue; // row corresponds to a black-listed entry
-            }
-
-            auto nativeColIt = nativeMatrix[nativeRowIdx].begin();
-            const auto& nativeColEndIt = nativeMatrix[nativeRowIdx].end();
-            for (; nativeColIt != nativeColEndIt; ++nativeColIt) {
-                Index domesticColIdx = overlap_->nativeToDomestic(static_cast<Index>(nativeColIt.index()));
-
-                // make sure to include all off-diagonal entries, even those which belong
-                // to DOFs which are managed by a peer process. For this, we have to
-                // re-map the column index of the black-listed index to a native one.
-                if (domesticColIdx < 0)
-                    domesticColIdx = overlap_->blackList().nativeToDomestic(static_cast<Index>(nativeColIt.index()));
-
-                if (domesticColIdx < 0)
-                    // there is no domestic index which corresponds to a black-listed
-                    // one. this can happen if the grid overlap is larger than the
-                    // algebraic one...
+        if (nativeEntries_.size() != nativeMatrix.nonzeroes())
+            mapNativeEntries_(nativeMatrix);
+
+        for (block_type* entry : unmappedEntries_)
+            *entry = 0.0;
+
+        size_t nativeEntryIdx = 0;
+        const auto& nativeRowEndIt = nativeMatrix.end();
+        for (auto nativeRowIt = nativeMatrix.begin(); nativeRowIt != nativeRowEndIt; ++nativeRowIt) {
+            const auto& nativeColEndIt = nativeRowIt->end();
+            for (auto nativeColIt = nativeRowIt->begin(); nativeColIt != nativeColEndIt; ++nativeColIt) {
+                block_type* dest = nativeEntries_[nativeEntryIdx++];
+                if (!dest)
                     continue;
 
                 // we need to copy the block matrices manually since it seems that (at
                 // least some versions of) Dune have an endless recursion bug when
                 // assigning dense matrices of different field type
                 const auto& src = *nativeColIt;
-                auto& dest = (*this)[static_cast<unsigned>(domesticRowIdx)][static_cast<unsigned>(domesticColIdx)];
                 for (unsigned i = 0; i < src.rows; ++i) {
                     for (unsigned j = 0; j < src.cols; ++j) {
-                        dest[i][j] = static_cast<field_type>(src[i][j]);
+                        (*dest)[i][j] = static_cast<field_type>(src[i][j]);
                     }
                 }
             }
@@ -286,7 +343,7 @@ public:
         peerIt = peerSet.begin();
         for (; peerIt != peerEndIt; ++peerIt) {
             ProcessRank peerRank = *peerIt;
-            entryValuesSendBuff_[peerRank]->wait();
+            peerSendEntries_[peerRank].values.wait();
         }
     }
 
@@ -317,7 +374,7 @@ public:
         peerIt = peerSet.begin();
         for (; peerIt != peerEndIt; ++peerIt) {
             ProcessRank peerRank = *peerIt;
-            entryValuesSendBuff_[peerRank]->wait();
+            peerSendEntries_[peerRank].values.wait();
         }
     }
 
@@ -333,6 +390,31 @@ private:
 
         // communicate the entries
         buildIndices_(nativeMatrix);
+
+        partitionRows_();
+    }
+
+    // split the rows into the ones which are sent to peer processes and the remaining
+    // ones, so that the communication of a vector can be overlapped with the
+    // computation of the latter
+    void partitionRows_()
+    {
+        const size_t numDomestic = overlap_->numDomestic();
+        std::vector<unsigned char> isBorderRow(numDomestic, 0);
+        for (const auto peerRank : overlap_->peerSet()) {
+            const size_t numEntries = overlap_->foreignOverlapSize(peerRank);
+            for (unsigned i = 0; i < numEntries; ++i)
+                isBorderRow[static_cast<size_t>(overlap_->foreignOverlapOffsetToDomesticIdx(peerRank, i))] = 1;
+        }
+
+        borderRows_.clear();
+        interiorRows_.clear();
+        for (unsigned rowIdx = 0; rowIdx < numDomestic; ++rowIdx) {
+            if (isBorderRow[rowIdx])
+                borderRows_.push_back(rowIdx);
+            else
+                interiorRows_.push_back(rowIdx);
+        }
     }
 
     template <class NativeBCRSMatrix>
@@ -341,7 +423,8 @@ private:
         /////////
         // first, add all local matrix entries
         /////////
-        entries_.resize(overlap_->numDomestic());
+        EntryIndices entries;
+        entries.reserve(nativeMatrix.nonzeroes());
         for (unsigned nativeRowIdx = 0; nativeRowIdx < nativeMatrix.N(); ++nativeRowIdx) {
             int domesticRowIdx = overlap_->nativeToDomestic(static_cast<Index>(nativeRowIdx));
             if (domesticRowIdx < 0)
@@ -362,7 +445,7 @@ private:
                 if (domesticColIdx < 0)
                     continue;
 
-                entries_[static_cast<unsigned>(domesticRowIdx)].insert(domesticColIdx);
+                entries.emplace_back(domesticRowIdx, domesticColIdx);
             }
         }
 
@@ -371,19 +454,21 @@ private:
         /////////
 
         // first, send all our indices to all peers
+        std::map<ProcessRank, MpiBuffer<unsigned> > sizesSendBuff;
+        std::map<ProcessRank, MpiBuffer<Index> > indicesSendBuff;
         const PeerSet& peerSet = overlap_->peerSet();
         typename PeerSet::const_iterator peerIt = peerSet.begin();
         typename PeerSet::const_iterator peerEndIt = peerSet.end();
         for (; peerIt != peerEndIt; ++peerIt) {
             ProcessRank peerRank = *peerIt;
-            sendIndices_(nativeMatrix, peerRank);
+            sendIndices_(nativeMatrix, peerRank, sizesSendBuff[peerRank], indicesSendBuff[peerRank]);
         }
 
         // then recieve all indices from the peers
         peerIt = peerSet.begin();
         for (; peerIt != peerEndIt; ++peerIt) {
             ProcessRank peerRank = *peerIt;
-            receiveIndices_(peerRank);
+            receiveIndices_(peerRank, entries);
         }
 
         // wait until all send operations are completed
@@ -391,90 +476,65 @@ private:
         for (; peerIt != peerEndIt; ++peerIt) {
             ProcessRank peerRank = *peerIt;
 
-            numRowsSendBuff_[peerRank]->wait();
-            rowSizesSendBuff_[peerRank]->wait();
-            rowIndicesSendBuff_[peerRank]->wait();
-            entryColIndicesSendBuff_[peerRank]->wait();
-
-            // convert the global indices in the send buffers to domestic
-            // ones
-            globalToDomesticBuff_(*rowIndicesSendBuff_[peerRank]);
-            globalToDomesticBuff_(*entryColIndicesSendBuff_[peerRank]);
+            sizesSendBuff[peerRank].wait();
+            indicesSendBuff[peerRank].wait();
         }
 
         /////////
         // actually initialize the BCRS matrix structure
         /////////
 
+        // sort the entries by row and column index and remove the duplicates
+        std::sort(entries.begin(), entries.end());
+        entries.erase(std::unique(entries.begin(), entries.end()), entries.end());
+
         // set the row sizes
         size_t numDomestic = overlap_->numDomestic();
-        for (unsigned rowIdx = 0; rowIdx < numDomestic; ++rowIdx) {
-            unsigned numCols = 0;
-            const auto& colIndices = entries_[rowIdx];
-            auto colIdxIt = colIndices.begin();
-            const auto& colIdxEndIt = colIndices.end();
-            for (; colIdxIt != colIdxEndIt; ++colIdxIt) {
-                if (*colIdxIt < 0)
-                    // the matrix for the local process does not know about this DOF
-                    continue;
-
-                ++numCols;
-            }
-
-            this->setrowsize(rowIdx, numCols);
-        }
+        std::vector<unsigned> rowSizes(numDomestic, 0);
+        for (const auto& entry : entries)
+            ++rowSizes[static_cast<unsigned>(entry.first)];
+        for (unsigned rowIdx = 0; rowIdx < numDomestic; ++rowIdx)
+            this->setrowsize(rowIdx, rowSizes[rowIdx]);
         this->endrowsizes();
 
         // set the indices
-        for (unsigned rowIdx = 0; rowIdx < numDomestic; ++rowIdx) {
-            const auto& colIndices = entries_[rowIdx];
-
-            auto colIdxIt = colIndices.begin();
-            const auto& colIdxEndIt = colIndices.end();
-            for (; colIdxIt != colIdxEndIt; ++colIdxIt) {
-                if (*colIdxIt < 0)
-                    // the matrix for the local process does not know about this DOF
-                    continue;
-
-                this->addindex(rowIdx, static_cast<unsigned>(*colIdxIt));
-            }
-        }
+        for (const auto& entry : entries)
+            this->addindex(static_cast<unsigned>(entry.first), static_cast<unsigned>(entry.second));
         this->endindices();
 
-        // free the memory occupied by the array of the matrix entries
-        entries_.clear();
+        // determine the entries which are exchanged with the peers
+        mapPeerEntries_(peerSendEntries_);
+        mapPeerEntries_(peerRecvEntries_);
     }
 
     // send the overlap indices to a peer
+    //
+    // the global indices of the rows, the number of entries of each row and the global
+    // column indices of the entries are sent using a single message which is preceeded
+    // by a message containing the number of rows and entries.
     template <class NativeBCRSMatrix>
     void sendIndices_([[maybe_unused]] const NativeBCRSMatrix& nativeMatrix,
-                      [[maybe_unused]] ProcessRank peerRank)
+                      [[maybe_unused]] ProcessRank peerRank,
+                      [[maybe_unused]] MpiBuffer<unsigned>& sizesSendBuff,
+                      [[maybe_unused]] MpiBuffer<Index>& indicesSendBuff)
     {
 #if HAVE_MPI
-        // send size of foreign overlap to peer
         size_t numOverlapRows = overlap_->foreignOverlapSize(peerRank);
-        numRowsSendBuff_[peerRank] = new MpiBuffer<unsigned>(1);
-        (*numRowsSendBuff_[peerRank])[0] = static_cast<unsigned>(numOverlapRows);
-        numRowsSendBuff_[peerRank]->send(peerRank);
 
-        // allocate the buffers which hold the global indices of each row and the number
-        // of entries which need to be communicated by the respective row
-        rowIndicesSendBuff_[peerRank] = new MpiBuffer<Index>(numOverlapRows);
-        rowSizesSendBuff_[peerRank] = new MpiBuffer<unsigned>(numOverlapRows);
+        auto& peerEntries = peerSendEntries_[peerRank];
+        peerEntries.indices.clear();
 
-        // compute the sets of the indices of the entries which need to be send to the peer
-        using ColumnIndexSet = std::set<int>;
-        using EntryTuples = std::map<int, ColumnIndexSet>;
-
-        EntryTuples entryIndices;
-        unsigned numEntries = 0; // <- total number of matrix entries to be send to the peer
+        // compute the global indices of the entries which need to be send to the peer
+        std::vector<Index> globalRowIndices(numOverlapRows);
+        std::vector<Index> rowSizes(numOverlapRows);
+        std::vector<Index> globalColIndices;
+        EntryIndices rowEntries; // <- the (global, domestic) column indices of a row
         for (unsigned overlapOffset = 0; overlapOffset < numOverlapRows; ++overlapOffset) {
             Index domesticRowIdx = overlap_->foreignOverlapOffsetToDomesticIdx(peerRank, overlapOffset);
             Index nativeRowIdx = overlap_->domesticToNative(domesticRowIdx);
-            Index globalRowIdx = overlap_->domesticToGlobal(domesticRowIdx);
-
-            ColumnIndexSet& colIndices = entryIndices[globalRowIdx];
+            globalRowIndices[overlapOffset] = overlap_->domesticToGlobal(domesticRowIdx);
 
+            rowEntries.clear();
             auto nativeColIt = nativeMatrix[static_cast<unsigned>(nativeRowIdx)].begin();
             const auto& nativeColEndIt = nativeMatrix[static_cast<unsigned>(nativeRowIdx)].end();
             for (; nativeColIt != nativeColEndIt; ++nativeColIt) {
@@ -492,198 +552,224 @@ private:
                     // entry.
                     continue;
 
-                Index globalColIdx = overlap_->domesticToGlobal(domesticColIdx);
-                colIndices.insert(globalColIdx);
-                ++numEntries;
+                rowEntries.emplace_back(overlap_->domesticToGlobal(domesticColIdx), domesticColIdx);
             }
-        };
 
-        // fill the send buffers
-        entryColIndicesSendBuff_[peerRank] = new MpiBuffer<Index>(numEntries);
-        Index overlapEntryIdx = 0;
-        for (unsigned overlapOffset = 0; overlapOffset < numOverlapRows; ++overlapOffset) {
-            Index domesticRowIdx = overlap_->foreignOverlapOffsetToDomesticIdx(peerRank, overlapOffset);
-            Index globalRowIdx = overlap_->domesticToGlobal(domesticRowIdx);
-
-            (*rowIndicesSendBuff_[peerRank])[overlapOffset] = globalRowIdx;
+            // the entries of a row are sent in the order of their global column indices
+            std::sort(rowEntries.begin(), rowEntries.end());
+            rowEntries.erase(std::unique(rowEntries.begin(), rowEntries.end()), rowEntries.end());
 
-            const ColumnIndexSet& colIndexSet = entryIndices[globalRowIdx];
-            auto* rssb = rowSizesSendBuff_[peerRank];
-            (*rssb)[overlapOffset] = static_cast<unsigned>(colIndexSet.size());
-            for (auto it = colIndexSet.begin(); it != colIndexSet.end(); ++it) {
-                int globalColIdx = *it;
-
-                (*entryColIndicesSendBuff_[peerRank])[static_cast<unsigned>(overlapEntryIdx)] = globalColIdx;
-                ++ overlapEntryIdx;
+            rowSizes[overlapOffset] = static_cast<Index>(rowEntries.size());
+            for (const auto& colEntry : rowEntries) {
+                globalColIndices.push_back(colEntry.first);
+                peerEntries.indices.emplace_back(domesticRowIdx, colEntry.second);
             }
         }
 
-        // actually communicate with the peer
-        rowSizesSendBuff_[peerRank]->send(peerRank);
-        rowIndicesSendBuff_[peerRank]->send(peerRank);
-        entryColIndicesSendBuff_[peerRank]->send(peerRank);
-
-        // create the send buffers for the values of the matrix
-        // entries
-        entryValuesSendBuff_[peerRank] = new MpiBuffer<block_type>(numEntries);
+        // fill the send buffers and actually communicate with the peer
+        sizesSendBuff.resize(2);
+        sizesSendBuff[0] = static_cast<unsigned>(numOverlapRows);
+        sizesSendBuff[1] = static_cast<unsigned>(globalColIndices.size());
+        sizesSendBuff.send(peerRank);
+
+        indicesSendBuff.resize(2*numOverlapRows + globalColIndices.size());
+        size_t bufferIdx = 0;
+        for (Index globalRowIdx : globalRowIndices)
+            indicesSendBuff[bufferIdx++] = globalRowIdx;
+        for (Index rowSize : rowSizes)
+            indicesSendBuff[bufferIdx++] = rowSize;
+        for (Index globalColIdx : globalColIndices)
+            indicesSendBuff[bufferIdx++] = globalColIdx;
+        indicesSendBuff.send(peerRank);
+
+        // create the send buffer for the values of the matrix entries
+        peerEntries.values.resize(globalColIndices.size());
 #endif // HAVE_MPI
     }
 
-    // receive the overlap indices to a peer
-    void receiveIndices_([[maybe_unused]] ProcessRank peerRank)
+    // receive the overlap indices from a peer and add the entries to the ones of the
+    // local process
+    void receiveIndices_([[maybe_unused]] ProcessRank peerRank,
+                         [[maybe_unused]] EntryIndices& entries)
     {
 #if HAVE_MPI
-        // receive size of foreign overlap to peer
-        unsigned numOverlapRows;
-        auto& numRowsRecvBuff = numRowsRecvBuff_[peerRank];
-        numRowsRecvBuff.resize(1);
-        numRowsRecvBuff.receive(peerRank);
-        numOverlapRows = numRowsRecvBuff[0];
-
-        // create receive buffer for the row sizes and receive them
-        // from the peer
-        rowSizesRecvBuff_[peerRank] = new MpiBuffer<unsigned>(numOverlapRows);
-        rowIndicesRecvBuff_[peerRank] = new MpiBuffer<Index>(numOverlapRows);
-        rowSizesRecvBuff_[peerRank]->receive(peerRank);
-        rowIndicesRecvBuff_[peerRank]->receive(peerRank);
-
-        // calculate the total number of indices which are send by the
-        // peer
-        unsigned totalIndices = 0;
-        for (unsigned i = 0; i < numOverlapRows; ++i)
-            totalIndices += (*rowSizesRecvBuff_[peerRank])[i];
-
-        // create the buffer to store the column indices of the matrix entries
-        entryColIndicesRecvBuff_[peerRank] = new MpiBuffer<Index>(totalIndices);
-        entryValuesRecvBuff_[peerRank] = new MpiBuffer<block_type>(totalIndices);
-
-        // communicate with the peer
-        entryColIndicesRecvBuff_[peerRank]->receive(peerRank);
-
-        // convert the global indices in the receive buffers to
-        // domestic ones
-        globalToDomesticBuff_(*rowIndicesRecvBuff_[peerRank]);
-        globalToDomesticBuff_(*entryColIndicesRecvBuff_[peerRank]);
-
-        // add the entries to the global entry map
-        unsigned k = 0;
-        for (unsigned i = 0; i < numOverlapRows; ++i) {
-            Index domRowIdx = (*rowIndicesRecvBuff_[peerRank])[i];
-            for (unsigned j = 0; j < (*rowSizesRecvBuff_[peerRank])[i]; ++j) {
-                Index domColIdx = (*entryColIndicesRecvBuff_[peerRank])[k];
-                entries_[static_cast<unsigned>(domRowIdx)].insert(domColIdx);
-                ++k;
+        // receive the number of rows and entries in the foreign overlap of the peer
+        MpiBuffer<unsigned> sizesRecvBuff(2);
+        sizesRecvBuff.receive(peerRank);
+        size_t numOverlapRows = sizesRecvBuff[0];
+        size_t numEntries = sizesRecvBuff[1];
+
+        // receive the global row indices, the row sizes and the global column indices
+        MpiBuffer<Index> indicesRecvBuff(2*numOverlapRows + numEntries);
+        indicesRecvBuff.receive(peerRank);
+
+        // convert the global indices to domestic ones and add the entries to the
+        // global entry list
+        auto& peerEntries = peerRecvEntries_[peerRank];
+        peerEntries.indices.clear();
+        peerEntries.indices.reserve(numEntries);
+        size_t colBufferIdx = 2*numOverlapRows;
+        for (size_t i = 0; i < numOverlapRows; ++i) {
+            Index domRowIdx = overlap_->globalToDomestic(indicesRecvBuff[i]);
+            size_t rowSize = static_cast<size_t>(indicesRecvBuff[numOverlapRows + i]);
+            for (size_t j = 0; j < rowSize; ++j, ++colBufferIdx) {
+                Index domColIdx = overlap_->globalToDomestic(indicesRecvBuff[colBufferIdx]);
+                peerEntries.indices.emplace_back(domRowIdx, domColIdx);
+
+                if (domColIdx < 0)
+                    // the matrix for the local process does not know about this DOF
+                    continue;
+
+                entries.emplace_back(domRowIdx, domColIdx);
             }
         }
+
+        // create the receive buffer for the values of the matrix entries
+        peerEntries.values.resize(numEntries);
 #endif // HAVE_MPI
     }
 
+    // determine the matrix entries which correspond to the indices of the entries
+    // exchanged with each peer
+    void mapPeerEntries_(std::map<ProcessRank, PeerEntries>& allPeerEntries)
+    {
+        for (auto& peerEntriesPair : allPeerEntries) {
+            PeerEntries& peerEntries = peerEntriesPair.second;
+
+            peerEntries.entries.clear();
+            peerEntries.entries.reserve(peerEntries.indices.size());
+            for (const auto& entry : peerEntries.indices) {
+                if (entry.second < 0)
+                    peerEntries.entries.push_back(nullptr);
+                else
+                    peerEntries.entries.push_back(&(*this)[static_cast<unsigned>(entry.first)][static_cast<unsigned>(entry.second)]);
+            }
+
+            // free the memory occupied by the indices
+            EntryIndices().swap(peerEntries.indices);
+        }
+    }
+
     void sendEntries_([[maybe_unused]] ProcessRank peerRank)
     {
 #if HAVE_MPI
-        auto &mpiSendBuff = *entryValuesSendBuff_[peerRank];
-
-        auto &mpiRowIndicesSendBuff = *rowIndicesSendBuff_[peerRank];
-        auto &mpiRowSizesSendBuff = *rowSizesSendBuff_[peerRank];
-        auto &mpiColIndicesSendBuff = *entryColIndicesSendBuff_[peerRank];
+        auto& peerEntries = peerSendEntries_[peerRank];
 
         // fill the send buffer
-        unsigned k = 0;
-        for (unsigned i = 0; i < mpiRowIndicesSendBuff.size(); ++i) {
-            Index domRowIdx = mpiRowIndicesSendBuff[i];
-
-            for (Index j = 0; j < static_cast<Index>(mpiRowSizesSendBuff[i]); ++j)
-            {
-                // move to the next column which is in the overlap
-                Index domColIdx = mpiColIndicesSendBuff[k];
-
-                // add the values of this column to the send buffer
-                mpiSendBuff[k] = (*this)[static_cast<unsigned>(domRowIdx)][static_cast<unsigned>(domColIdx)];
-                ++k;
-            }
-        }
+        for (size_t k = 0; k < peerEntries.entries.size(); ++k)
+            peerEntries.values[k] = *peerEntries.entries[k];
 
-        mpiSendBuff.send(peerRank);
+        peerEntries.values.send(peerRank);
 #endif // HAVE_MPI
     }
 
     void receiveAddEntries_([[maybe_unused]] ProcessRank peerRank)
     {
 #if HAVE_MPI
-        auto &mpiRecvBuff = *entryValuesRecvBuff_[peerRank];
-
-        auto &mpiRowIndicesRecvBuff = *rowIndicesRecvBuff_[peerRank];
-        auto &mpiRowSizesRecvBuff = *rowSizesRecvBuff_[peerRank];
-        auto &mpiColIndicesRecvBuff = *entryColIndicesRecvBuff_[peerRank];
+        auto& peerEntries = peerRecvEntries_[peerRank];
 
-        mpiRecvBuff.receive(peerRank);
+        peerEntries.values.receive(peerRank);
 
         // retrieve the values from the receive buffer
-        unsigned k = 0;
-        for (unsigned i = 0; i < mpiRowIndicesRecvBuff.size(); ++i) {
-            Index domRowIdx = mpiRowIndicesRecvBuff[i];
-            for (unsigned j = 0; j < mpiRowSizesRecvBuff[i]; ++j, ++k) {
-                Index domColIdx = mpiColIndicesRecvBuff[k];
-
-                if (domColIdx < 0)
-                    // the matrix for the current process does not know about this DOF
-                    continue;
+        for (size_t k = 0; k < peerEntries.entries.size(); ++k) {
+            if (!peerEntries.entries[k])
+                // the matrix for the current process does not know about this DOF
+                continue;
 
-                (*this)[static_cast<unsigned>(domRowIdx)][static_cast<unsigned>(domColIdx)] += mpiRecvBuff[k];
-            }
+            *peerEntries.entries[k] += peerEntries.values[k];
         }
 #endif // HAVE_MPI
     }
 
-    void receiveCopyEntries_([[maybe_unused]] int peerRank)
+    void receiveCopyEntries_([[maybe_unused]] ProcessRank peerRank)
     {
 #if HAVE_MPI
-        MpiBuffer<block_type> &mpiRecvBuff = *entryValuesRecvBuff_[peerRank];
-
-        MpiBuffer<Index> &mpiRowIndicesRecvBuff = *rowIndicesRecvBuff_[peerRank];
-        MpiBuffer<unsigned> &mpiRowSizesRecvBuff = *rowSizesRecvBuff_[peerRank];
-        MpiBuffer<Index> &mpiColIndicesRecvBuff = *entryColIndicesRecvBuff_[peerRank];
+        auto& peerEntries = peerRecvEntries_[peerRank];
 
-        mpiRecvBuff.receive(peerRank);
+        peerEntries.values.receive(peerRank);
 
         // retrieve the values from the receive buffer
-        unsigned k = 0;
-        for (unsigned i = 0; i < mpiRowIndicesRecvBuff.size(); ++i) {
-            Index domRowIdx = mpiRowIndicesRecvBuff[i];
-            for (unsigned j = 0; j < mpiRowSizesRecvBuff[i]; ++j, ++k) {
-                Index domColIdx = mpiColIndicesRecvBuff[k];
-
-                if (domColIdx < 0)
-                    // the matrix for the current process does not know about this DOF
-                    continue;
+        for (size_t k = 0; k < peerEntries.entries.size(); ++k) {
+            if (!peerEntries.entries[k])
+                // the matrix for the current process does not know about this DOF
+                continue;
 
-                (*this)[static_cast<unsigned>(domRowIdx)][static_cast<unsigned>(domColIdx)] = mpiRecvBuff[k];
-            }
+            *peerEntries.entries[k] = peerEntries.values[k];
         }
 #endif // HAVE_MPI
     }
 
-    void globalToDomesticBuff_(MpiBuffer<Index>& idxBuff)
+    // determine the entry of the overlapping matrix which corresponds to each entry
+    // of a non-overlapping matrix and the entries which do not correspond to any
+    template <class NativeBCRSMatrix>
+    void mapNativeEntries_(const NativeBCRSMatrix& nativeMatrix)
     {
-        for (unsigned i = 0; i < idxBuff.size(); ++i)
-            idxBuff[i] = overlap_->globalToDomestic(idxBuff[i]);
+        nativeEntries_.clear();
+        nativeEntries_.reserve(nativeMatrix.nonzeroes());
+        for (unsigned nativeRowIdx = 0; nativeRowIdx < nativeMatrix.N(); ++nativeRowIdx) {
+            Index domesticRowIdx = overlap_->nativeToDomestic(static_cast<Index>(nativeRowIdx));
+
+            auto nativeColIt = nativeMatrix[nativeRowIdx].begin();
+            const auto& nativeColEndIt = nativeMatrix[nativeRowIdx].end();
+            for (; nativeColIt != nativeColEndIt; ++nativeColIt) {
+                if (domesticRowIdx < 0) {
+                    // row corresponds to a black-listed entry
+                    nativeEntries_.push_back(nullptr);
+                    continue;
+                }
+
+                Index domesticColIdx = overlap_->nativeToDomestic(static_cast<Index>(nativeColIt.index()));
+
+                // make sure to include all off-diagonal entries, even those which belong
+                // to DOFs which are managed by a peer process. For this, we have to
+                // re-map the column index of the black-listed index to a native one.
+                if (domesticColIdx < 0)
+                    domesticColIdx = overlap_->blackList().nativeToDomestic(static_cast<Index>(nativeColIt.index()));
+
+                if (domesticColIdx < 0) {
+                    // there is no domestic index which corresponds to a black-listed
+                    // one. this can happen if the grid overlap is larger than the
+                    // algebraic one...
+                    nativeEntries_.push_back(nullptr);
+                    continue;
+                }
+
+                nativeEntries_.push_back(&(*this)[static_cast<unsigned>(domesticRowIdx)][static_cast<unsigned>(domesticColIdx)]);
+            }
+        }
+
+        std::vector<const block_type*> mappedEntries;
+        for (const block_type* entry : nativeEntries_)
+            if (entry)
+                mappedEntries.push_back(entry);
+        std::sort(mappedEntries.begin(), mappedEntries.end(), std::less<const block_type*>());
+
+        unmappedEntries_.clear();
+        for (auto rowIt = this->begin(); rowIt != this->end(); ++rowIt) {
+            for (auto colIt = rowIt->begin(); colIt != rowIt->end(); ++colIt) {
+                block_type* entry = &(*colIt);
+                if (!std::binary_search(mappedEntries.begin(), mappedEntries.end(), entry,
+                                        std::less<const block_type*>()))
+                    unmappedEntries_.push_back(entry);
+            }
+        }
     }
 
     int myRank_;
-    Entries entries_;
     std::shared_ptr<Overlap> overlap_;
 
-    std::map<ProcessRank, MpiBuffer<unsigned> *> numRowsSendBuff_;
-    std::map<ProcessRank, MpiBuffer<unsigned> *> rowSizesSendBuff_;
-    std::map<ProcessRank, MpiBuffer<Index> *> rowIndicesSendBuff_;
-    std::map<ProcessRank, MpiBuffer<Index> *> entryColIndicesSendBuff_;
-    std::map<ProcessRank, MpiBuffer<block_type> *> entryValuesSendBuff_;
-
-    std::map<ProcessRank, MpiBuffer<unsigned> > numRowsRecvBuff_;
-    std::map<ProcessRank, MpiBuffer<unsigned> *> rowSizesRecvBuff_;
-    std::map<ProcessRank, MpiBuffer<Index> *> rowIndicesRecvBuff_;
-    std::map<ProcessRank, MpiBuffer<Index> *> entryColIndicesRecvBuff_;
-    std::map<ProcessRank, MpiBuffer<block_type> *> entryValuesRecvBuff_;
+    std::vector<unsigned> borderRows_;
+    std::vector<unsigned> interiorRows_;
+
+    // the entries of the overlapping matrix which correspond to the entries of the
+    // non-overlapping matrix in the order of the latter (nullptr if an entry is not
+    // part of the overlapping matrix) and the entries which do not correspond to any
+    std::vector<block_type*> nativeEntries_;
+    std::vector<block_type*> unmappedEntries_;
+
+    // the matrix entries which are sent to and received from the peer processes
+    std::map<ProcessRank, PeerEntries> peerSendEntries_;
+    std::map<ProcessRank, PeerEntries> peerRecvEntries_;
 };
 
 } // namespace Linear
@@ -36,8 +36,8 @@
 #include <dune/common/fvector.hh>
 
 #include <memory>
-#include <map>
 #include <iostream>
+#include <vector>
 
 namespace Opm {
 namespace Linear {
@@ -65,11 +65,7 @@ public:
      */
     OverlappingBlockVector(const OverlappingBlockVector& obv)
         : ParentType(obv)
-        , numIndicesSendBuff_(obv.numIndicesSendBuff_)
-        , indicesSendBuff_(obv.indicesSendBuff_)
-        , indicesRecvBuff_(obv.indicesRecvBuff_)
-        , valuesSendBuff_(obv.valuesSendBuff_)
-        , valuesRecvBuff_(obv.valuesRecvBuff_)
+        , pattern_(obv.pattern_)
         , overlap_(obv.overlap_)
     {}
 
@@ -92,11 +88,7 @@ public:
     OverlappingBlockVector& operator=(const OverlappingBlockVector& obv)
     {
         ParentType::operator=(obv);
-        numIndicesSendBuff_ = obv.numIndicesSendBuff_;
-        indicesSendBuff_ = obv.indicesSendBuff_;
-        indicesRecvBuff_ = obv.indicesRecvBuff_;
-        valuesSendBuff_ = obv.valuesSendBuff_;
-        valuesRecvBuff_ = obv.valuesRecvBuff_;
+        pattern_ = obv.pattern_;
         overlap_ = obv.overlap_;
         return *this;
     }
@@ -174,16 +166,32 @@ public:
      */
     void sync()
     {
-        // send all entries to all peers
-        for (const auto peerRank: overlap_->peerSet())
-            sendEntries_(peerRank);
+        startSync();
+        finishSync();
+    }
+
+    /*!
+     * \brief Start to syncronize the values of the block vector from their master
+     *        process.
+     *
+     * This sends the values of the rows in the overlap of the peer ranks and starts to
+     * receive the values of the rows in the local overlap. Only the latter rows may be
+     * modified until finishSync() is called.
+     */
+    void startSync()
+    { startCommunication_(); }
 
-        // recieve all entries to the peers
-        for (const auto peerRank: overlap_->peerSet())
-            receiveFromMaster_(peerRank);
+    /*!
+     * \brief Complete the syncronization which was started by startSync().
+     */
+    void finishSync()
+    {
+        waitCommunication_();
 
-        // wait until we have send everything
-        waitSendFinished_();
+        const SyncPattern& pattern = *pattern_;
+        for (size_t i = 0; i < pattern.recvRows.size(); ++i)
+            if (pattern.recvFromMaster[i])
+                (*this)[pattern.recvRows[i]] = pattern.recvValues[i];
     }
 
     /*!
@@ -192,16 +200,13 @@ public:
      */
     void syncAdd()
     {
-        // send all entries to all peers
-        for (const auto peerRank: overlap_->peerSet())
-            sendEntries_(peerRank);
+        startCommunication_();
+        waitCommunication_();
 
-        // recieve all entries to the peers
-        for (const auto peerRank: overlap_->peerSet())
-            receiveAdd_(peerRank);
-
-        // wait until we have send everything
-        waitSendFinished_();
+        // add up the values of rows on the shared boundary
+        const SyncPattern& pattern = *pattern_;
+        for (size_t i = 0; i < pattern.recvRows.size(); ++i)
+            (*this)[pattern.recvRows[i]] += pattern.recvValues[i];
     }
 
     void print() const
@@ -213,146 +218,176 @@ public:
     }
 
 private:
-    void createBuffers_()
+    // The communication pattern of the vector. It is determined once when the vector is
+    // created and it is shared by all copies of the vector. The rows which are
+    // exchanged with the peer ranks are stored contiguously, the ones of the i-th peer
+    // at the positions [offsets[i], offsets[i + 1]). The messages use persistent MPI
+    // requests, so a syncronization only needs to start and to complete them.
+    struct SyncPattern
     {
+        SyncPattern() = default;
+        SyncPattern(const SyncPattern&) = delete;
+        SyncPattern& operator=(const SyncPattern&) = delete;
+
+        ~SyncPattern()
+        {
+#if HAVE_MPI
+            int finalized;
+            MPI_Finalized(&finalized);
+            if (!finalized) {
+                for (auto& request : requests)
+                    MPI_Request_free(&request);
+            }
+#endif // HAVE_MPI
+        }
+
+        std::vector<ProcessRank> peerRanks;
+
+        // the domestic indices of the rows which are sent to the peers
+        std::vector<unsigned> sendRows;
+        std::vector<size_t> sendOffsets;
+        std::vector<FieldVector> sendValues;
+
+        // the domestic indices of the rows which are received from the peers and
+        // whether the peer is the master of the row
+        std::vector<unsigned> recvRows;
+        std::vector<unsigned char> recvFromMaster;
+        std::vector<size_t> recvOffsets;
+        std::vector<FieldVector> recvValues;
+
 #if HAVE_MPI
-        // create array for the front indices
-        typename PeerSet::const_iterator peerIt;
-        typename PeerSet::const_iterator peerEndIt = overlap_->peerSet().end();
+        // the receive requests of all peers followed by the send requests
+        std::vector<MPI_Request> requests;
+#endif // HAVE_MPI
+    };
 
-        // send all indices to the peers
-        peerIt = overlap_->peerSet().begin();
-        for (; peerIt != peerEndIt; ++peerIt) {
-            ProcessRank peerRank = *peerIt;
+    void createBuffers_()
+    {
+        pattern_ = std::make_shared<SyncPattern>();
+        SyncPattern& pattern = *pattern_;
 
-            size_t numEntries = overlap_->foreignOverlapSize(peerRank);
-            numIndicesSendBuff_[peerRank] = std::make_shared<MpiBuffer<unsigned> >(1);
-            indicesSendBuff_[peerRank] = std::make_shared<MpiBuffer<Index> >(numEntries);
-            valuesSendBuff_[peerRank] = std::make_shared<MpiBuffer<FieldVector> >(numEntries);
+        const PeerSet& peerSet = overlap_->peerSet();
+        pattern.peerRanks.assign(peerSet.begin(), peerSet.end());
+        const size_t numPeers = pattern.peerRanks.size();
 
-            // fill the indices buffer with global indices
-            MpiBuffer<Index>& indicesSendBuff = *indicesSendBuff_[peerRank];
+        // the rows which are sent to a peer are the ones in its foreign overlap
+        pattern.sendOffsets.resize(numPeers + 1, 0);
+        for (size_t peerIdx = 0; peerIdx < numPeers; ++peerIdx) {
+            ProcessRank peerRank = pattern.peerRanks[peerIdx];
+            size_t numEntries = overlap_->foreignOverlapSize(peerRank);
             for (unsigned i = 0; i < numEntries; ++i) {
                 Index domRowIdx = overlap_->foreignOverlapOffsetToDomesticIdx(peerRank, i);
-                indicesSendBuff[i] = overlap_->domesticToGlobal(domRowIdx);
+                pattern.sendRows.push_back(static_cast<unsigned>(domRowIdx));
             }
+            pattern.sendOffsets[peerIdx + 1] = pattern.sendRows.size();
+        }
+        pattern.recvOffsets.resize(numPeers + 1, 0);
+
+#if HAVE_MPI
+        // tell the peers which rows they receive. since the domestic indices of the
+        // processes differ, the global indices are sent.
+        std::vector<std::unique_ptr<MpiBuffer<unsigned> > > numIndicesSendBuff(numPeers);
+        std::vector<std::unique_ptr<MpiBuffer<Index> > > indicesSendBuff(numPeers);
+        for (size_t peerIdx = 0; peerIdx < numPeers; ++peerIdx) {
+            ProcessRank peerRank = pattern.peerRanks[peerIdx];
+            size_t offset = pattern.sendOffsets[peerIdx];
+            size_t numEntries = pattern.sendOffsets[peerIdx + 1] - offset;
 
             // first, send the number of indices
-            (*numIndicesSendBuff_[peerRank])[0] = static_cast<unsigned>(numEntries);
-            numIndicesSendBuff_[peerRank]->send(peerRank);
+            numIndicesSendBuff[peerIdx] = std::make_unique<MpiBuffer<unsigned> >(1);
+            (*numIndicesSendBuff[peerIdx])[0] = static_cast<unsigned>(numEntries);
+            numIndicesSendBuff[peerIdx]->send(peerRank);
 
             // then, send the indices themselfs
-            indicesSendBuff.send(peerRank);
+            indicesSendBuff[peerIdx] = std::make_unique<MpiBuffer<Index> >(numEntries);
+            for (size_t i = 0; i < numEntries; ++i) {
+                Index domRowIdx = static_cast<Index>(pattern.sendRows[offset + i]);
+                (*indicesSendBuff[peerIdx])[i] = overlap_->domesticToGlobal(domRowIdx);
+            }
+            indicesSendBuff[peerIdx]->send(peerRank);
         }
 
-        // receive the indices from the peers
-        peerIt = overlap_->peerSet().begin();
-        for (; peerIt != peerEndIt; ++peerIt) {
-            ProcessRank peerRank = *peerIt;
+        // receive the indices from the peers and translate them to domestic ones
+        for (size_t peerIdx = 0; peerIdx < numPeers; ++peerIdx) {
+            ProcessRank peerRank = pattern.peerRanks[peerIdx];
 
-            // receive size of overlap to peer
             MpiBuffer<unsigned> numRowsRecvBuff(1);
             numRowsRecvBuff.receive(peerRank);
             unsigned numRows = numRowsRecvBuff[0];
 
-            // then, create the MPI buffers
-            indicesRecvBuff_[peerRank] = std::shared_ptr<MpiBuffer<Index> >(
-                new MpiBuffer<Index>(numRows));
-            valuesRecvBuff_[peerRank] = std::shared_ptr<MpiBuffer<FieldVector> >(
-                new MpiBuffer<FieldVector>(numRows));
-            MpiBuffer<Index>& indicesRecvBuff = *indicesRecvBuff_[peerRank];
-
-            // next, receive the actual indices
+            MpiBuffer<Index> indicesRecvBuff(numRows);
             indicesRecvBuff.receive(peerRank);
-
-            // finally, translate the global indices to domestic ones
             for (unsigned i = 0; i != numRows; ++i) {
-                Index globalRowIdx = indicesRecvBuff[i];
-                Index domRowIdx = overlap_->globalToDomestic(globalRowIdx);
-
-                indicesRecvBuff[i] = domRowIdx;
+                Index domRowIdx = overlap_->globalToDomestic(indicesRecvBuff[i]);
+                pattern.recvRows.push_back(static_cast<unsigned>(domRowIdx));
+                pattern.recvFromMaster.push_back(overlap_->masterRank(domRowIdx) == peerRank);
             }
+            pattern.recvOffsets[peerIdx + 1] = pattern.recvRows.size();
         }
 
         // wait for all send operations to complete
-        peerIt = overlap_->peerSet().begin();
-        for (; peerIt != peerEndIt; ++peerIt) {
-            ProcessRank peerRank = *peerIt;
-            numIndicesSendBuff_[peerRank]->wait();
-            indicesSendBuff_[peerRank]->wait();
-
-            // convert the global indices of the send buffer to
-            // domestic ones
-            MpiBuffer<Index>& indicesSendBuff = *indicesSendBuff_[peerRank];
-            for (unsigned i = 0; i < indicesSendBuff.size(); ++i) {
-                indicesSendBuff[i] = overlap_->globalToDomestic(indicesSendBuff[i]);
-            }
+        for (size_t peerIdx = 0; peerIdx < numPeers; ++peerIdx) {
+            numIndicesSendBuff[peerIdx]->wait();
+            indicesSendBuff[peerIdx]->wait();
         }
-#endif // HAVE_MPI
-    }
-
-    void sendEntries_(ProcessRank peerRank)
-    {
-        // copy the values into the send buffer
-        const MpiBuffer<Index>& indices = *indicesSendBuff_[peerRank];
-        MpiBuffer<FieldVector>& values = *valuesSendBuff_[peerRank];
-        for (unsigned i = 0; i < indices.size(); ++i)
-            values[i] = (*this)[static_cast<unsigned>(indices[i])];
 
-        values.send(peerRank);
-    }
-
-    void waitSendFinished_()
-    {
-        typename PeerSet::const_iterator peerIt;
-        typename PeerSet::const_iterator peerEndIt = overlap_->peerSet().end();
-
-        // send all entries to all peers
-        peerIt = overlap_->peerSet().begin();
-        for (; peerIt != peerEndIt; ++peerIt) {
-            ProcessRank peerRank = *peerIt;
-            valuesSendBuff_[peerRank]->wait();
+        // finally, create the persistent requests for the values. like MpiBuffer, the
+        // values are sent as raw bytes.
+        pattern.sendValues.resize(pattern.sendRows.size());
+        pattern.recvValues.resize(pattern.recvRows.size());
+        pattern.requests.resize(2*numPeers);
+        for (size_t peerIdx = 0; peerIdx < numPeers; ++peerIdx) {
+            int peerRank = static_cast<int>(pattern.peerRanks[peerIdx]);
+
+            size_t recvOffset = pattern.recvOffsets[peerIdx];
+            size_t numRecv = pattern.recvOffsets[peerIdx + 1] - recvOffset;
+            MPI_Recv_init(pattern.recvValues.data() + recvOffset,
+                          static_cast<int>(numRecv*sizeof(FieldVector)),
+                          MPI_BYTE,
+                          peerRank,
+                          0, // tag
+                          MPI_COMM_WORLD,
+                          &pattern.requests[peerIdx]);
+
+            size_t sendOffset = pattern.sendOffsets[peerIdx];
+            size_t numSend = pattern.sendOffsets[peerIdx + 1] - sendOffset;
+            MPI_Send_init(pattern.sendValues.data() + sendOffset,
+                          static_cast<int>(numSend*sizeof(FieldVector)),
+                          MPI_BYTE,
+                          peerRank,
+                          0, // tag
+                          MPI_COMM_WORLD,
+                          &pattern.requests[numPeers + peerIdx]);
         }
+#endif // HAVE_MPI
     }
 
-    void receiveFromMaster_(ProcessRank peerRank)
+    // copy the values of the rows which are sent into the send buffer and start all
+    // receive and send operations
+    void startCommunication_()
     {
-        const MpiBuffer<Index>& indices = *indicesRecvBuff_[peerRank];
-        MpiBuffer<FieldVector>& values = *valuesRecvBuff_[peerRank];
-
-        // receive the values from the peer
-        values.receive(peerRank);
+        SyncPattern& pattern = *pattern_;
+        for (size_t i = 0; i < pattern.sendRows.size(); ++i)
+            pattern.sendValues[i] = (*this)[pattern.sendRows[i]];
 
-        // copy them into the block vector
-        for (unsigned j = 0; j < indices.size(); ++j) {
-            Index domRowIdx = indices[j];
-            if (overlap_->masterRank(domRowIdx) == peerRank) {
-                (*this)[static_cast<unsigned>(domRowIdx)] = values[j];
-            }
-        }
+#if HAVE_MPI
+        if (!pattern.requests.empty())
+            MPI_Startall(static_cast<int>(pattern.requests.size()), pattern.requests.data());
+#endif // HAVE_MPI
     }
 
-    void receiveAdd_(ProcessRank peerRank)
+    void waitCommunication_()
     {
-        const MpiBuffer<Index>& indices = *indicesRecvBuff_[peerRank];
-        MpiBuffer<FieldVector>& values = *valuesRecvBuff_[peerRank];
-
-        // receive the values from the peer
-        values.receive(peerRank);
-
-        // add up the values of rows on the shared boundary
-        for (unsigned j = 0; j < indices.size(); ++j) {
-            Index domRowIdx = indices[j];
-            (*this)[static_cast<unsigned>(domRowIdx)] += values[j];
-        }
+#if HAVE_MPI
+        SyncPattern& pattern = *pattern_;
+        if (!pattern.requests.empty())
+            MPI_Waitall(static_cast<int>(pattern.requests.size()),
+                        pattern.requests.data(),
+                        MPI_STATUSES_IGNORE);
+#endif // HAVE_MPI
     }
 
-    std::map<ProcessRank, std::shared_ptr<MpiBuffer<unsigned> > > numIndicesSendBuff_;
-    std::map<ProcessRank, std::shared_ptr<MpiBuffer<Index> > > indicesSendBuff_;
-    std::map<ProcessRank, std::shared_ptr<MpiBuffer<Index> > > indicesRecvBuff_;
-    std::map<ProcessRank, std::shared_ptr<MpiBuffer<FieldVector> > > valuesSendBuff_;
-    std::map<ProcessRank, std::shared_ptr<MpiBuffer<FieldVector> > > valuesRecvBuff_;
-
+    std::shared_ptr<SyncPattern> pattern_;
     const Overlap *overlap_;
 };
 
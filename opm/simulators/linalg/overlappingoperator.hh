@@ -54,19 +54,40 @@ public:
     Dune::SolverCategory::Category category() const override
     { return Dune::SolverCategory::overlapping; }
 
-    //! apply operator to x:  \f$ y = A(x) \f$
+    /*!
+     * \brief apply operator to x:  \f$ y = A(x) \f$
+     *
+     * The rows which are sent to the peer processes are computed first. The
+     * communication then proceeds while the remaining rows are computed. The rows
+     * are distributed over the threads.
+     */
     virtual void apply(const DomainVector& x, RangeVector& y) const override
     {
-        A_.mv(x, y);
-        y.sync();
+        // without peers, all rows are interior rows
+        if (overlap().peerSet().empty()) {
+            A_.mvRows(A_.interiorRows(), x, y);
+            return;
+        }
+
+        A_.mvRows(A_.borderRows(), x, y);
+        y.startSync();
+        A_.mvRows(A_.interiorRows(), x, y);
+        y.finishSync();
     }
 
     //! apply operator to x, scale and add:  \f$ y = y + \alpha A(x) \f$
     virtual void applyscaleadd(field_type alpha, const DomainVector& x,
                                RangeVector& y) const override
     {
-        A_.usmv(alpha, x, y);
-        y.sync();
+        if (overlap().peerSet().empty()) {
+            A_.usmvRows(A_.interiorRows(), alpha, x, y);
+            return;
+        }
+
+        A_.usmvRows(A_.borderRows(), alpha, x, y);
+        y.startSync();
+        A_.usmvRows(A_.interiorRows(), alpha, x, y);
+        y.finishSync();
     }
 
     //! returns the matrix
@@ -30,11 +30,19 @@
 #include <dune/common/parallel/mpihelper.hh>
 #include <dune/istl/scalarproducts.hh>
 
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
 namespace Opm {
 namespace Linear {
 
 /*!
  * \brief An overlap aware ISTL scalar product.
+ *
+ * The local part of the scalar product is computed by multiple threads. For this, the
+ * indices are divided into chunks of a fixed size whose partial sums are added up in
+ * order, i.e., the result does not depend on the number of threads.
  */
 template <class OverlappingBlockVector, class Overlap>
 class OverlappingScalarProduct
@@ -58,13 +66,28 @@ public:
     field_type dot(const OverlappingBlockVector& x,
                    const OverlappingBlockVector& y) const override
     {
-        field_type sum = 0;
-        size_t numLocal = overlap_.numLocal();
-        for (unsigned localIdx = 0; localIdx < numLocal; ++localIdx) {
-            if (overlap_.iAmMasterOf(static_cast<int>(localIdx)))
-                sum += x[localIdx] * y[localIdx];
+        const size_t numLocal = overlap_.numLocal();
+        const size_t numChunks = (numLocal + chunkSize_ - 1)/chunkSize_;
+        std::vector<field_type> chunkSums(numChunks);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (size_t chunkIdx = 0; chunkIdx < numChunks; ++chunkIdx) {
+            const size_t beginIdx = chunkIdx*chunkSize_;
+            const size_t endIdx = std::min(beginIdx + chunkSize_, numLocal);
+
+            field_type chunkSum = 0;
+            for (size_t localIdx = beginIdx; localIdx < endIdx; ++localIdx) {
+                if (overlap_.iAmMasterOf(static_cast<int>(localIdx)))
+                    chunkSum += x[localIdx] * y[localIdx];
+            }
+            chunkSums[chunkIdx] = chunkSum;
         }
 
+        field_type sum = 0;
+        for (const auto& chunkSum : chunkSums)
+            sum += chunkSum;
+
         // return the global sum
         return comm_.sum( sum );
     }
@@ -73,6 +96,9 @@ public:
     { return std::sqrt(dot(x, x)); }
 
 private:
+    // the number of indices whose contributions are summed up by a single thread
+    static constexpr size_t chunkSize_ = 1024;
+
     const Overlap& overlap_;
     const CollectiveCommunication comm_;
 };
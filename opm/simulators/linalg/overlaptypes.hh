@@ -122,7 +122,7 @@ using BorderList = std::list<BorderIndex>;
 /*!
  * \brief The list of indices which are on the process boundary.
  */
-class SeedList : public std::list<IndexRankDist>
+class SeedList : public std::vector<IndexRankDist>
 {
 public:
     void update(const BorderList& borderList)
@@ -89,7 +89,6 @@ class ParallelAmgBackend : public ParallelBaseBackend<TypeTag>
     using LinearSolverScalar = GetPropType<TypeTag, Properties::LinearSolverScalar>;
     using Simulator = GetPropType<TypeTag, Properties::Simulator>;
     using GridView = GetPropType<TypeTag, Properties::GridView>;
-    using Overlap = GetPropType<TypeTag, Properties::Overlap>;
     using SparseMatrixAdapter = GetPropType<TypeTag, Properties::SparseMatrixAdapter>;
 
     using ParallelOperator = typename ParentType::ParallelOperator;
@@ -163,11 +162,15 @@ protected:
 
     std::shared_ptr<AMG> preparePreconditioner_()
     {
+        // the AMG hierarchy of the last solve is still valid if the matrix was kept
+        if (this->reusePreconditioner_ && amg_)
+            return amg_;
+
 #if HAVE_MPI
         // create and initialize DUNE's OwnerOverlapCopyCommunication
         // using the domestic overlap
         istlComm_ = std::make_shared<OwnerOverlapCopyCommunication>(MPI_COMM_WORLD);
-        setupAmgIndexSet_(this->overlappingMatrix_->overlap(), istlComm_->indexSet());
+        ParentType::setupAmgIndexSet_(this->overlappingMatrix_->overlap(), istlComm_->indexSet());
         istlComm_->remoteIndices().template rebuild<false>();
 #endif
 
@@ -179,13 +182,11 @@ protected:
 #endif
 
         setupAmg_();
+        this->preconditionerIsPrepared_ = true;
 
         return amg_;
     }
 
-    void cleanupPreconditioner_()
-    { /* nothing to do */ }
-
     std::shared_ptr<RawLinearSolver> prepareSolver_(ParallelOperator& parOperator,
                                                     ParallelScalarProduct& parScalarProduct,
                                                     AMG& parPreCond)
@@ -193,7 +194,7 @@ protected:
         const auto& gridView = this->simulator_.gridView();
         using CCC = CombinedCriterion<OverlappingVector, decltype(gridView.comm())>;
 
-        Scalar linearSolverTolerance = EWOMS_GET_PARAM(TypeTag, Scalar, LinearSolverTolerance);
+        Scalar linearSolverTolerance = this->tolerance_;
         Scalar linearSolverAbsTolerance = EWOMS_GET_PARAM(TypeTag, Scalar, LinearSolverAbsTolerance);
         if(linearSolverAbsTolerance < 0.0)
             linearSolverAbsTolerance = this->simulator_.model().newtonMethod().tolerance()/100.0;
@@ -213,6 +214,7 @@ protected:
         bicgstabSolver->setMaxIterations(EWOMS_GET_PARAM(TypeTag, int, LinearSolverMaxIterations));
         bicgstabSolver->setLinearOperator(&parOperator);
         bicgstabSolver->setRhs(this->overlappingb_);
+        bicgstabSolver->setInitialGuessZero(this->initialGuessIsZero_);
 
         return bicgstabSolver;
     }
@@ -226,35 +228,6 @@ protected:
     void cleanupSolver_()
     { /* nothing to do */ }
 
-#if HAVE_MPI
-    template <class ParallelIndexSet>
-    void setupAmgIndexSet_(const Overlap& overlap, ParallelIndexSet& istlIndices)
-    {
-        using GridAttributes = Dune::OwnerOverlapCopyAttributeSet;
-        using GridAttributeSet = Dune::OwnerOverlapCopyAttributeSet::AttributeSet;
-
-        // create DUNE's ParallelIndexSet from a domestic overlap
-        istlIndices.beginResize();
-        for (Index curIdx = 0; static_cast<size_t>(curIdx) < overlap.numDomestic(); ++curIdx) {
-            GridAttributeSet gridFlag =
-                overlap.iAmMasterOf(curIdx)
-                ? GridAttributes::owner
-                : GridAttributes::copy;
-
-            // an index is used by other processes if it is in the
-            // domestic or in the foreign overlap.
-            bool isShared = overlap.isInOverlap(curIdx);
-
-            assert(curIdx == overlap.globalToDomestic(overlap.domesticToGlobal(curIdx)));
-            istlIndices.add(/*globalIdx=*/overlap.domesticToGlobal(curIdx),
-                            Dune::ParallelLocalIndex<GridAttributeSet>(static_cast<size_t>(curIdx),
-                                                                       gridFlag,
-                                                                       isShared));
-        }
-        istlIndices.endResize();
-    }
-#endif
-
     void setupAmg_()
     {
         if (amg_)
@@ -30,6 +30,7 @@
 #include <opm/common/Exceptions.hpp>
 
 #include <opm/simulators/linalg/istlsparsematrixadapter.hh>
+#include <opm/simulators/linalg/matrixreordering.hh>
 #include <opm/simulators/linalg/overlappingbcrsmatrix.hh>
 #include <opm/simulators/linalg/overlappingblockvector.hh>
 #include <opm/simulators/linalg/overlappingpreconditioner.hh>
@@ -41,6 +42,7 @@
 #include <opm/models/utils/genericguard.hh>
 #include <opm/models/utils/propertysystem.hh>
 #include <opm/models/utils/parametersystem.hh>
+#include <opm/models/utils/timer.hh>
 #include <opm/simulators/linalg/matrixblock.hh>
 #include <opm/simulators/linalg/linalgproperties.hh>
 
@@ -49,6 +51,11 @@
 #include <dune/common/fvector.hh>
 #include <dune/common/version.hh>
 
+#if HAVE_MPI
+#include <dune/istl/owneroverlapcopy.hh>
+#endif
+
+#include <cassert>
 #include <sstream>
 #include <memory>
 #include <iostream>
@@ -139,6 +146,9 @@ public:
         , gridSequenceNumber_( -1 )
         , lastIterations_( -1 )
     {
+        tolerance_ = EWOMS_GET_PARAM(TypeTag, Scalar, LinearSolverTolerance);
+        usePreviousSolution_ = EWOMS_GET_PARAM(TypeTag, bool, LinearSolverUsePreviousSolution);
+
         overlappingMatrix_ = nullptr;
         overlappingb_ = nullptr;
         overlappingx_ = nullptr;
@@ -162,6 +172,10 @@ public:
                              "The maximum number of iterations of the linear solver");
         EWOMS_REGISTER_PARAM(TypeTag, int, LinearSolverVerbosity,
                              "The verbosity level of the linear solver");
+        EWOMS_REGISTER_PARAM(TypeTag, bool, LinearSolverUsePreviousSolution,
+                             "Use the solution of the previous linear solve as the initial guess");
+        EWOMS_REGISTER_PARAM(TypeTag, bool, LinearSolverReordering,
+                             "Reorder the linear system using the reverse Cuthill-McKee algorithm");
 
         PreconditionerWrapper::registerParameters();
     }
@@ -171,7 +185,7 @@ public:
      *        equations the next time it is called.
      */
     void eraseMatrix()
-    { cleanup_(); }
+    { asImp_().cleanup_(); }
 
     /*!
      * \brief Set up the internal data structures required for the linear solver.
@@ -191,21 +205,40 @@ public:
         asImp_().cleanup_();
         gridSequenceNumber_ = curSeqNum;
 
+        Timer setupTimer;
+        setupTimer.start();
+
         BorderListCreator borderListCreator(simulator_.gridView(),
                                             simulator_.model().dofMapper());
 
+        // reorder the linear system to reduce the fill-in of incomplete factorizations
+        // and to improve the data locality. like the overlap, the ordering only depends
+        // on the grid, so it is only computed if the grid has changed.
+        std::vector<Index> nativeOrder;
+        if (EWOMS_GET_PARAM(TypeTag, bool, LinearSolverReordering))
+            reverseCuthillMcKee(M.istlMatrix(), nativeOrder);
+
         // create the overlapping Jacobian matrix
         unsigned overlapSize = EWOMS_GET_PARAM(TypeTag, unsigned, LinearSolverOverlapSize);
         overlappingMatrix_ = new OverlappingMatrix(M.istlMatrix(),
                                                    borderListCreator.borderList(),
                                                    borderListCreator.blackList(),
-                                                   overlapSize);
+                                                   overlapSize,
+                                                   nativeOrder);
 
         // create the overlapping vectors for the residual and the
         // solution
         overlappingb_ = new OverlappingVector(overlappingMatrix_->overlap());
         overlappingx_ = new OverlappingVector(*overlappingb_);
 
+        setupTimer.stop();
+        if (overlappingMatrix_->overlap().myRank() == 0
+            && EWOMS_GET_PARAM(TypeTag, int, LinearSolverVerbosity) > 0)
+        {
+            std::cout << "Setting up the overlapping linear system took "
+                      << setupTimer.realTimeElapsed() << " seconds\n" << std::flush;
+        }
+
         // writeOverlapToVTK_();
     }
 
@@ -242,6 +275,28 @@ public:
     {
         overlappingMatrix_->assignFromNative(M.istlMatrix());
         overlappingMatrix_->syncAdd();
+        reusePreconditioner_ = false;
+    }
+
+    /*!
+     * \brief Returns true if the matrix and the preconditioner of the last call to solve()
+     *        are still available.
+     */
+    bool canKeepMatrix() const
+    { return preconditionerIsPrepared_; }
+
+    /*!
+     * \brief Solve the next linear system of equations using the matrix and the
+     *        preconditioner of the last call to solve().
+     *
+     * This is a replacement for setMatrix() which avoids copying the matrix, its
+     * synchronization with the peer processes and the set up of the preconditioner. It
+     * may only be called if canKeepMatrix() returns true.
+     */
+    void keepMatrix()
+    {
+        assert(canKeepMatrix());
+        reusePreconditioner_ = true;
     }
 
     /*!
@@ -251,12 +306,18 @@ public:
      */
     bool solve(Vector& x)
     {
-        (*overlappingx_) = 0.0;
-
+        // start with the solution of the last linear system if requested. this is only
+        // done if that solve succeeded, else the initial guess is zero.
+        initialGuessIsZero_ = !usePreviousSolution_ || !previousSolutionIsValid_;
+        if (initialGuessIsZero_)
+            (*overlappingx_) = 0.0;
+        previousSolutionIsValid_ = false;
+
+        // the preconditioner is kept until the matrix changes, so it can be reused if
+        // the next system is solved with the same matrix
         auto parPreCond = asImp_().preparePreconditioner_();
-        auto precondCleanupFn = [this]() -> void
-                                { this->asImp_().cleanupPreconditioner_(); };
-        auto precondCleanupGuard = Opm::make_guard(precondCleanupFn);
+        reusePreconditioner_ = false;
+
         // create the parallel scalar product and the parallel operator
         ParallelScalarProduct parScalarProduct(overlappingMatrix_->overlap());
         ParallelOperator parOperator(*overlappingMatrix_);
@@ -275,6 +336,7 @@ public:
         auto result = asImp_().runSolver_(solver);
         // store number of iterations used
         lastIterations_ = result.second;
+        previousSolutionIsValid_ = result.first;
 
         // copy the result back to the non-overlapping vector
         overlappingx_->assignTo(x);
@@ -289,6 +351,22 @@ public:
     size_t iterations () const
     { return lastIterations_; }
 
+    /*!
+     * \brief Set the reduction of the residual which the linear solver needs to achieve.
+     *
+     * By default, this is the value of the LinearSolverTolerance parameter. The new
+     * value is used starting with the next call to solve().
+     */
+    void setTolerance(Scalar tolerance)
+    { tolerance_ = tolerance; }
+
+    /*!
+     * \brief Return the reduction of the residual which the linear solver needs to
+     *        achieve.
+     */
+    Scalar tolerance() const
+    { return tolerance_; }
+
 protected:
     Implementation& asImp_()
     { return *static_cast<Implementation *>(this); }
@@ -298,6 +376,9 @@ protected:
 
     void cleanup_()
     {
+        // the preconditioner may refer to the matrix, so it must be deleted first
+        cleanupPreconditioner_();
+
         // create the overlapping Jacobian matrix and vectors
         delete overlappingMatrix_;
         delete overlappingb_;
@@ -306,27 +387,34 @@ protected:
         overlappingMatrix_ = 0;
         overlappingb_ = 0;
         overlappingx_ = 0;
+        previousSolutionIsValid_ = false;
     }
 
     std::shared_ptr<ParallelPreconditioner> preparePreconditioner_()
     {
-        int preconditionerIsReady = 1;
-        try {
-            // update sequential preconditioner
-            precWrapper_.prepare(*overlappingMatrix_);
-        }
-        catch (const Dune::Exception& e) {
-            std::cout << "Preconditioner threw exception \"" << e.what()
-                      << " on rank " << overlappingMatrix_->overlap().myRank()
-                      << "\n"  << std::flush;
-            preconditionerIsReady = 0;
-        }
+        if (!reusePreconditioner_) {
+            cleanupPreconditioner_();
+
+            int preconditionerIsReady = 1;
+            try {
+                // update sequential preconditioner
+                precWrapper_.prepare(*overlappingMatrix_);
+            }
+            catch (const Dune::Exception& e) {
+                std::cout << "Preconditioner threw exception \"" << e.what()
+                          << " on rank " << overlappingMatrix_->overlap().myRank()
+                          << "\n"  << std::flush;
+                preconditionerIsReady = 0;
+            }
+
+            // make sure that the preconditioner is also ready on all peer
+            // ranks.
+            preconditionerIsReady = simulator_.gridView().comm().min(preconditionerIsReady);
+            if (!preconditionerIsReady)
+                throw NumericalProblem("Creating the preconditioner failed");
 
-        // make sure that the preconditioner is also ready on all peer
-        // ranks.
-        preconditionerIsReady = simulator_.gridView().comm().min(preconditionerIsReady);
-        if (!preconditionerIsReady)
-            throw NumericalProblem("Creating the preconditioner failed");
+            preconditionerIsPrepared_ = true;
+        }
 
         // create the parallel preconditioner
         return std::make_shared<ParallelPreconditioner>(precWrapper_.get(), overlappingMatrix_->overlap());
@@ -335,7 +423,39 @@ protected:
     void cleanupPreconditioner_()
     {
         precWrapper_.cleanup();
+        preconditionerIsPrepared_ = false;
+        reusePreconditioner_ = false;
+    }
+
+#if HAVE_MPI
+    // create the index set of DUNE's OwnerOverlapCopyCommunication for an overlap
+    template <class ParallelIndexSet>
+    static void setupAmgIndexSet_(const Overlap& overlap, ParallelIndexSet& istlIndices)
+    {
+        using GridAttributes = Dune::OwnerOverlapCopyAttributeSet;
+        using GridAttributeSet = Dune::OwnerOverlapCopyAttributeSet::AttributeSet;
+
+        // create DUNE's ParallelIndexSet from a domestic overlap
+        istlIndices.beginResize();
+        for (Index curIdx = 0; static_cast<size_t>(curIdx) < overlap.numDomestic(); ++curIdx) {
+            GridAttributeSet gridFlag =
+                overlap.iAmMasterOf(curIdx)
+                ? GridAttributes::owner
+                : GridAttributes::copy;
+
+            // an index is used by other processes if it is in the
+            // domestic or in the foreign overlap.
+            bool isShared = overlap.isInOverlap(curIdx);
+
+            assert(curIdx == overlap.globalToDomestic(overlap.domesticToGlobal(curIdx)));
+            istlIndices.add(/*globalIdx=*/overlap.domesticToGlobal(curIdx),
+                            Dune::ParallelLocalIndex<GridAttributeSet>(static_cast<size_t>(curIdx),
+                                                                       gridFlag,
+                                                                       isShared));
+        }
+        istlIndices.endResize();
     }
+#endif
 
     void writeOverlapToVTK_()
     {
@@ -355,11 +475,11 @@ protected:
             const auto& overlap = overlappingMatrix_->overlap();
             for (; vIt != vEndIt; ++vIt) {
                 int nativeIdx = simulator_.model().vertexMapper().map(*vIt);
-                int localIdx = overlap.foreignOverlap().nativeToLocal(nativeIdx);
-                if (localIdx < 0)
+                int domesticIdx = overlap.nativeToDomestic(nativeIdx);
+                if (domesticIdx < 0)
                     continue;
                 rankField[nativeIdx] = simulator_.gridView().comm().rank();
-                if (overlap.peerHasIndex(lookedAtRank, localIdx))
+                if (overlap.peerHasIndex(lookedAtRank, domesticIdx))
                     isInOverlap[nativeIdx] = 1.0;
             }
 
@@ -377,12 +497,26 @@ protected:
     const Simulator& simulator_;
     int gridSequenceNumber_;
     size_t lastIterations_;
+    Scalar tolerance_;
 
     OverlappingMatrix *overlappingMatrix_;
     OverlappingVector *overlappingb_;
     OverlappingVector *overlappingx_;
 
     PreconditionerWrapper precWrapper_;
+
+    // specifies whether a preconditioner for the current matrix exists and whether it
+    // is used for the next solve instead of setting up a new one
+    bool preconditionerIsPrepared_ = false;
+    bool reusePreconditioner_ = false;
+
+    // specifies whether the solution of the last linear solve is used as the initial
+    // guess of the next one
+    bool usePreviousSolution_;
+    bool previousSolutionIsValid_ = false;
+
+    // specifies whether the initial guess of the current solve is the zero vector
+    bool initialGuessIsZero_ = true;
 };
 }} // namespace Linear, Opm
 
@@ -410,6 +544,12 @@ template<class TypeTag>
 struct LinearSolverScalar<TypeTag, TTag::ParallelBaseLinearSolver>
 { using type = GetPropType<TypeTag, Properties::Scalar>; };
 
+//! by default, the preconditioner uses the same kind of floating point values as the
+//! linear solver
+template<class TypeTag>
+struct PreconditionerScalar<TypeTag, TTag::ParallelBaseLinearSolver>
+{ using type = GetPropType<TypeTag, Properties::LinearSolverScalar>; };
+
 template<class TypeTag>
 struct OverlappingMatrix<TypeTag, TTag::ParallelBaseLinearSolver>
 {
@@ -466,6 +606,14 @@ struct LinearSolverOverlapSize<TypeTag, TTag::ParallelBaseLinearSolver> { static
 template<class TypeTag>
 struct LinearSolverMaxIterations<TypeTag, TTag::ParallelBaseLinearSolver> { static constexpr int value = 1000; };
 
+//! start each linear solve with a zero initial guess by default
+template<class TypeTag>
+struct LinearSolverUsePreviousSolution<TypeTag, TTag::ParallelBaseLinearSolver> { static constexpr bool value = false; };
+
+//! keep the ordering of the linear system by default
+template<class TypeTag>
+struct LinearSolverReordering<TypeTag, TTag::ParallelBaseLinearSolver> { static constexpr bool value = false; };
+
 } // namespace Opm::Properties
 
 #endif
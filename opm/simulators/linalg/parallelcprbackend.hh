@@ -0,0 +1,548 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \copydoc Opm::Linear::ParallelCprBackend
+ */
+#ifndef EWOMS_PARALLEL_CPR_BACKEND_HH
+#define EWOMS_PARALLEL_CPR_BACKEND_HH
+
+#include "linalgproperties.hh"
+#include "parallelbasebackend.hh"
+#include "bicgstabsolver.hh"
+#include "combinedcriterion.hh"
+#include "istlsparsematrixadapter.hh"
+#include "overlappingoperator.hh"
+
+#include <opm/common/Exceptions.hpp>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+#include <dune/istl/preconditioner.hh>
+#include <dune/istl/paamg/amg.hh>
+#include <dune/istl/paamg/pinfo.hh>
+#include <dune/istl/owneroverlapcopy.hh>
+
+#include <memory>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace Opm::Linear {
+template <class TypeTag>
+class ParallelCprBackend;
+} // namespace Opm::Linear
+
+namespace Opm::Properties {
+
+// Create new type tags
+namespace TTag {
+struct ParallelCprLinearSolver { using InheritsFrom = std::tuple<ParallelBaseLinearSolver>; };
+} // end namespace TTag
+
+//! The target number of DOFs per processor for the AMG of the pressure system
+template<class TypeTag>
+struct AmgCoarsenTarget<TypeTag, TTag::ParallelCprLinearSolver> { static constexpr int value = 5000; };
+
+//! By default, the pressure is the first primary variable
+template<class TypeTag>
+struct CprPressureIndex<TypeTag, TTag::ParallelCprLinearSolver> { static constexpr int value = 0; };
+
+//! Recompute the aggregates of the pressure AMG for every tenth matrix
+template<class TypeTag>
+struct CprAmgReuseInterval<TypeTag, TTag::ParallelCprLinearSolver> { static constexpr int value = 9; };
+
+template<class TypeTag>
+struct LinearSolverMaxError<TypeTag, TTag::ParallelCprLinearSolver>
+{
+    using type = GetPropType<TypeTag, Scalar>;
+    static constexpr type value = 1e7;
+};
+
+template<class TypeTag>
+struct LinearSolverBackend<TypeTag, TTag::ParallelCprLinearSolver>
+{ using type = Opm::Linear::ParallelCprBackend<TypeTag>; };
+
+} // namespace Opm::Properties
+
+namespace Opm {
+namespace Linear {
+/*!
+ * \ingroup Linear
+ *
+ * \brief The two-stage constrained pressure residual (CPR) preconditioner.
+ *
+ * The first stage approximately solves the pressure system, i.e., a scalar system of
+ * equations which is obtained by combining the equations of each row with a set of
+ * weights and by only considering the derivatives with regard to the pressure. Its
+ * solution is used as the pressure correction of all degrees of freedom. The second
+ * stage then applies a preconditioner for the full system to the remaining residual.
+ */
+template <class OverlappingMatrix, class OverlappingVector, class PressureVector,
+          class PressureSolver, class SecondStage>
+class CprPreconditioner : public Dune::Preconditioner<OverlappingVector, OverlappingVector>
+{
+    using Operator = OverlappingOperator<OverlappingMatrix, OverlappingVector, OverlappingVector>;
+    using VectorBlock = typename OverlappingVector::block_type;
+
+public:
+    using domain_type = OverlappingVector;
+    using range_type = OverlappingVector;
+    using field_type = typename OverlappingVector::field_type;
+
+    /*!
+     * \brief Create the preconditioner.
+     *
+     * \param A The matrix of the full system
+     * \param weights The weights of the equations of each row
+     * \param pressureIdx The index of the pressure in the primary variables
+     * \param pressureSolver The preconditioner for the pressure system
+     * \param secondStage The preconditioner for the full system
+     */
+    CprPreconditioner(const OverlappingMatrix& A,
+                      const std::vector<VectorBlock>& weights,
+                      unsigned pressureIdx,
+                      PressureSolver& pressureSolver,
+                      SecondStage& secondStage)
+        : operator_(A)
+        , weights_(weights)
+        , pressureIdx_(pressureIdx)
+        , pressureSolver_(pressureSolver)
+        , secondStage_(secondStage)
+        , pressureRhs_(A.N())
+        , pressureSolution_(A.N())
+        , residual_(A.overlap())
+        , correction_(A.overlap())
+    {}
+
+    Dune::SolverCategory::Category category() const override
+    { return Dune::SolverCategory::overlapping; }
+
+    void pre(domain_type& x, range_type& b) override
+    {
+        pressureSolution_ = 0.0;
+        pressureRhs_ = 0.0;
+        pressureSolver_.pre(pressureSolution_, pressureRhs_);
+        secondStage_.pre(x, b);
+    }
+
+    void apply(domain_type& v, const range_type& d) override
+    {
+        // first stage: restrict the defect to the pressure system, solve it and use
+        // its solution as the pressure correction
+        const size_t numRows = d.size();
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (size_t rowIdx = 0; rowIdx < numRows; ++rowIdx)
+            pressureRhs_[rowIdx] = weights_[rowIdx]*d[rowIdx];
+
+        pressureSolution_ = 0.0;
+        pressureSolver_.apply(pressureSolution_, pressureRhs_);
+
+        v = 0.0;
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (size_t rowIdx = 0; rowIdx < numRows; ++rowIdx)
+            v[rowIdx][pressureIdx_] = pressureSolution_[rowIdx];
+
+        // second stage: precondition the residual of the full system which remains
+        // after the pressure correction
+        residual_ = d;
+        operator_.applyscaleadd(-1.0, v, residual_);
+        secondStage_.apply(correction_, residual_);
+        v += correction_;
+    }
+
+    void post(domain_type& x) override
+    {
+        pressureSolver_.post(pressureSolution_);
+        secondStage_.post(x);
+    }
+
+private:
+    Operator operator_;
+    const std::vector<VectorBlock>& weights_;
+    unsigned pressureIdx_;
+    PressureSolver& pressureSolver_;
+    SecondStage& secondStage_;
+
+    PressureVector pressureRhs_;
+    PressureVector pressureSolution_;
+    OverlappingVector residual_;
+    OverlappingVector correction_;
+};
+
+/*!
+ * \ingroup Linear
+ *
+ * \brief Provides a linear solver backend which uses the constrained pressure residual
+ *        (CPR) preconditioner.
+ *
+ * The pressure system is obtained using quasi-IMPES weights, i.e., the weights of a row
+ * are the pressure row of the inverse of its diagonal block. It is approximately solved
+ * by one cycle of the parallel algebraic multi-grid (AMG) preconditioner of DUNE-ISTL,
+ * whose aggregates are kept for the number of matrices specified by the
+ * CprAmgReuseInterval parameter. The second stage is the preconditioner which is
+ * selected by the PreconditionerWrapper property, i.e., ILU(0) by default.
+ *
+ * The index of the pressure in the primary variables is given by the CprPressureIndex
+ * property.
+ */
+template <class TypeTag>
+class ParallelCprBackend : public ParallelBaseBackend<TypeTag>
+{
+    using ParentType = ParallelBaseBackend<TypeTag>;
+
+    using Scalar = GetPropType<TypeTag, Properties::Scalar>;
+    using LinearSolverScalar = GetPropType<TypeTag, Properties::LinearSolverScalar>;
+    using Simulator = GetPropType<TypeTag, Properties::Simulator>;
+    using GridView = GetPropType<TypeTag, Properties::GridView>;
+    using SparseMatrixAdapter = GetPropType<TypeTag, Properties::SparseMatrixAdapter>;
+
+    using ParallelOperator = typename ParentType::ParallelOperator;
+    using OverlappingMatrix = typename ParentType::OverlappingMatrix;
+    using OverlappingVector = typename ParentType::OverlappingVector;
+    using ParallelPreconditioner = typename ParentType::ParallelPreconditioner;
+    using ParallelScalarProduct = typename ParentType::ParallelScalarProduct;
+
+    static constexpr int numEq = getPropValue<TypeTag, Properties::NumEq>();
+    static constexpr int pressureIdx = getPropValue<TypeTag, Properties::CprPressureIndex>();
+    using VectorBlock = Dune::FieldVector<LinearSolverScalar, numEq>;
+    using MatrixBlock = typename SparseMatrixAdapter::MatrixBlock;
+
+    using PressureMatrix = Dune::BCRSMatrix<Dune::FieldMatrix<LinearSolverScalar, 1, 1> >;
+    using PressureVector = Dune::BlockVector<Dune::FieldVector<LinearSolverScalar, 1> >;
+
+    using SequentialSmoother = Dune::SeqSOR<PressureMatrix, PressureVector, PressureVector>;
+
+#if HAVE_MPI
+    using OwnerOverlapCopyCommunication = Dune::OwnerOverlapCopyCommunication<Opm::Linear::Index>;
+    using FineOperator = Dune::OverlappingSchwarzOperator<PressureMatrix,
+                                                          PressureVector,
+                                                          PressureVector,
+                                                          OwnerOverlapCopyCommunication>;
+    using ParallelSmoother = Dune::BlockPreconditioner<PressureVector,
+                                                       PressureVector,
+                                                       OwnerOverlapCopyCommunication,
+                                                       SequentialSmoother>;
+    using AMG = Dune::Amg::AMG<FineOperator,
+                               PressureVector,
+                               ParallelSmoother,
+                               OwnerOverlapCopyCommunication>;
+#else
+    using FineOperator = Dune::MatrixAdapter<PressureMatrix, PressureVector, PressureVector>;
+    using ParallelSmoother = SequentialSmoother;
+    using AMG = Dune::Amg::AMG<FineOperator, PressureVector, ParallelSmoother>;
+#endif
+
+    using Preconditioner = CprPreconditioner<OverlappingMatrix,
+                                             OverlappingVector,
+                                             PressureVector,
+                                             AMG,
+                                             ParallelPreconditioner>;
+
+    using RawLinearSolver = BiCGStabSolver<ParallelOperator,
+                                           OverlappingVector,
+                                           Preconditioner>;
+
+    static_assert(std::is_same<SparseMatrixAdapter, IstlSparseMatrixAdapter<MatrixBlock> >::value,
+                  "The ParallelCprBackend linear solver backend requires the IstlSparseMatrixAdapter");
+    static_assert(0 <= pressureIdx && pressureIdx < numEq,
+                  "The pressure index of the CPR preconditioner must be a primary variable");
+
+public:
+    ParallelCprBackend(const Simulator& simulator)
+        : ParentType(simulator)
+    { }
+
+    static void registerParameters()
+    {
+        ParentType::registerParameters();
+
+        EWOMS_REGISTER_PARAM(TypeTag, Scalar, LinearSolverMaxError,
+                             "The maximum residual error which the linear solver tolerates"
+                             " without giving up");
+        EWOMS_REGISTER_PARAM(TypeTag, int, AmgCoarsenTarget,
+                             "The coarsening target for the agglomerations of "
+                             "the AMG preconditioner");
+        EWOMS_REGISTER_PARAM(TypeTag, int, CprAmgReuseInterval,
+                             "The number of matrices for which the aggregates of the "
+                             "pressure AMG are reused before they are recomputed");
+    }
+
+protected:
+    friend ParentType;
+
+    void cleanup_()
+    {
+        // the pressure system refers to the overlapping matrix, so it must be deleted
+        // first
+        cprPreCond_.reset();
+        secondStage_.reset();
+        amg_.reset();
+        fineOperator_.reset();
+#if HAVE_MPI
+        istlComm_.reset();
+#endif
+        pressureMatrix_.reset();
+        weights_.clear();
+
+        ParentType::cleanup_();
+    }
+
+    std::shared_ptr<Preconditioner> preparePreconditioner_()
+    {
+        // the preconditioner of the last solve is still valid if the matrix was kept
+        if (this->reusePreconditioner_ && cprPreCond_)
+            return cprPreCond_;
+
+        cprPreCond_.reset();
+        secondStage_ = ParentType::preparePreconditioner_();
+
+        if (!pressureMatrix_)
+            setupPressureSystem_();
+
+        int pressureSystemIsValid = assemblePressureSystem_() ? 1 : 0;
+        pressureSystemIsValid = this->simulator_.gridView().comm().min(pressureSystemIsValid);
+        if (!pressureSystemIsValid)
+            throw NumericalProblem("Computing the weights of the CPR preconditioner failed");
+
+        updateAmg_();
+
+        cprPreCond_ = std::make_shared<Preconditioner>(*this->overlappingMatrix_,
+                                                       weights_,
+                                                       static_cast<unsigned>(pressureIdx),
+                                                       *amg_,
+                                                       *secondStage_);
+        return cprPreCond_;
+    }
+
+    std::shared_ptr<RawLinearSolver> prepareSolver_(ParallelOperator& parOperator,
+                                                    ParallelScalarProduct& parScalarProduct,
+                                                    Preconditioner& parPreCond)
+    {
+        const auto& gridView = this->simulator_.gridView();
+        using CCC = CombinedCriterion<OverlappingVector, decltype(gridView.comm())>;
+
+        Scalar linearSolverTolerance = this->tolerance_;
+        Scalar linearSolverAbsTolerance = EWOMS_GET_PARAM(TypeTag, Scalar, LinearSolverAbsTolerance);
+        if(linearSolverAbsTolerance < 0.0)
+            linearSolverAbsTolerance = this->simulator_.model().newtonMethod().tolerance()/100.0;
+
+        convCrit_.reset(new CCC(gridView.comm(),
+                                /*residualReductionTolerance=*/linearSolverTolerance,
+                                /*absoluteResidualTolerance=*/linearSolverAbsTolerance,
+                                EWOMS_GET_PARAM(TypeTag, Scalar, LinearSolverMaxError)));
+
+        auto bicgstabSolver =
+            std::make_shared<RawLinearSolver>(parPreCond, *convCrit_, parScalarProduct);
+
+        int verbosity = 0;
+        if (parOperator.overlap().myRank() == 0)
+            verbosity = EWOMS_GET_PARAM(TypeTag, int, LinearSolverVerbosity);
+        bicgstabSolver->setVerbosity(verbosity);
+        bicgstabSolver->setMaxIterations(EWOMS_GET_PARAM(TypeTag, int, LinearSolverMaxIterations));
+        bicgstabSolver->setLinearOperator(&parOperator);
+        bicgstabSolver->setRhs(this->overlappingb_);
+        bicgstabSolver->setInitialGuessZero(this->initialGuessIsZero_);
+
+        return bicgstabSolver;
+    }
+
+    std::pair<bool,int> runSolver_(std::shared_ptr<RawLinearSolver> solver)
+    {
+        bool converged = solver->apply(*this->overlappingx_);
+        return std::make_pair(converged, int(solver->report().iterations()));
+    }
+
+    void cleanupSolver_()
+    { /* nothing to do */ }
+
+    // create the pressure matrix, which exhibits the same sparsity pattern as the
+    // overlapping matrix, and the parallel operator of the pressure AMG. this only
+    // needs to be done if the overlapping matrix was recreated.
+    void setupPressureSystem_()
+    {
+        const auto& A = *this->overlappingMatrix_;
+        const size_t numRows = A.N();
+
+        pressureMatrix_ = std::make_unique<PressureMatrix>(numRows, numRows, A.nonzeroes(),
+                                                           PressureMatrix::random);
+        for (size_t rowIdx = 0; rowIdx < numRows; ++rowIdx)
+            pressureMatrix_->setrowsize(rowIdx, A[rowIdx].size());
+        pressureMatrix_->endrowsizes();
+        for (size_t rowIdx = 0; rowIdx < numRows; ++rowIdx) {
+            const auto& row = A[rowIdx];
+            for (auto colIt = row.begin(); colIt != row.end(); ++colIt)
+                pressureMatrix_->addindex(rowIdx, colIt.index());
+        }
+        pressureMatrix_->endindices();
+
+        weights_.resize(numRows);
+
+#if HAVE_MPI
+        istlComm_ = std::make_shared<OwnerOverlapCopyCommunication>(MPI_COMM_WORLD);
+        ParentType::setupAmgIndexSet_(A.overlap(), istlComm_->indexSet());
+        istlComm_->remoteIndices().template rebuild<false>();
+
+        fineOperator_ = std::make_shared<FineOperator>(*pressureMatrix_, *istlComm_);
+#else
+        fineOperator_ = std::make_shared<FineOperator>(*pressureMatrix_);
+#endif
+
+        // the aggregates need to be computed for the new matrix
+        amg_.reset();
+    }
+
+    // compute the quasi-IMPES weights and the entries of the pressure matrix. returns
+    // false if a diagonal block is singular.
+    bool assemblePressureSystem_()
+    {
+        const auto& A = *this->overlappingMatrix_;
+        auto& P = *pressureMatrix_;
+        const size_t numRows = A.N();
+
+        bool isValid = true;
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (size_t rowIdx = 0; rowIdx < numRows; ++rowIdx) {
+            const auto& row = A[rowIdx];
+            auto& weights = weights_[rowIdx];
+
+            // the weights are the solution of D^T*w = e_p, i.e., the pressure row of
+            // the inverse of the diagonal block D
+            Dune::FieldMatrix<LinearSolverScalar, numEq, numEq> diagT;
+            const auto& diag = row[rowIdx];
+            for (int i = 0; i < numEq; ++i)
+                for (int j = 0; j < numEq; ++j)
+                    diagT[i][j] = diag[j][i];
+
+            VectorBlock unitVector(0.0);
+            unitVector[pressureIdx] = 1.0;
+            try {
+                diagT.solve(weights, unitVector);
+            }
+            catch (const Dune::FMatrixError&) {
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+                isValid = false;
+                continue;
+            }
+
+            // scale the weights so that the pressure system is not affected by the
+            // scaling of the equations
+            weights /= weights.infinity_norm();
+
+            auto& pressureRow = P[rowIdx];
+            auto pressureColIt = pressureRow.begin();
+            for (auto colIt = row.begin(); colIt != row.end(); ++colIt, ++pressureColIt) {
+                LinearSolverScalar value = 0.0;
+                for (int eqIdx = 0; eqIdx < numEq; ++eqIdx)
+                    value += weights[eqIdx]*(*colIt)[eqIdx][pressureIdx];
+                *pressureColIt = value;
+            }
+        }
+
+        return isValid;
+    }
+
+    // recompute the hierarchy of the pressure AMG. the aggregates of the previous
+    // matrices are kept unless they have been used for CprAmgReuseInterval matrices.
+    void updateAmg_()
+    {
+        const int reuseInterval = EWOMS_GET_PARAM(TypeTag, int, CprAmgReuseInterval);
+        if (amg_ && numAmgReuses_ < reuseInterval) {
+            amg_->recalculateHierarchy();
+            ++numAmgReuses_;
+            return;
+        }
+
+        setupAmg_();
+        numAmgReuses_ = 0;
+    }
+
+    void setupAmg_()
+    {
+        if (amg_)
+            amg_.reset();
+
+        int verbosity = 0;
+        if (this->simulator_.vanguard().gridView().comm().rank() == 0)
+            verbosity = EWOMS_GET_PARAM(TypeTag, int, LinearSolverVerbosity);
+
+        using SmootherArgs = typename Dune::Amg::SmootherTraits<ParallelSmoother>::Arguments;
+
+        SmootherArgs smootherArgs;
+        smootherArgs.iterations = 1;
+        smootherArgs.relaxationFactor = 1.0;
+
+        // the pressure matrix is not symmetric in general, so the connections are
+        // determined by the symmetrized strength of the couplings
+        using CoarsenCriterion = Dune::Amg::
+            CoarsenCriterion<Dune::Amg::SymmetricCriterion<PressureMatrix, Dune::Amg::FirstDiagonal> >;
+        int coarsenTarget = EWOMS_GET_PARAM(TypeTag, int, AmgCoarsenTarget);
+        CoarsenCriterion coarsenCriterion(/*maxLevel=*/15, coarsenTarget);
+        coarsenCriterion.setDefaultValuesIsotropic(GridView::dimension,
+                                                   /*aggregateSizePerDim=*/2);
+        if (verbosity > 0)
+            coarsenCriterion.setDebugLevel(1);
+        else
+            coarsenCriterion.setDebugLevel(0); // make the AMG shut up
+
+        coarsenCriterion.setMinCoarsenRate(1.05);
+        coarsenCriterion.setAccumulate(Dune::Amg::atOnceAccu);
+        coarsenCriterion.setSkipIsolated(false);
+
+#if HAVE_MPI
+        amg_ = std::make_shared<AMG>(*fineOperator_, coarsenCriterion, smootherArgs, *istlComm_);
+#else
+        amg_ = std::make_shared<AMG>(*fineOperator_, coarsenCriterion, smootherArgs);
+#endif
+    }
+
+    std::unique_ptr<ConvergenceCriterion<OverlappingVector> > convCrit_;
+
+    std::unique_ptr<PressureMatrix> pressureMatrix_;
+    std::vector<VectorBlock> weights_;
+
+#if HAVE_MPI
+    std::shared_ptr<OwnerOverlapCopyCommunication> istlComm_;
+#endif
+    std::shared_ptr<FineOperator> fineOperator_;
+    std::shared_ptr<AMG> amg_;
+    int numAmgReuses_ = 0;
+
+    std::shared_ptr<ParallelPreconditioner> secondStage_;
+    std::shared_ptr<Preconditioner> cprPreCond_;
+};
+
+} // namespace Linear
+} // namespace Opm
+
+#endif
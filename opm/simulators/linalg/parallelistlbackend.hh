@@ -61,6 +61,8 @@ namespace Opm::Linear {
  * - \c BiCGStab: A stabilized bi-conjugated gradients solver
  * - \c MinRes: A solver based on the  minimized residual algorithm
  * - \c RestartedGMRes: A restarted GMRES solver
+ * - \c RecyclingGMRes: A restarted GMRES solver which retains a subspace across
+ *                      linear solves
  *
  * Chosing the preconditioner works in an analogous way:
  * \code
@@ -122,7 +124,8 @@ protected:
     {
         return solverWrapper_.get(parOperator,
                                   parScalarProduct,
-                                  parPreCond);
+                                  parPreCond,
+                                  this->tolerance_);
     }
 
     void cleanupSolver_()
@@ -160,6 +163,10 @@ struct PreconditionerWrapper<TypeTag, TTag::ParallelIstlLinearSolver>
 template<class TypeTag>
 struct GMResRestart<TypeTag, TTag::ParallelIstlLinearSolver> { static constexpr int value = 10; };
 
+//! retain at most 5 vectors between the solves of the recycling GMRes solver by default
+template<class TypeTag>
+struct GMResRecycledVectors<TypeTag, TTag::ParallelIstlLinearSolver> { static constexpr int value = 5; };
+
 } // namespace Opm::Properties
 
 #endif
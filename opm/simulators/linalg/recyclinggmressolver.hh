@@ -0,0 +1,406 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \copydoc Opm::Linear::RecyclingGMResSolver
+ */
+#ifndef EWOMS_RECYCLING_GMRES_SOLVER_HH
+#define EWOMS_RECYCLING_GMRES_SOLVER_HH
+
+#include <dune/common/ftraits.hh>
+#include <dune/common/timer.hh>
+#include <dune/istl/bvector.hh>
+#include <dune/istl/operators.hh>
+#include <dune/istl/preconditioner.hh>
+#include <dune/istl/scalarproducts.hh>
+#include <dune/istl/solver.hh>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+namespace Opm {
+namespace Linear {
+
+/*!
+ * \brief A restarted GMRES solver which recycles a Krylov subspace across solves.
+ *
+ * This implements the GCROT(m,k) method by de Sturler and Hicken & Zingg: Every
+ * restart cycle consists of m flexible GMRES iterations which are kept orthogonal to
+ * the image C = A*U of a subspace U. The correction of each cycle is then appended to
+ * U, so that at most k vectors are retained. At the end of a solve, the solution is
+ * added to U as well and U is stored in a vector which is provided by the caller. It
+ * thus outlives the solver and seeds the next linear solve. For the sequence of
+ * similar systems which occurs during the Newton-Raphson method, this removes the
+ * slowest converging error components from the start.
+ *
+ * The image of the recycled space is recomputed for the matrix of each solve, i.e., the
+ * method stays correct if the matrix changes between solves. This costs one
+ * application of the linear operator per recycled vector, which is not counted as an
+ * iteration. Like the GMRES solver of dune-istl, the right hand side vector is
+ * overwritten by the residual.
+ */
+template <class X>
+class RecyclingGMResSolver : public Dune::InverseOperator<X, X>
+{
+public:
+    using domain_type = X;
+    using range_type = X;
+    using field_type = typename X::field_type;
+    using real_type = typename Dune::FieldTraits<field_type>::real_type;
+
+    //! The vector type which is used to retain the recycled subspace between solves
+    using RecycledVector = Dune::BlockVector<typename X::block_type>;
+
+    using LinearOperator = Dune::LinearOperator<X, X>;
+    using ScalarProduct = Dune::ScalarProduct<X>;
+    using Preconditioner = Dune::Preconditioner<X, X>;
+
+    /*!
+     * \brief Create the solver.
+     *
+     * \param op The linear operator of the system
+     * \param sp The scalar product which is used to orthogonalize the search directions
+     * \param prec The (right) preconditioner
+     * \param reduction The reduction of the residual which needs to be achieved
+     * \param restart The number of GMRES iterations per restart cycle
+     * \param maxIterations The maximum number of iterations
+     * \param verbose The verbosity level of the solver
+     * \param recycledSpace The recycled subspace. It is used as the initial subspace
+     *                      and it is updated at the end of each solve.
+     * \param maxRecycled The maximum number of vectors in the recycled subspace
+     */
+    RecyclingGMResSolver(LinearOperator& op,
+                         ScalarProduct& sp,
+                         Preconditioner& prec,
+                         real_type reduction,
+                         int restart,
+                         int maxIterations,
+                         int verbose,
+                         std::vector<RecycledVector>& recycledSpace,
+                         int maxRecycled)
+        : op_(op)
+        , sp_(sp)
+        , prec_(prec)
+        , reduction_(reduction)
+        , restart_(std::max(restart, 1))
+        , maxIterations_(maxIterations)
+        , verbose_(verbose)
+        , recycledSpace_(recycledSpace)
+        , maxRecycled_(std::max(maxRecycled, 0))
+    {}
+
+    void apply(X& x, X& b, Dune::InverseOperatorResult& res) override
+    { apply(x, b, reduction_, res); }
+
+    void apply(X& x, X& b, double reduction, Dune::InverseOperatorResult& res) override
+    {
+        Dune::Timer watch;
+        res.clear();
+
+        prec_.pre(x, b);
+
+        // b = b - A*x, i.e., from here on b is the residual
+        op_.applyscaleadd(-1.0, x, b);
+        const real_type def0 = sp_.norm(b);
+        real_type def = def0;
+
+        if (verbose_ > 0) {
+            std::cout << "=== RecyclingGMResSolver" << std::endl;
+            if (verbose_ > 1)
+                printDefect_(0, def);
+        }
+
+        // remove the components of the residual which are covered by the recycled space
+        setupRecycledSpace_(b);
+        for (std::size_t k = 0; k < C_.size(); ++k) {
+            const field_type alpha = sp_.dot(C_[k], b);
+            x.axpy(alpha, U_[k]);
+            b.axpy(-alpha, C_[k]);
+        }
+        if (!C_.empty())
+            def = sp_.norm(b);
+
+        int iterations = 0;
+        while (def > reduction*def0 && iterations < maxIterations_) {
+            if (!cycle_(x, b, def, def0*reduction, iterations))
+                // the Krylov space did not grow. more iterations would not help
+                break;
+        }
+
+        // keep the recycled subspace for the next solve. the solution is included as
+        // well because the solutions of subsequent systems tend to be similar.
+        if (maxRecycled_ > 0 && iterations > 0) {
+            if (static_cast<int>(U_.size()) >= maxRecycled_)
+                U_.erase(U_.begin());
+            U_.push_back(x);
+        }
+        recycledSpace_.resize(U_.size());
+        for (std::size_t k = 0; k < U_.size(); ++k) {
+            recycledSpace_[k].resize(U_[k].size());
+            for (std::size_t i = 0; i < U_[k].size(); ++i)
+                recycledSpace_[k][i] = U_[k][i];
+        }
+        U_.clear();
+        C_.clear();
+
+        prec_.post(x);
+
+        res.iterations = iterations;
+        res.reduction = (def0 > 0.0) ? def/def0 : 0.0;
+        res.converged = def <= reduction*def0;
+        res.conv_rate = (iterations > 0) ? std::pow(res.reduction, 1.0/iterations) : 0.0;
+        res.elapsed = watch.elapsed();
+
+        if (verbose_ > 0) {
+            std::cout << "=== rate=" << res.conv_rate
+                      << ", T=" << res.elapsed
+                      << ", TIT=" << res.elapsed/std::max(iterations, 1)
+                      << ", IT=" << iterations
+                      << ", recycled=" << recycledSpace_.size() << std::endl;
+        }
+    }
+
+    Dune::SolverCategory::Category category() const override
+    { return Dune::SolverCategory::category(op_); }
+
+private:
+    // build the recycled space U and its orthonormal image C = A*U for the current
+    // linear operator from the vectors retained by the previous solve
+    void setupRecycledSpace_(const X& templateVec)
+    {
+        U_.clear();
+        C_.clear();
+
+        for (const auto& storedVec : recycledSpace_) {
+            // the vectors are useless if the structure of the system has changed
+            if (storedVec.size() != templateVec.size())
+                continue;
+
+            X u(templateVec);
+            for (std::size_t i = 0; i < u.size(); ++i)
+                u[i] = storedVec[i];
+
+            X c(templateVec);
+            op_.apply(u, c);
+            const real_type origNorm = sp_.norm(c);
+
+            // modified Gram-Schmidt against the vectors which have been accepted so
+            // far. U is modified in the same way so that A*U = C is maintained.
+            for (std::size_t k = 0; k < C_.size(); ++k) {
+                const field_type alpha = sp_.dot(C_[k], c);
+                c.axpy(-alpha, C_[k]);
+                u.axpy(-alpha, U_[k]);
+            }
+
+            // drop vectors which are (almost) linearly dependent on the others
+            const real_type norm = sp_.norm(c);
+            if (!(norm > 1e-10*origNorm))
+                continue;
+
+            c *= 1.0/norm;
+            u *= 1.0/norm;
+            U_.push_back(u);
+            C_.push_back(c);
+        }
+    }
+
+    // run one restart cycle. returns false if no progress could be made.
+    bool cycle_(X& x, X& r, real_type& def, real_type targetDef, int& iterations)
+    {
+        // use the slots of the recycled space which are still empty for additional
+        // GMRES iterations
+        const int numRecycled = static_cast<int>(C_.size());
+        const int m = restart_ + std::max(maxRecycled_ - numRecycled, 0);
+
+        std::vector<X> V;
+        std::vector<X> Z;
+        V.reserve(m + 1);
+        Z.reserve(m);
+        V.push_back(r);
+        V[0] *= 1.0/def;
+
+        // H is the Hessenberg matrix of the Arnoldi process, R its QR factorized
+        // version, B the projections onto the image of the recycled space
+        std::vector<std::vector<real_type> > H(m + 1, std::vector<real_type>(m, 0.0));
+        std::vector<std::vector<real_type> > R(H);
+        std::vector<std::vector<real_type> > B(numRecycled, std::vector<real_type>(m, 0.0));
+        std::vector<real_type> cs(m, 0.0);
+        std::vector<real_type> sn(m, 0.0);
+        std::vector<real_type> g(m + 1, 0.0);
+        g[0] = def;
+
+        X w(r);
+        int j = 0;
+        while (j < m && iterations < maxIterations_) {
+            // flexible GMRES: keep the preconditioned vectors
+            Z.push_back(r);
+            Z[j] = 0.0;
+            prec_.apply(Z[j], V[j]);
+            op_.apply(Z[j], w);
+
+            // orthogonalize against the image of the recycled space...
+            for (int k = 0; k < numRecycled; ++k) {
+                B[k][j] = sp_.dot(C_[k], w);
+                w.axpy(-B[k][j], C_[k]);
+            }
+
+            // ... and against the Krylov basis
+            for (int i = 0; i <= j; ++i) {
+                H[i][j] = sp_.dot(V[i], w);
+                w.axpy(-H[i][j], V[i]);
+            }
+            H[j + 1][j] = sp_.norm(w);
+
+            // apply the previous Givens rotations to the new column and compute the
+            // one which eliminates its subdiagonal entry
+            for (int i = 0; i <= j + 1; ++i)
+                R[i][j] = H[i][j];
+            for (int i = 0; i < j; ++i) {
+                const real_type tmp = cs[i]*R[i][j] + sn[i]*R[i + 1][j];
+                R[i + 1][j] = -sn[i]*R[i][j] + cs[i]*R[i + 1][j];
+                R[i][j] = tmp;
+            }
+            const real_type nu = std::hypot(R[j][j], R[j + 1][j]);
+            if (!(nu > 0.0)) {
+                // the new search direction is useless, so drop it
+                Z.pop_back();
+                break;
+            }
+            cs[j] = R[j][j]/nu;
+            sn[j] = R[j + 1][j]/nu;
+            R[j][j] = nu;
+            R[j + 1][j] = 0.0;
+            g[j + 1] = -sn[j]*g[j];
+            g[j] = cs[j]*g[j];
+
+            ++iterations;
+            ++j;
+
+            if (verbose_ > 1)
+                printDefect_(iterations, std::abs(g[j]));
+
+            // stop if the Krylov space is invariant or if the estimated residual is
+            // small enough
+            const real_type hNorm = H[j][j - 1];
+            if (!(hNorm > 1e-14*nu))
+                break;
+
+            V.push_back(w);
+            V[j] *= 1.0/hNorm;
+
+            if (std::abs(g[j]) <= targetDef)
+                break;
+        }
+
+        const int numSteps = j;
+        if (numSteps == 0)
+            return false;
+
+        // solve the upper triangular system R*y = g
+        std::vector<real_type> y(numSteps);
+        for (int i = numSteps - 1; i >= 0; --i) {
+            real_type tmp = g[i];
+            for (int k = i + 1; k < numSteps; ++k)
+                tmp -= R[i][k]*y[k];
+            y[i] = tmp/R[i][i];
+        }
+
+        // the correction is ux = Z*y - U*(B*y). its image under the linear operator is
+        // cx = A*ux = V*H*y because A*Z = C*B + V*H and A*U = C.
+        X ux(r);
+        ux = 0.0;
+        for (int i = 0; i < numSteps; ++i)
+            ux.axpy(y[i], Z[i]);
+        for (int k = 0; k < numRecycled; ++k) {
+            real_type by = 0.0;
+            for (int i = 0; i < numSteps; ++i)
+                by += B[k][i]*y[i];
+            ux.axpy(-by, U_[k]);
+        }
+
+        X cx(r);
+        cx = 0.0;
+        for (int i = 0; i <= numSteps && i < static_cast<int>(V.size()); ++i) {
+            real_type hy = 0.0;
+            for (int k = std::max(i - 1, 0); k < numSteps; ++k)
+                hy += H[i][k]*y[k];
+            cx.axpy(hy, V[i]);
+        }
+
+        const real_type cxNorm = sp_.norm(cx);
+        if (!(cxNorm > 0.0))
+            return false;
+        ux *= 1.0/cxNorm;
+        cx *= 1.0/cxNorm;
+
+        // update the solution and the residual
+        const field_type gamma = sp_.dot(cx, r);
+        r.axpy(-gamma, cx);
+        x.axpy(gamma, ux);
+        def = sp_.norm(r);
+
+        // add the correction to the recycled space. the oldest vectors are dropped
+        // first if there is not enough room
+        if (maxRecycled_ > 0) {
+            if (static_cast<int>(U_.size()) >= maxRecycled_) {
+                U_.erase(U_.begin());
+                C_.erase(C_.begin());
+            }
+            U_.push_back(ux);
+            C_.push_back(cx);
+        }
+
+        return true;
+    }
+
+    void printDefect_(int iteration, real_type def) const
+    {
+        std::cout << std::setw(5) << iteration << "  "
+                  << std::scientific << std::setprecision(6) << def
+                  << std::defaultfloat << std::endl;
+    }
+
+    LinearOperator& op_;
+    ScalarProduct& sp_;
+    Preconditioner& prec_;
+    real_type reduction_;
+    int restart_;
+    int maxIterations_;
+    int verbose_;
+
+    std::vector<RecycledVector>& recycledSpace_;
+    int maxRecycled_;
+
+    // the recycled space and its image under the linear operator during a solve
+    std::vector<X> U_;
+    std::vector<X> C_;
+};
+
+} // namespace Linear
+} // namespace Opm
+
+#endif
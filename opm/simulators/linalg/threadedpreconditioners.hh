@@ -0,0 +1,586 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief Preconditioners for block matrices which are applied by multiple threads.
+ *
+ * The sequential preconditioners of dune-istl traverse the rows of the matrix in their
+ * natural order, i.e., they can only be used by a single thread. The preconditioners of
+ * this file instead process sets of rows which do not depend on each other
+ * concurrently:
+ *
+ * - Opm::Linear::MultiColorSOR: SOR and SSOR where the rows are visited color by color
+ *   of a coloring of the matrix graph.
+ * - Opm::Linear::MultiColorILU0: ILU(0) of the matrix whose rows and columns have been
+ *   reordered color by color.
+ * - Opm::Linear::BlockJacobiILU0: Block Jacobi with one block of consecutive rows per
+ *   thread which is approximately inverted by ILU(0).
+ */
+#ifndef EWOMS_THREADED_PRECONDITIONERS_HH
+#define EWOMS_THREADED_PRECONDITIONERS_HH
+
+#include <dune/istl/istlexception.hh>
+#include <dune/istl/preconditioner.hh>
+#include <dune/istl/solvercategory.hh>
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace Opm {
+namespace Linear {
+
+/*!
+ * \brief Distributes the rows of a sparse matrix to colors, so that rows of the same
+ *        color are not coupled by any entry of the matrix.
+ *
+ * The coloring is determined greedily in the natural order of the rows. Since an entry
+ * couples two rows regardless of whether it is above or below the diagonal, the
+ * pattern of the matrix does not need to be symmetric.
+ *
+ * \param rows Receives the indices of the rows ordered by color
+ * \param colorOffsets Receives the position of the first row of each color in the
+ *                     'rows' array plus the total number of rows
+ */
+template <class Matrix>
+void colorMatrixRows(const Matrix& A,
+                     std::vector<unsigned>& rows,
+                     std::vector<std::size_t>& colorOffsets)
+{
+    const std::size_t numRows = A.N();
+
+    // the pattern of the transposed matrix in compressed row format
+    std::vector<std::size_t> transposedOffsets(numRows + 1, 0);
+    for (auto rowIt = A.begin(); rowIt != A.end(); ++rowIt)
+        for (auto colIt = rowIt->begin(); colIt != rowIt->end(); ++colIt)
+            ++transposedOffsets[colIt.index() + 1];
+    for (std::size_t i = 0; i < numRows; ++i)
+        transposedOffsets[i + 1] += transposedOffsets[i];
+
+    std::vector<unsigned> transposedCols(transposedOffsets.back());
+    std::vector<std::size_t> fillPos(transposedOffsets.begin(), transposedOffsets.end() - 1);
+    for (auto rowIt = A.begin(); rowIt != A.end(); ++rowIt)
+        for (auto colIt = rowIt->begin(); colIt != rowIt->end(); ++colIt)
+            transposedCols[fillPos[colIt.index()]++] = static_cast<unsigned>(rowIt.index());
+
+    // assign the smallest color which is not used by any neighbor to each row. the
+    // 'forbidden' array stores the last row for which a color has been seen, so it
+    // does not need to be reset for each row.
+    std::vector<int> color(numRows, -1);
+    std::vector<std::size_t> forbidden;
+    int numColors = 0;
+    for (std::size_t rowIdx = 0; rowIdx < numRows; ++rowIdx) {
+        const auto markNeighbor = [&](std::size_t neighborIdx) {
+            if (neighborIdx != rowIdx && color[neighborIdx] >= 0)
+                forbidden[static_cast<std::size_t>(color[neighborIdx])] = rowIdx;
+        };
+
+        const auto& row = A[rowIdx];
+        for (auto colIt = row.begin(); colIt != row.end(); ++colIt)
+            markNeighbor(colIt.index());
+        for (std::size_t k = transposedOffsets[rowIdx]; k < transposedOffsets[rowIdx + 1]; ++k)
+            markNeighbor(transposedCols[k]);
+
+        int rowColor = 0;
+        while (rowColor < numColors && forbidden[static_cast<std::size_t>(rowColor)] == rowIdx)
+            ++rowColor;
+        if (rowColor == numColors) {
+            ++numColors;
+            // a value which can never be a row index marks a color as usable
+            forbidden.push_back(numRows);
+        }
+        color[rowIdx] = rowColor;
+    }
+
+    // sort the rows by color
+    colorOffsets.assign(static_cast<std::size_t>(numColors) + 1, 0);
+    for (std::size_t rowIdx = 0; rowIdx < numRows; ++rowIdx)
+        ++colorOffsets[static_cast<std::size_t>(color[rowIdx]) + 1];
+    for (int colorIdx = 0; colorIdx < numColors; ++colorIdx)
+        colorOffsets[static_cast<std::size_t>(colorIdx) + 1] += colorOffsets[static_cast<std::size_t>(colorIdx)];
+
+    rows.resize(numRows);
+    fillPos.assign(colorOffsets.begin(), colorOffsets.end() - 1);
+    for (std::size_t rowIdx = 0; rowIdx < numRows; ++rowIdx)
+        rows[fillPos[static_cast<std::size_t>(color[rowIdx])]++] = static_cast<unsigned>(rowIdx);
+}
+
+/*!
+ * \brief A successive overrelaxation (SOR) preconditioner which visits the rows color by
+ *        color.
+ *
+ * The rows of a color are independent of each other, so they are distributed over the
+ * threads. Like the SOR preconditioners of dune-istl, the input value of the correction
+ * is used as the initial guess.
+ */
+template <class Matrix, class Domain, class Range>
+class MultiColorSOR : public Dune::Preconditioner<Domain, Range>
+{
+    using Block = typename Matrix::block_type;
+    using field_type = typename Domain::field_type;
+
+public:
+    using matrix_type = Matrix;
+    using domain_type = Domain;
+    using range_type = Range;
+
+    /*!
+     * \brief Create the preconditioner.
+     *
+     * \param A The matrix to be preconditioned
+     * \param numIterations The number of sweeps per application
+     * \param relaxation The relaxation factor
+     * \param symmetric If true, each forward sweep is followed by a backward sweep (SSOR)
+     */
+    MultiColorSOR(const Matrix& A, int numIterations, field_type relaxation, bool symmetric)
+        : A_(A)
+        , numIterations_(numIterations)
+        , relaxation_(relaxation)
+        , symmetric_(symmetric)
+    {
+        colorMatrixRows(A_, rows_, colorOffsets_);
+
+        invDiag_.resize(A_.N());
+        for (std::size_t rowIdx = 0; rowIdx < A_.N(); ++rowIdx) {
+            const auto& row = A_[rowIdx];
+            const auto diagIt = row.find(rowIdx);
+            if (diagIt == row.end())
+                DUNE_THROW(Dune::ISTLError, "Missing diagonal entry in row " << rowIdx);
+            invDiag_[rowIdx] = *diagIt;
+            invDiag_[rowIdx].invert();
+        }
+    }
+
+    Dune::SolverCategory::Category category() const override
+    { return Dune::SolverCategory::sequential; }
+
+    void pre(Domain&, Range&) override
+    {}
+
+    void apply(Domain& v, const Range& d) override
+    {
+        const std::size_t numColors = colorOffsets_.size() - 1;
+        for (int iterIdx = 0; iterIdx < numIterations_; ++iterIdx) {
+            for (std::size_t colorIdx = 0; colorIdx < numColors; ++colorIdx)
+                sweepColor_(colorIdx, v, d);
+
+            if (symmetric_)
+                for (std::size_t colorIdx = numColors; colorIdx > 0; --colorIdx)
+                    sweepColor_(colorIdx - 1, v, d);
+        }
+    }
+
+    void post(Domain&) override
+    {}
+
+private:
+    // v_i = v_i + w*D_i^-1*(d_i - sum_j A_ij*v_j) for all rows of a color
+    void sweepColor_(std::size_t colorIdx, Domain& v, const Range& d) const
+    {
+        const std::size_t beginIdx = colorOffsets_[colorIdx];
+        const std::size_t endIdx = colorOffsets_[colorIdx + 1];
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (std::size_t k = beginIdx; k < endIdx; ++k) {
+            const unsigned rowIdx = rows_[k];
+
+            auto defect = d[rowIdx];
+            const auto& row = A_[rowIdx];
+            for (auto colIt = row.begin(); colIt != row.end(); ++colIt)
+                colIt->mmv(v[colIt.index()], defect);
+
+            auto update = v[rowIdx];
+            invDiag_[rowIdx].mv(defect, update);
+            v[rowIdx].axpy(relaxation_, update);
+        }
+    }
+
+    const Matrix& A_;
+    int numIterations_;
+    field_type relaxation_;
+    bool symmetric_;
+
+    std::vector<unsigned> rows_;
+    std::vector<std::size_t> colorOffsets_;
+    std::vector<Block> invDiag_;
+};
+
+/*!
+ * \brief An incomplete LU factorization without fill-in whose factorization and
+ *        triangular solves are distributed over the threads.
+ *
+ * The rows are eliminated in a given order. They are grouped into tasks, whose rows are
+ * processed one after the other, and the tasks are grouped into stages. The tasks of a
+ * stage are processed concurrently, so the rows of a task may only depend on rows of
+ * the same task or of earlier stages. Entries which couple rows of different domains
+ * are ignored.
+ */
+template <class Matrix, class Domain, class Range>
+class ScheduledILU0 : public Dune::Preconditioner<Domain, Range>
+{
+    using Block = typename Matrix::block_type;
+    using field_type = typename Domain::field_type;
+
+public:
+    using matrix_type = Matrix;
+    using domain_type = Domain;
+    using range_type = Range;
+
+    Dune::SolverCategory::Category category() const override
+    { return Dune::SolverCategory::sequential; }
+
+    void pre(Domain&, Range&) override
+    {}
+
+    /*!
+     * \brief Compute v = w*(LU)^-1*d.
+     *
+     * Like for the ILU preconditioner of dune-istl, the input value of v is ignored.
+     */
+    void apply(Domain& v, const Range& d) override
+    {
+        const std::size_t numStages = stageOffsets_.size() - 1;
+
+        // forward substitution: v_i = d_i - sum_{k before i} L_ik*v_k
+        for (std::size_t stageIdx = 0; stageIdx < numStages; ++stageIdx) {
+            const std::size_t beginTask = stageOffsets_[stageIdx];
+            const std::size_t endTask = stageOffsets_[stageIdx + 1];
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+            for (std::size_t taskIdx = beginTask; taskIdx < endTask; ++taskIdx) {
+                for (std::size_t k = taskOffsets_[taskIdx]; k < taskOffsets_[taskIdx + 1]; ++k) {
+                    const unsigned rowIdx = order_[k];
+                    auto& vRow = v[rowIdx];
+                    vRow = d[rowIdx];
+                    for (std::size_t j = lowerOffsets_[rowIdx]; j < lowerOffsets_[rowIdx + 1]; ++j)
+                        lowerValues_[j].mmv(v[lowerCols_[j]], vRow);
+                }
+            }
+        }
+
+        // backward substitution: v_i = U_ii^-1*(v_i - sum_{j after i} U_ij*v_j)
+        for (std::size_t stageIdx = numStages; stageIdx > 0; --stageIdx) {
+            const std::size_t beginTask = stageOffsets_[stageIdx - 1];
+            const std::size_t endTask = stageOffsets_[stageIdx];
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+            for (std::size_t taskIdx = beginTask; taskIdx < endTask; ++taskIdx) {
+                for (std::size_t k = taskOffsets_[taskIdx + 1]; k > taskOffsets_[taskIdx]; --k) {
+                    const unsigned rowIdx = order_[k - 1];
+                    auto tmp = v[rowIdx];
+                    for (std::size_t j = upperOffsets_[rowIdx]; j < upperOffsets_[rowIdx + 1]; ++j)
+                        upperValues_[j].mmv(v[upperCols_[j]], tmp);
+                    invDiag_[rowIdx].mv(tmp, v[rowIdx]);
+                }
+            }
+        }
+
+        v *= relaxation_;
+    }
+
+    void post(Domain&) override
+    {}
+
+protected:
+    explicit ScheduledILU0(field_type relaxation)
+        : relaxation_(relaxation)
+    {}
+
+    /*!
+     * \brief Compute the factorization.
+     *
+     * \param order The indices of the rows in the order of their elimination
+     * \param taskOffsets The position of the first row of each task in the 'order'
+     *                    array plus the total number of rows
+     * \param stageOffsets The index of the first task of each stage plus the total
+     *                     number of tasks
+     * \param domains The domain of each row
+     */
+    void factorize_(const Matrix& A,
+                    std::vector<unsigned> order,
+                    std::vector<std::size_t> taskOffsets,
+                    std::vector<std::size_t> stageOffsets,
+                    const std::vector<int>& domains)
+    {
+        order_ = std::move(order);
+        taskOffsets_ = std::move(taskOffsets);
+        stageOffsets_ = std::move(stageOffsets);
+
+        const std::size_t numRows = A.N();
+        std::vector<std::size_t> position(numRows);
+        for (std::size_t k = 0; k < numRows; ++k)
+            position[order_[k]] = k;
+
+        // determine the pattern of the factors. the entries of the lower factor of a
+        // row are sorted by the position of their column, the ones of the upper factor
+        // by the column index.
+        lowerOffsets_.assign(numRows + 1, 0);
+        upperOffsets_.assign(numRows + 1, 0);
+        for (std::size_t rowIdx = 0; rowIdx < numRows; ++rowIdx) {
+            const auto& row = A[rowIdx];
+            for (auto colIt = row.begin(); colIt != row.end(); ++colIt) {
+                const std::size_t colIdx = colIt.index();
+                if (domains[colIdx] != domains[rowIdx])
+                    continue;
+                if (position[colIdx] < position[rowIdx])
+                    ++lowerOffsets_[rowIdx + 1];
+                else if (position[colIdx] > position[rowIdx])
+                    ++upperOffsets_[rowIdx + 1];
+            }
+        }
+        for (std::size_t rowIdx = 0; rowIdx < numRows; ++rowIdx) {
+            lowerOffsets_[rowIdx + 1] += lowerOffsets_[rowIdx];
+            upperOffsets_[rowIdx + 1] += upperOffsets_[rowIdx];
+        }
+        lowerCols_.resize(lowerOffsets_.back());
+        lowerValues_.resize(lowerOffsets_.back());
+        upperCols_.resize(upperOffsets_.back());
+        upperValues_.resize(upperOffsets_.back());
+        invDiag_.resize(numRows);
+
+        // eliminate the rows using the same schedule as the triangular solves. if a
+        // row cannot be factorized, the exception is passed on after the parallel
+        // region.
+        const std::size_t numStages = stageOffsets_.size() - 1;
+        bool missingDiagonal = false;
+        std::size_t failedRowIdx = 0;
+        for (std::size_t stageIdx = 0; stageIdx < numStages; ++stageIdx) {
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+            for (std::size_t taskIdx = stageOffsets_[stageIdx]; taskIdx < stageOffsets_[stageIdx + 1]; ++taskIdx) {
+                for (std::size_t k = taskOffsets_[taskIdx]; k < taskOffsets_[taskIdx + 1]; ++k) {
+                    const unsigned rowIdx = order_[k];
+                    if (!factorizeRow_(A, rowIdx, position, domains)) {
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+                        {
+                            missingDiagonal = true;
+                            failedRowIdx = rowIdx;
+                        }
+                    }
+                }
+            }
+
+            if (missingDiagonal)
+                DUNE_THROW(Dune::ISTLError, "Missing diagonal entry in row " << failedRowIdx);
+        }
+    }
+
+private:
+    // compute the factors of a row given that all rows which precede it have already
+    // been factorized. returns false if the row does not exhibit a diagonal entry.
+    bool factorizeRow_(const Matrix& A,
+                       unsigned rowIdx,
+                       const std::vector<std::size_t>& position,
+                       const std::vector<int>& domains)
+    {
+        // copy the entries of the row which belong to its domain
+        std::vector<std::pair<unsigned, Block> > entries;
+        const auto& row = A[rowIdx];
+        for (auto colIt = row.begin(); colIt != row.end(); ++colIt)
+            if (domains[colIt.index()] == domains[rowIdx])
+                entries.emplace_back(static_cast<unsigned>(colIt.index()), *colIt);
+
+        const auto findEntry = [&entries](unsigned colIdx) -> Block* {
+            auto it = std::lower_bound(entries.begin(), entries.end(), colIdx,
+                                       [](const std::pair<unsigned, Block>& entry, unsigned idx)
+                                       { return entry.first < idx; });
+            if (it == entries.end() || it->first != colIdx)
+                return nullptr;
+            return &it->second;
+        };
+
+        // the columns of the lower factor in the order of their elimination
+        std::vector<unsigned> lowerCols;
+        for (const auto& entry : entries)
+            if (position[entry.first] < position[rowIdx])
+                lowerCols.push_back(entry.first);
+        std::sort(lowerCols.begin(), lowerCols.end(),
+                  [&position](unsigned a, unsigned b)
+                  { return position[a] < position[b]; });
+
+        // a_ij = a_ij - a_ik*U_kk^-1*U_kj for all eliminated rows k
+        std::size_t lowerIdx = lowerOffsets_[rowIdx];
+        for (unsigned k : lowerCols) {
+            Block& l = *findEntry(k);
+            l.rightmultiply(invDiag_[k]);
+
+            for (std::size_t j = upperOffsets_[k]; j < upperOffsets_[k + 1]; ++j) {
+                Block* a = findEntry(upperCols_[j]);
+                if (!a)
+                    // no fill-in
+                    continue;
+
+                Block tmp(l);
+                tmp.rightmultiply(upperValues_[j]);
+                *a -= tmp;
+            }
+
+            lowerCols_[lowerIdx] = k;
+            lowerValues_[lowerIdx] = l;
+            ++lowerIdx;
+        }
+
+        const Block* diag = findEntry(rowIdx);
+        if (!diag)
+            return false;
+        invDiag_[rowIdx] = *diag;
+        invDiag_[rowIdx].invert();
+
+        std::size_t upperIdx = upperOffsets_[rowIdx];
+        for (const auto& entry : entries) {
+            if (position[entry.first] <= position[rowIdx])
+                continue;
+
+            upperCols_[upperIdx] = entry.first;
+            upperValues_[upperIdx] = entry.second;
+            ++upperIdx;
+        }
+
+        return true;
+    }
+
+    field_type relaxation_;
+
+    std::vector<unsigned> order_;
+    std::vector<std::size_t> taskOffsets_;
+    std::vector<std::size_t> stageOffsets_;
+
+    // the factors in compressed row format, indexed by the rows of the matrix
+    std::vector<std::size_t> lowerOffsets_;
+    std::vector<unsigned> lowerCols_;
+    std::vector<Block> lowerValues_;
+    std::vector<std::size_t> upperOffsets_;
+    std::vector<unsigned> upperCols_;
+    std::vector<Block> upperValues_;
+    std::vector<Block> invDiag_;
+};
+
+/*!
+ * \brief ILU(0) of the matrix whose rows and columns are reordered by color.
+ *
+ * Rows of the same color are not coupled, so they can be eliminated and substituted
+ * concurrently. Note that the reordering changes the factorization, i.e., the result
+ * is not the same as the one of the ILU(0) preconditioner of dune-istl.
+ */
+template <class Matrix, class Domain, class Range>
+class MultiColorILU0 : public ScheduledILU0<Matrix, Domain, Range>
+{
+    using ParentType = ScheduledILU0<Matrix, Domain, Range>;
+    using field_type = typename Domain::field_type;
+
+public:
+    /*!
+     * \brief Create the preconditioner.
+     *
+     * \param A The matrix to be preconditioned
+     * \param relaxation The factor by which the result is scaled
+     * \param numThreads The number of threads which process the rows of a color
+     */
+    MultiColorILU0(const Matrix& A, field_type relaxation, unsigned numThreads)
+        : ParentType(relaxation)
+    {
+        std::vector<unsigned> rows;
+        std::vector<std::size_t> colorOffsets;
+        colorMatrixRows(A, rows, colorOffsets);
+
+        // each color is one stage whose rows are split into one task per thread
+        numThreads = std::max(numThreads, 1u);
+        std::vector<std::size_t> taskOffsets;
+        std::vector<std::size_t> stageOffsets;
+        for (std::size_t colorIdx = 0; colorIdx + 1 < colorOffsets.size(); ++colorIdx) {
+            stageOffsets.push_back(taskOffsets.size());
+
+            const std::size_t beginIdx = colorOffsets[colorIdx];
+            const std::size_t numColorRows = colorOffsets[colorIdx + 1] - beginIdx;
+            for (unsigned threadIdx = 0; threadIdx < numThreads; ++threadIdx)
+                taskOffsets.push_back(beginIdx + numColorRows*threadIdx/numThreads);
+        }
+        stageOffsets.push_back(taskOffsets.size());
+        taskOffsets.push_back(rows.size());
+
+        this->factorize_(A, std::move(rows), std::move(taskOffsets), std::move(stageOffsets),
+                         std::vector<int>(A.N(), 0));
+    }
+};
+
+/*!
+ * \brief Block Jacobi preconditioner where each block consists of consecutive rows and
+ *        is approximately inverted by ILU(0).
+ *
+ * There is one block per thread and the entries which couple different blocks are
+ * ignored.
+ */
+template <class Matrix, class Domain, class Range>
+class BlockJacobiILU0 : public ScheduledILU0<Matrix, Domain, Range>
+{
+    using ParentType = ScheduledILU0<Matrix, Domain, Range>;
+    using field_type = typename Domain::field_type;
+
+public:
+    /*!
+     * \brief Create the preconditioner.
+     *
+     * \param A The matrix to be preconditioned
+     * \param relaxation The factor by which the result is scaled
+     * \param numBlocks The number of blocks, usually the number of threads
+     */
+    BlockJacobiILU0(const Matrix& A, field_type relaxation, unsigned numBlocks)
+        : ParentType(relaxation)
+    {
+        const std::size_t numRows = A.N();
+        numBlocks = std::max(numBlocks, 1u);
+
+        std::vector<unsigned> rows(numRows);
+        std::vector<int> domains(numRows);
+        std::vector<std::size_t> taskOffsets;
+        for (unsigned blockIdx = 0; blockIdx < numBlocks; ++blockIdx) {
+            const std::size_t beginIdx = numRows*blockIdx/numBlocks;
+            const std::size_t endIdx = numRows*(blockIdx + 1)/numBlocks;
+            taskOffsets.push_back(beginIdx);
+            for (std::size_t rowIdx = beginIdx; rowIdx < endIdx; ++rowIdx) {
+                rows[rowIdx] = static_cast<unsigned>(rowIdx);
+                domains[rowIdx] = static_cast<int>(blockIdx);
+            }
+        }
+        taskOffsets.push_back(numRows);
+
+        // all blocks are independent, i.e., there is a single stage
+        std::vector<std::size_t> stageOffsets = {0, numBlocks};
+
+        this->factorize_(A, std::move(rows), std::move(taskOffsets), std::move(stageOffsets),
+                         domains);
+    }
+};
+
+} // namespace Linear
+} // namespace Opm
+
+#endif
@@ -0,0 +1,253 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \brief Measures the time which is required to set up an overlapping matrix for 1 to
+ *        1024 simulated processes.
+ *
+ * The vertices of a 2D lattice with a nine point stencil are distributed to a grid of
+ * simulated processes whose subdomains share the vertices on their boundaries. The real
+ * processes form a window at the center of this grid, i.e., each of them sets up the
+ * overlapping matrix for the subdomain of one simulated process. Since the setup only
+ * involves the processes whose subdomains are close to each other, the process at the
+ * center of a 3x3 window sees the same peers as an interior process of a run with the
+ * full number of processes. The lattice is the same for all numbers of simulated
+ * processes, i.e., the benchmark measures the strong scaling of the setup.
+ *
+ * Usage: mpirun -np 9 benchmark_overlapsetup [LATTICE_SIZE [OVERLAP_SIZE [MAX_RANKS]]]
+ */
+#include "config.h"
+
+#include <opm/models/utils/timer.hh>
+#include <opm/simulators/linalg/overlappingbcrsmatrix.hh>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/istl/bcrsmatrix.hh>
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#if HAVE_MPI
+#include <mpi.h>
+#endif
+
+using Matrix = Dune::BCRSMatrix<Dune::FieldMatrix<double, 1, 1>>;
+using OverlappingMatrix = Opm::Linear::OverlappingBCRSMatrix<Matrix>;
+
+// the subdomain of a simulated process which is set up by a real process
+struct Subdomain
+{
+    bool active = false;
+    unsigned xBegin = 0, xEnd = 0; // inclusive
+    unsigned yBegin = 0, yEnd = 0; // inclusive
+
+    unsigned nx() const
+    { return active ? xEnd - xBegin + 1 : 0; }
+
+    unsigned ny() const
+    { return active ? yEnd - yBegin + 1 : 0; }
+
+    bool contains(unsigned x, unsigned y) const
+    { return active && xBegin <= x && x <= xEnd && yBegin <= y && y <= yEnd; }
+
+    unsigned nativeIdx(unsigned x, unsigned y) const
+    { return (y - yBegin)*nx() + x - xBegin; }
+};
+
+class WindowDecomposition
+{
+public:
+    WindowDecomposition(unsigned latticeSize, unsigned numSimulatedRanks, unsigned numProcs)
+        : latticeSize_(latticeSize)
+    {
+        // arrange the simulated processes as well as the real ones in grids which are
+        // as square as possible
+        factorize_(numSimulatedRanks, numSimX_, numSimY_);
+        factorize_(numProcs, numProcsX_, numProcsY_);
+        if (latticeSize_ - 1 < std::max(numSimX_, numSimY_))
+            throw std::invalid_argument("The lattice is too small for the number of processes");
+
+        // the window of simulated processes which are set up by the real ones
+        windowX_ = std::min(numProcsX_, numSimX_);
+        windowY_ = std::min(numProcsY_, numSimY_);
+        offsetX_ = (numSimX_ - windowX_)/2;
+        offsetY_ = (numSimY_ - windowY_)/2;
+    }
+
+    unsigned numProcs() const
+    { return numProcsX_*numProcsY_; }
+
+    Subdomain subdomain(unsigned rank) const
+    {
+        Subdomain result;
+        const unsigned i = rank % numProcsX_;
+        const unsigned j = rank / numProcsX_;
+        if (i >= windowX_ || j >= windowY_)
+            return result;
+
+        result.active = true;
+        result.xBegin = (latticeSize_ - 1)*(offsetX_ + i)/numSimX_;
+        result.xEnd = (latticeSize_ - 1)*(offsetX_ + i + 1)/numSimX_;
+        result.yBegin = (latticeSize_ - 1)*(offsetY_ + j)/numSimY_;
+        result.yEnd = (latticeSize_ - 1)*(offsetY_ + j + 1)/numSimY_;
+        return result;
+    }
+
+    Matrix nativeMatrix(const Subdomain& subdomain) const
+    {
+        const unsigned numNative = subdomain.nx()*subdomain.ny();
+        Matrix A(numNative, numNative, Matrix::random);
+        for (unsigned nativeIdx = 0; nativeIdx < numNative; ++nativeIdx)
+            A.setrowsize(nativeIdx, 9);
+        A.endrowsizes();
+
+        if (subdomain.active) {
+            for (unsigned y = subdomain.yBegin; y <= subdomain.yEnd; ++y)
+                for (unsigned x = subdomain.xBegin; x <= subdomain.xEnd; ++x)
+                    for (unsigned yy = (y > subdomain.yBegin ? y - 1 : y); yy <= std::min(y + 1, subdomain.yEnd); ++yy)
+                        for (unsigned xx = (x > subdomain.xBegin ? x - 1 : x); xx <= std::min(x + 1, subdomain.xEnd); ++xx)
+                            A.addindex(subdomain.nativeIdx(x, y), subdomain.nativeIdx(xx, yy));
+        }
+        A.endindices();
+        A = 1.0;
+        return A;
+    }
+
+    // the vertices which are shared with the subdomains of the other real processes.
+    // the subdomains outside of the window are treated like the boundary of the domain.
+    Opm::Linear::BorderList borderList(unsigned rank) const
+    {
+        Opm::Linear::BorderList result;
+        const Subdomain subdomain = this->subdomain(rank);
+        if (!subdomain.active)
+            return result;
+
+        for (unsigned peerRank = 0; peerRank < numProcs(); ++peerRank) {
+            const Subdomain peerSubdomain = this->subdomain(peerRank);
+            if (peerRank == rank || !peerSubdomain.active)
+                continue;
+
+            for (unsigned y = subdomain.yBegin; y <= subdomain.yEnd; ++y) {
+                for (unsigned x = subdomain.xBegin; x <= subdomain.xEnd; ++x) {
+                    if (!peerSubdomain.contains(x, y))
+                        continue;
+                    result.push_back({static_cast<Opm::Linear::Index>(subdomain.nativeIdx(x, y)),
+                                      static_cast<Opm::Linear::Index>(peerSubdomain.nativeIdx(x, y)),
+                                      static_cast<Opm::Linear::ProcessRank>(peerRank),
+                                      /*borderDistance=*/0});
+                }
+            }
+        }
+        return result;
+    }
+
+private:
+    static void factorize_(unsigned n, unsigned& nx, unsigned& ny)
+    {
+        ny = 1;
+        for (unsigned k = 1; k*k <= n; ++k)
+            if (n % k == 0)
+                ny = k;
+        nx = n/ny;
+    }
+
+    unsigned latticeSize_;
+    unsigned numSimX_, numSimY_;
+    unsigned numProcsX_, numProcsY_;
+    unsigned windowX_, windowY_;
+    unsigned offsetX_, offsetY_;
+};
+
+double maxOverProcesses(double value)
+{
+#if HAVE_MPI
+    double result;
+    MPI_Allreduce(&value, &result, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+    return result;
+#else
+    return value;
+#endif
+}
+
+void barrier()
+{
+#if HAVE_MPI
+    MPI_Barrier(MPI_COMM_WORLD);
+#endif
+}
+
+int main(int argc, char** argv)
+{
+    const auto& mpiHelper = Dune::MPIHelper::instance(argc, argv);
+    const unsigned rank = static_cast<unsigned>(mpiHelper.rank());
+    const unsigned numProcs = static_cast<unsigned>(mpiHelper.size());
+
+    const unsigned latticeSize = argc > 1 ? static_cast<unsigned>(std::atoi(argv[1])) : 512;
+    const unsigned overlapSize = argc > 2 ? static_cast<unsigned>(std::atoi(argv[2])) : 2;
+    const unsigned maxRanks = argc > 3 ? static_cast<unsigned>(std::atoi(argv[3])) : 1024;
+    const unsigned numRepetitions = 3;
+
+    if (rank == 0)
+        std::cout << "Setup of the overlapping matrix for a " << latticeSize << "x" << latticeSize
+                  << " lattice with an overlap of size " << overlapSize
+                  << " using " << numProcs << " real processes\n"
+                  << std::setw(16) << "simulated ranks"
+                  << std::setw(16) << "rows per rank"
+                  << std::setw(16) << "max peers"
+                  << std::setw(16) << "setup time [s]" << std::endl;
+
+    for (unsigned numSimulatedRanks = 1; numSimulatedRanks <= maxRanks; numSimulatedRanks *= 2) {
+        const WindowDecomposition decomposition(latticeSize, numSimulatedRanks, numProcs);
+        const Subdomain subdomain = decomposition.subdomain(rank);
+        const Matrix nativeMatrix = decomposition.nativeMatrix(subdomain);
+        const Opm::Linear::BorderList borderList = decomposition.borderList(rank);
+
+        // take the fastest of a few repetitions, where the time of a repetition is the
+        // one of the slowest process
+        double setupTime = std::numeric_limits<double>::max();
+        double numPeers = 0;
+        for (unsigned repIdx = 0; repIdx < numRepetitions; ++repIdx) {
+            barrier();
+            Opm::Timer setupTimer;
+            setupTimer.start();
+            OverlappingMatrix A(nativeMatrix, borderList, Opm::Linear::BlackList(), overlapSize);
+            setupTimer.stop();
+            setupTime = std::min(setupTime, maxOverProcesses(setupTimer.realTimeElapsed()));
+            numPeers = maxOverProcesses(static_cast<double>(A.overlap().peerSet().size()));
+        }
+
+        if (rank == 0)
+            std::cout << std::setw(16) << numSimulatedRanks
+                      << std::setw(16) << subdomain.nx()*subdomain.ny()
+                      << std::setw(16) << numPeers
+                      << std::setw(16) << setupTime << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,65 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief Two-phase test for the immiscible model which uses the element-centered finite
+ *        volume discretization in conjunction with automatic differentiation and a GMRES
+ *        linear solver which recycles a Krylov subspace across linear solves
+ */
+#include "config.h"
+
+#include "lens_immiscible_ecfv_ad.hh"
+
+#include <opm/models/utils/start.hh>
+#include <opm/simulators/linalg/parallelistlbackend.hh>
+
+namespace Opm::Properties {
+
+// Create new type tags
+namespace TTag {
+struct LensProblemEcfvAdRecycling { using InheritsFrom = std::tuple<LensProblemEcfvAd>; };
+} // end namespace TTag
+
+// use the linear solvers of dune-istl
+template<class TypeTag>
+struct LinearSolverSplice<TypeTag, TTag::LensProblemEcfvAdRecycling>
+{ using type = TTag::ParallelIstlLinearSolver; };
+
+// use the GMRES solver which retains a subspace between the linear solves
+template<class TypeTag>
+struct LinearSolverWrapper<TypeTag, TTag::LensProblemEcfvAdRecycling>
+{ using type = Opm::Linear::SolverWrapperRecyclingGMRes<TypeTag>; };
+
+// start each linear solve with the solution of the previous one
+template<class TypeTag>
+struct LinearSolverUsePreviousSolution<TypeTag, TTag::LensProblemEcfvAdRecycling>
+{ static constexpr bool value = true; };
+
+} // namespace Opm::Properties
+
+int main(int argc, char **argv)
+{
+    using ProblemTypeTag = Opm::Properties::TTag::LensProblemEcfvAdRecycling;
+    return Opm::start<ProblemTypeTag>(argc, argv);
+}
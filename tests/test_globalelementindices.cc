@@ -0,0 +1,91 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \brief A test for the translation of partition-independent element indices to the
+ *        elements of the local process.
+ *
+ * The test must yield the same result for any number of processes.
+ */
+#include "config.h"
+
+#include <opm/models/parallel/globalelementindices.hh>
+
+#include <dune/common/fvector.hh>
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/grid/yaspgrid.hh>
+
+#include <array>
+#include <bitset>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+int main(int argc, char** argv)
+{
+    const auto& mpiHelper = Dune::MPIHelper::instance(argc, argv);
+
+    using Grid = Dune::YaspGrid<2>;
+    constexpr int nx = 8;
+    constexpr int ny = 6;
+    const Dune::FieldVector<double, 2> upperRight = { double(nx), double(ny) };
+    const std::array<int, 2> cells = { nx, ny };
+    Grid grid(upperRight, cells, std::bitset<2>(), /*overlap=*/1);
+    const auto gridView = grid.leafGridView();
+
+    // the global indices of a structured grid are the cartesian indices. the last
+    // index does not exist and index 9 is requested twice.
+    const std::vector<unsigned> globalIndices = { 47, 0, 9, 20, 9, 1000 };
+    std::vector<int> numVisits(globalIndices.size(), 0);
+    Opm::forEachElementOfGlobalIndices(gridView, globalIndices,
+                                       [&](std::size_t i, const auto& elem)
+    {
+        const auto& center = elem.geometry().center();
+        const unsigned cartesianIdx =
+            static_cast<unsigned>(std::floor(center[1])*nx + std::floor(center[0]));
+        if (cartesianIdx != globalIndices[i])
+            throw std::logic_error("Global index "+std::to_string(globalIndices[i])
+                                   +" has been mapped to the element with cartesian index "
+                                   +std::to_string(cartesianIdx));
+        if (elem.partitionType() != Dune::InteriorEntity)
+            throw std::logic_error("A global index has been mapped to a non-interior element");
+        ++numVisits[i];
+    });
+
+    // each existing element is visited by exactly one process
+    gridView.comm().sum(numVisits.data(), static_cast<int>(numVisits.size()));
+    for (std::size_t i = 0; i < globalIndices.size(); ++i) {
+        const int expectedVisits = (globalIndices[i] < unsigned(nx*ny)) ? 1 : 0;
+        if (numVisits[i] != expectedVisits)
+            throw std::logic_error("Global index "+std::to_string(globalIndices[i])
+                                   +" has been visited "+std::to_string(numVisits[i])
+                                   +" times instead of "+std::to_string(expectedVisits));
+    }
+
+    if (mpiHelper.rank() == 0)
+        std::cout << "Global element index test successful on "
+                  << mpiHelper.size() << " processes" << std::endl;
+    return 0;
+}
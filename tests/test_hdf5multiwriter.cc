@@ -0,0 +1,208 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \brief A test for the precision, the field filter and the element selection of the
+ *        HDF5 output writer.
+ *
+ * The fields are written for a structured grid and read back using the HDF5 library.
+ */
+#include "config.h"
+
+#include <opm/models/io/hdf5multiwriter.hh>
+
+#include <dune/common/fvector.hh>
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/grid/yaspgrid.hh>
+
+#include <hdf5.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using Grid = Dune::YaspGrid<2>;
+using GridView = Grid::LeafGridView;
+using Writer = Opm::Hdf5MultiWriter<GridView>;
+
+constexpr int nx = 8;
+constexpr int ny = 6;
+
+// the values of the element centered fields are the cartesian indices of the elements
+std::vector<double> cartesianIndices(const GridView& gridView)
+{
+    Dune::MultipleCodimMultipleGeomTypeMapper<GridView> mapper(gridView, Dune::mcmgElementLayout());
+    std::vector<double> result(static_cast<std::size_t>(gridView.size(0)));
+    for (const auto& elem : elements(gridView)) {
+        const auto& center = elem.geometry().center();
+        result[mapper.index(elem)] = std::floor(center[1])*nx + std::floor(center[0]);
+    }
+    return result;
+}
+
+// a data set of an HDF5 file which has been written by the writer
+struct DataSet
+{
+    bool exists = false;
+    std::size_t typeSize = 0;
+    std::vector<double> values;
+};
+
+DataSet readDataSet(const std::string& fileName, const std::string& path)
+{
+    DataSet result;
+    hid_t file = H5Fopen(fileName.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+    if (file < 0)
+        throw std::runtime_error("Could not open '"+fileName+"'");
+
+    if (H5Lexists(file, path.c_str(), H5P_DEFAULT) > 0) {
+        hid_t dataSet = H5Dopen2(file, path.c_str(), H5P_DEFAULT);
+        hid_t type = H5Dget_type(dataSet);
+        hid_t space = H5Dget_space(dataSet);
+
+        result.exists = true;
+        result.typeSize = H5Tget_size(type);
+        result.values.resize(static_cast<std::size_t>(H5Sget_simple_extent_npoints(space)));
+        if (!result.values.empty())
+            H5Dread(dataSet, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT,
+                    result.values.data());
+
+        H5Sclose(space);
+        H5Tclose(type);
+        H5Dclose(dataSet);
+    }
+
+    H5Fclose(file);
+    return result;
+}
+
+// write a pressure and a saturation field for a single report step
+template <class Configure>
+void writeFields(const GridView& gridView, const std::string& simName, Configure configure)
+{
+    std::vector<double> pressure = cartesianIndices(gridView);
+    std::vector<double> saturation(pressure.size(), 0.25);
+
+    Writer writer(gridView, ".", simName);
+    configure(writer);
+    writer.beginWrite(/*t=*/0.0);
+    writer.attachScalarElementData(pressure, "pressure");
+    writer.attachScalarElementData(saturation, "saturation");
+    writer.endWrite();
+}
+
+void testPrecision(const GridView& gridView)
+{
+    for (bool singlePrecision : { true, false }) {
+        const std::string simName = singlePrecision ? "test_hdf5_float32" : "test_hdf5_float64";
+        writeFields(gridView, simName,
+                    [&](Writer& writer) { writer.setSinglePrecision(singlePrecision); });
+
+        const DataSet pressure = readDataSet(simName + ".h5", "/step_00000/cell/pressure");
+        const std::size_t expectedSize = singlePrecision ? 4 : 8;
+        if (!pressure.exists || pressure.typeSize != expectedSize)
+            throw std::logic_error("The pressure of "+simName+" is not written using "
+                                   +std::to_string(expectedSize)+" byte floating point values");
+        if (pressure.values != cartesianIndices(gridView))
+            throw std::logic_error("The pressure of "+simName+" has not been written correctly");
+    }
+}
+
+void testFieldFilter(const GridView& gridView)
+{
+    const std::string simName = "test_hdf5_filter";
+    writeFields(gridView, simName,
+                [](Writer& writer) { writer.setFieldFilter("sat*, temperature"); });
+
+    if (!readDataSet(simName + ".h5", "/step_00000/cell/saturation").exists)
+        throw std::logic_error("A selected field has not been written");
+    if (readDataSet(simName + ".h5", "/step_00000/cell/pressure").exists)
+        throw std::logic_error("A field which has not been selected has been written");
+}
+
+// the selected elements are identified by the values of the pressure field
+std::vector<double> writtenElements(const GridView& gridView,
+                                    const std::string& simName,
+                                    std::vector<unsigned> elemIndices,
+                                    bool restrictToBox)
+{
+    writeFields(gridView, simName, [&](Writer& writer) {
+        if (restrictToBox)
+            writer.setOutputRegion({1.0, 1.0}, {4.0, 3.0});
+        if (!elemIndices.empty())
+            writer.setOutputElements(elemIndices);
+    });
+
+    const DataSet connectivity = readDataSet(simName + ".h5", "/grid_0/connectivity");
+    std::vector<double> result = readDataSet(simName + ".h5", "/step_00000/cell/pressure").values;
+    if (connectivity.values.size() != 4*result.size())
+        throw std::logic_error("The number of elements of the grid and of the fields of "
+                               +simName+" differ");
+
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+void testElementSelection(const GridView& gridView)
+{
+    // the centers of the elements within the box are located in [1, 4] x [1, 3]
+    const std::vector<double> boxElements = { 9, 10, 11, 17, 18, 19 };
+    if (writtenElements(gridView, "test_hdf5_box", {}, /*restrictToBox=*/true) != boxElements)
+        throw std::logic_error("The elements within the box have not been written correctly");
+
+    // the indices refer to the cartesian index of the elements. invalid indices are
+    // ignored.
+    const std::vector<unsigned> elemIndices = { 47, 0, 9, 1000, 20 };
+    const std::vector<double> selectedElements = { 0, 9, 20, 47 };
+    if (writtenElements(gridView, "test_hdf5_elements", elemIndices, /*restrictToBox=*/false)
+        != selectedElements)
+        throw std::logic_error("The selected elements have not been written correctly");
+
+    // both restrictions apply at the same time
+    const std::vector<double> intersection = { 9 };
+    if (writtenElements(gridView, "test_hdf5_box_elements", elemIndices, /*restrictToBox=*/true)
+        != intersection)
+        throw std::logic_error("The selected elements within the box have not been "
+                               "written correctly");
+}
+
+int main(int argc, char** argv)
+{
+    Dune::MPIHelper::instance(argc, argv);
+
+    const Dune::FieldVector<double, 2> upperRight = { double(nx), double(ny) };
+    const std::array<int, 2> cells = { nx, ny };
+    Grid grid(upperRight, cells);
+    const GridView gridView = grid.leafGridView();
+
+    testPrecision(gridView);
+    testFieldFilter(gridView);
+    testElementSelection(gridView);
+
+    std::cout << "HDF5 output test successful" << std::endl;
+    return 0;
+}
@@ -0,0 +1,162 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \brief A test for the reverse Cuthill-McKee ordering of the rows of a sparse matrix.
+ */
+#include "config.h"
+
+#include <opm/simulators/linalg/matrixreordering.hh>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/istl/bcrsmatrix.hh>
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+using Matrix = Dune::BCRSMatrix<Dune::FieldMatrix<double, 1, 1>>;
+using Pattern = std::vector<std::set<unsigned>>;
+
+Matrix createMatrix(const Pattern& pattern)
+{
+    const std::size_t n = pattern.size();
+    Matrix A(n, n, Matrix::random);
+    for (std::size_t rowIdx = 0; rowIdx < n; ++rowIdx)
+        A.setrowsize(rowIdx, pattern[rowIdx].size());
+    A.endrowsizes();
+    for (std::size_t rowIdx = 0; rowIdx < n; ++rowIdx)
+        for (unsigned colIdx : pattern[rowIdx])
+            A.addindex(rowIdx, colIdx);
+    A.endindices();
+    A = 1.0;
+    return A;
+}
+
+// the five point stencil of a 2D lattice. the rows are numbered randomly, so the
+// bandwidth of the matrix is large.
+Pattern laplacianPattern(unsigned nx, unsigned ny, unsigned firstRow, unsigned numRows, unsigned seed)
+{
+    std::vector<unsigned> rowIdx(nx*ny);
+    std::iota(rowIdx.begin(), rowIdx.end(), firstRow);
+    std::shuffle(rowIdx.begin(), rowIdx.end(), std::mt19937(seed));
+
+    Pattern pattern(numRows);
+    for (unsigned j = 0; j < ny; ++j) {
+        for (unsigned i = 0; i < nx; ++i) {
+            auto& row = pattern[rowIdx[j*nx + i]];
+            row.insert(rowIdx[j*nx + i]);
+            if (i > 0)
+                row.insert(rowIdx[j*nx + i - 1]);
+            if (i < nx - 1)
+                row.insert(rowIdx[j*nx + i + 1]);
+            if (j > 0)
+                row.insert(rowIdx[(j - 1)*nx + i]);
+            if (j < ny - 1)
+                row.insert(rowIdx[(j + 1)*nx + i]);
+        }
+    }
+    return pattern;
+}
+
+// returns the position of each row in the ordering and throws if the ordering is not a
+// permutation of the rows
+std::vector<int> checkPermutation(const std::vector<Opm::Linear::Index>& order, std::size_t numRows)
+{
+    if (order.size() != numRows)
+        throw std::logic_error("The ordering does not contain all rows");
+
+    std::vector<int> position(numRows, -1);
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        if (order[i] < 0 || static_cast<std::size_t>(order[i]) >= numRows)
+            throw std::logic_error("The ordering contains an invalid row index");
+        if (position[static_cast<std::size_t>(order[i])] >= 0)
+            throw std::logic_error("The ordering contains a row twice");
+        position[static_cast<std::size_t>(order[i])] = static_cast<int>(i);
+    }
+    return position;
+}
+
+int bandwidth(const Pattern& pattern, const std::vector<int>& position)
+{
+    int result = 0;
+    for (std::size_t rowIdx = 0; rowIdx < pattern.size(); ++rowIdx)
+        for (unsigned colIdx : pattern[rowIdx])
+            result = std::max(result, std::abs(position[rowIdx] - position[colIdx]));
+    return result;
+}
+
+void testOrdering(const Pattern& pattern, int maxBandwidth)
+{
+    std::vector<Opm::Linear::Index> order;
+    Opm::Linear::reverseCuthillMcKee(createMatrix(pattern), order);
+    const auto position = checkPermutation(order, pattern.size());
+
+    std::vector<int> identity(pattern.size());
+    std::iota(identity.begin(), identity.end(), 0);
+    const int bandwidthBefore = bandwidth(pattern, identity);
+    const int bandwidthAfter = bandwidth(pattern, position);
+    std::cout << "bandwidth before: " << bandwidthBefore
+              << ", after: " << bandwidthAfter << std::endl;
+
+    if (bandwidthAfter > maxBandwidth)
+        throw std::logic_error("The ordering does not reduce the bandwidth sufficiently");
+}
+
+int main()
+{
+    // a single lattice. the bandwidth of the ordering by rows is the number of rows of
+    // the lattice, and the reverse Cuthill-McKee ordering should not be much worse.
+    const unsigned nx = 60;
+    const unsigned ny = 40;
+    testOrdering(laplacianPattern(nx, ny, /*firstRow=*/0, nx*ny, /*seed=*/1), 2*ny);
+
+    // two lattices which are not connected and a few rows without any neighbors
+    Pattern pattern = laplacianPattern(nx, ny, /*firstRow=*/0, 2*nx*ny + 3, /*seed=*/2);
+    const Pattern secondPattern = laplacianPattern(nx, ny, /*firstRow=*/nx*ny, 2*nx*ny + 3, /*seed=*/3);
+    for (std::size_t rowIdx = nx*ny; rowIdx < 2*nx*ny; ++rowIdx)
+        pattern[rowIdx] = secondPattern[rowIdx];
+    for (unsigned rowIdx = 2*nx*ny; rowIdx < 2*nx*ny + 3; ++rowIdx)
+        pattern[rowIdx].insert(rowIdx);
+    testOrdering(pattern, 2*ny);
+
+    // a pattern which is not symmetric: each coupling is only stored in the row with
+    // the larger index, i.e., the matrix is lower triangular
+    Pattern triangularPattern = laplacianPattern(nx, ny, /*firstRow=*/0, nx*ny, /*seed=*/4);
+    for (std::size_t rowIdx = 0; rowIdx < triangularPattern.size(); ++rowIdx) {
+        for (auto it = triangularPattern[rowIdx].begin(); it != triangularPattern[rowIdx].end();) {
+            if (*it > rowIdx)
+                it = triangularPattern[rowIdx].erase(it);
+            else
+                ++it;
+        }
+    }
+    testOrdering(triangularPattern, 2*ny);
+
+    return 0;
+}
@@ -0,0 +1,155 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \brief A test for preconditioners which use single precision within a linear solver
+ *        which uses double precision.
+ */
+#include "config.h"
+
+#include <opm/simulators/linalg/mixedprecisionpreconditioner.hh>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+#include <dune/istl/operators.hh>
+#include <dune/istl/preconditioners.hh>
+#include <dune/istl/solvers.hh>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+
+using Matrix = Dune::BCRSMatrix<Dune::FieldMatrix<double, 2, 2>>;
+using Vector = Dune::BlockVector<Dune::FieldVector<double, 2>>;
+using FloatMatrix = Dune::BCRSMatrix<Dune::FieldMatrix<float, 2, 2>>;
+using FloatVector = Dune::BlockVector<Dune::FieldVector<float, 2>>;
+
+using DoubleILU = Dune::SeqILU<Matrix, Vector, Vector>;
+using MixedILU = Opm::Linear::MixedPrecisionPreconditioner<Dune::SeqILU<FloatMatrix, FloatVector, FloatVector>,
+                                                           Matrix,
+                                                           Vector>;
+
+// the five point stencil of a 2D lattice with two equations per cell which are also
+// coupled within each cell
+Matrix createMatrix(unsigned nx, unsigned ny)
+{
+    const unsigned n = nx*ny;
+    Matrix A(n, n, 5*n, Matrix::row_wise);
+    for (auto row = A.createbegin(); row != A.createend(); ++row) {
+        const unsigned i = row.index() % nx;
+        const unsigned j = row.index() / nx;
+        row.insert(row.index());
+        if (i > 0)
+            row.insert(row.index() - 1);
+        if (i < nx - 1)
+            row.insert(row.index() + 1);
+        if (j > 0)
+            row.insert(row.index() - nx);
+        if (j < ny - 1)
+            row.insert(row.index() + nx);
+    }
+
+    for (auto rowIt = A.begin(); rowIt != A.end(); ++rowIt) {
+        for (auto colIt = rowIt->begin(); colIt != rowIt->end(); ++colIt) {
+            auto& block = *colIt;
+            block = 0.0;
+            if (colIt.index() == rowIt.index()) {
+                block[0][0] = 4.0;
+                block[1][1] = 4.5;
+                block[0][1] = 0.3;
+                block[1][0] = -0.2;
+            }
+            else {
+                block[0][0] = -1.0;
+                block[1][1] = -1.0;
+            }
+        }
+    }
+
+    return A;
+}
+
+double maxAbs(const Vector& v)
+{
+    double result = 0.0;
+    for (const auto& block : v)
+        for (const auto& value : block)
+            result = std::max(result, std::abs(value));
+    return result;
+}
+
+int main()
+{
+    const unsigned nx = 50;
+    const unsigned ny = 40;
+    const Matrix A = createMatrix(nx, ny);
+
+    Vector b(A.N());
+    for (std::size_t i = 0; i < b.size(); ++i) {
+        b[i][0] = std::sin(0.1*i);
+        b[i][1] = 1.0 + std::cos(0.3*i);
+    }
+
+    // the single precision ILU must yield the same correction as the double precision
+    // one up to the precision of the single precision floating point numbers
+    DoubleILU doubleIlu(A, 1.0);
+    MixedILU mixedIlu(A, 1.0);
+
+    Vector doubleCorrection(A.N());
+    Vector mixedCorrection(A.N());
+    doubleCorrection = 0.0;
+    mixedCorrection = 0.0;
+    doubleIlu.apply(doubleCorrection, b);
+    mixedIlu.apply(mixedCorrection, b);
+
+    Vector difference(mixedCorrection);
+    difference -= doubleCorrection;
+    const double relativeDifference = maxAbs(difference)/maxAbs(doubleCorrection);
+    std::cout << "relative difference of the corrections: " << relativeDifference << std::endl;
+    if (relativeDifference > 1e-5)
+        throw std::logic_error("The single precision preconditioner deviates too much");
+
+    // the precision of the solution of the linear solver is not limited by the one
+    // of the preconditioner
+    Dune::MatrixAdapter<Matrix, Vector, Vector> op(A);
+    Dune::BiCGSTABSolver<Vector> solver(op, mixedIlu, /*reduction=*/1e-10, /*maxit=*/500, /*verbose=*/0);
+
+    Vector x(A.N());
+    x = 0.0;
+    Vector rhs(b);
+    Dune::InverseOperatorResult result;
+    solver.apply(x, rhs, result);
+
+    Vector residual(b);
+    A.mmv(x, residual);
+    const double reduction = residual.two_norm()/b.two_norm();
+    std::cout << "iterations: " << result.iterations
+              << ", residual reduction: " << reduction << std::endl;
+    if (!result.converged || reduction > 1e-9)
+        throw std::logic_error("The linear solver did not reach the double precision tolerance");
+
+    return 0;
+}
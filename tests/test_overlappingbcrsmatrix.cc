@@ -0,0 +1,311 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \brief A test for the construction of the overlap, the global indices and the
+ *        pattern of an overlapping matrix.
+ *
+ * The vertices of a 2D lattice with a nine point stencil are distributed to the
+ * processes in vertical strips, where neighboring processes share a column of
+ * vertices. The overlapping matrix of each process must then contain the rows of all
+ * vertices whose distance from the strip of the process is at most the size of the
+ * overlap, and it must be the globally assembled matrix restricted to these rows and
+ * columns.
+ */
+#include "config.h"
+
+#include <opm/simulators/linalg/overlappingbcrsmatrix.hh>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/istl/bcrsmatrix.hh>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if HAVE_MPI
+#include <mpi.h>
+#endif
+
+using Matrix = Dune::BCRSMatrix<Dune::FieldMatrix<double, 1, 1>>;
+using OverlappingMatrix = Opm::Linear::OverlappingBCRSMatrix<Matrix>;
+
+class StripDecomposition
+{
+public:
+    StripDecomposition(unsigned numProcs, unsigned width, unsigned ny)
+        : numProcs_(numProcs), width_(width), ny_(ny)
+    {}
+
+    unsigned nx() const
+    { return numProcs_*width_ + 1; }
+
+    unsigned numVertices() const
+    { return nx()*ny_; }
+
+    unsigned numNative() const
+    { return (width_ + 1)*ny_; }
+
+    unsigned vertexIdx(unsigned x, unsigned y) const
+    { return y*nx() + x; }
+
+    // the vertices are numbered row by row within the strip of a process
+    unsigned nativeIdx(unsigned rank, unsigned x, unsigned y) const
+    { return y*(width_ + 1) + x - rank*width_; }
+
+    unsigned nativeToVertex(unsigned rank, unsigned nativeIdx) const
+    { return vertexIdx(rank*width_ + nativeIdx % (width_ + 1), nativeIdx/(width_ + 1)); }
+
+    bool hasColumn(unsigned rank, unsigned x) const
+    { return rank*width_ <= x && x <= (rank + 1)*width_; }
+
+    // the number of hops from the strip of a process to a vertex
+    unsigned distance(unsigned rank, unsigned vertexIdx) const
+    {
+        const unsigned x = vertexIdx % nx();
+        if (x < rank*width_)
+            return rank*width_ - x;
+        if (x > (rank + 1)*width_)
+            return x - (rank + 1)*width_;
+        return 0;
+    }
+
+    // the lowest rank which has a vertex
+    unsigned masterRank(unsigned vertexIdx) const
+    {
+        const unsigned x = vertexIdx % nx();
+        return x == 0 ? 0 : (x - 1)/width_;
+    }
+
+    std::vector<unsigned> stencil(unsigned vertexIdx) const
+    {
+        std::vector<unsigned> result;
+        const unsigned x = vertexIdx % nx();
+        const unsigned y = vertexIdx / nx();
+        for (unsigned yy = (y > 0 ? y - 1 : 0); yy <= std::min(y + 1, ny_ - 1); ++yy)
+            for (unsigned xx = (x > 0 ? x - 1 : 0); xx <= std::min(x + 1, nx() - 1); ++xx)
+                result.push_back(this->vertexIdx(xx, yy));
+        return result;
+    }
+
+    // the globally assembled matrix is chosen such that each entry identifies its
+    // row and its column
+    double globalValue(unsigned rowVertex, unsigned colVertex) const
+    { return static_cast<double>(rowVertex)*numVertices() + colVertex + 1; }
+
+    unsigned rowOfValue(double value) const
+    { return static_cast<unsigned>(std::lround(value - 1))/numVertices(); }
+
+    unsigned colOfValue(double value) const
+    { return static_cast<unsigned>(std::lround(value - 1)) % numVertices(); }
+
+    // the native matrix of a process. the entries which are shared by several
+    // processes are split evenly between them.
+    Matrix nativeMatrix(unsigned rank) const
+    {
+        Matrix A(numNative(), numNative(), Matrix::random);
+        for (unsigned nativeIdx = 0; nativeIdx < numNative(); ++nativeIdx)
+            A.setrowsize(nativeIdx, 9);
+        A.endrowsizes();
+
+        for (unsigned y = 0; y < ny_; ++y) {
+            for (unsigned x = rank*width_; x <= (rank + 1)*width_; ++x) {
+                for (unsigned neighborIdx : stencil(vertexIdx(x, y))) {
+                    const unsigned xx = neighborIdx % nx();
+                    if (hasColumn(rank, xx))
+                        A.addindex(nativeIdx(rank, x, y), nativeIdx(rank, xx, neighborIdx/nx()));
+                }
+            }
+        }
+        A.endindices();
+
+        for (auto rowIt = A.begin(); rowIt != A.end(); ++rowIt) {
+            for (auto colIt = rowIt->begin(); colIt != rowIt->end(); ++colIt) {
+                const unsigned rowVertex = nativeToVertex(rank, static_cast<unsigned>(rowIt.index()));
+                const unsigned colVertex = nativeToVertex(rank, static_cast<unsigned>(colIt.index()));
+                unsigned numSharing = 0;
+                for (unsigned peerRank = 0; peerRank < numProcs_; ++peerRank)
+                    if (hasColumn(peerRank, rowVertex % nx()) && hasColumn(peerRank, colVertex % nx()))
+                        ++numSharing;
+                *colIt = globalValue(rowVertex, colVertex)/numSharing;
+            }
+        }
+        return A;
+    }
+
+    Opm::Linear::BorderList borderList(unsigned rank) const
+    {
+        Opm::Linear::BorderList result;
+        for (unsigned y = 0; y < ny_; ++y) {
+            const unsigned left = rank*width_;
+            const unsigned right = (rank + 1)*width_;
+            if (rank > 0)
+                result.push_back({static_cast<Opm::Linear::Index>(nativeIdx(rank, left, y)),
+                                  static_cast<Opm::Linear::Index>(nativeIdx(rank - 1, left, y)),
+                                  static_cast<Opm::Linear::ProcessRank>(rank - 1),
+                                  /*borderDistance=*/0});
+            if (rank + 1 < numProcs_)
+                result.push_back({static_cast<Opm::Linear::Index>(nativeIdx(rank, right, y)),
+                                  static_cast<Opm::Linear::Index>(nativeIdx(rank + 1, right, y)),
+                                  static_cast<Opm::Linear::ProcessRank>(rank + 1),
+                                  /*borderDistance=*/0});
+        }
+        return result;
+    }
+
+private:
+    unsigned numProcs_;
+    unsigned width_;
+    unsigned ny_;
+};
+
+void check(bool condition, const std::string& what)
+{
+    if (!condition)
+        throw std::logic_error(what);
+}
+
+void testOverlap(unsigned rank, unsigned numProcs, unsigned width, unsigned overlapSize)
+{
+    const StripDecomposition decomposition(numProcs, width, /*ny=*/4);
+    const Matrix nativeMatrix = decomposition.nativeMatrix(rank);
+    OverlappingMatrix A(nativeMatrix, decomposition.borderList(rank), Opm::Linear::BlackList(), overlapSize);
+    A.assignAdd(nativeMatrix);
+    const auto& overlap = A.overlap();
+
+    // identify the vertex of each domestic row by the value of its diagonal entry
+    const unsigned numDomestic = static_cast<unsigned>(overlap.numDomestic());
+    check(A.N() == numDomestic, "The matrix does not have a row for each domestic index");
+    std::vector<unsigned> vertexOfRow(numDomestic);
+    std::set<unsigned> domesticVertices;
+    for (unsigned domesticIdx = 0; domesticIdx < numDomestic; ++domesticIdx) {
+        const auto& row = A[domesticIdx];
+        const auto diagIt = row.find(domesticIdx);
+        check(diagIt != row.end(), "A row does not exhibit a diagonal entry");
+        const unsigned vertexIdx = decomposition.rowOfValue((*diagIt)[0][0]);
+        check((*diagIt)[0][0] == decomposition.globalValue(vertexIdx, vertexIdx),
+              "The diagonal entry of a row is wrong");
+        check(domesticVertices.insert(vertexIdx).second, "A vertex has more than one domestic row");
+        vertexOfRow[domesticIdx] = vertexIdx;
+
+        if (overlap.isLocal(static_cast<Opm::Linear::Index>(domesticIdx))) {
+            const auto nativeIdx = overlap.domesticToNative(static_cast<Opm::Linear::Index>(domesticIdx));
+            check(decomposition.nativeToVertex(rank, static_cast<unsigned>(nativeIdx)) == vertexIdx,
+                  "The native index of a local row is wrong");
+        }
+    }
+
+    // the domestic rows are the rows of all vertices within the overlap
+    std::set<unsigned> expectedVertices;
+    for (unsigned vertexIdx = 0; vertexIdx < decomposition.numVertices(); ++vertexIdx)
+        if (decomposition.distance(rank, vertexIdx) <= overlapSize)
+            expectedVertices.insert(vertexIdx);
+    check(domesticVertices == expectedVertices, "The domestic indices are wrong");
+    check(overlap.numLocal() == decomposition.numNative(), "The number of local indices is wrong");
+
+    for (unsigned domesticIdx = 0; domesticIdx < numDomestic; ++domesticIdx) {
+        const auto idx = static_cast<Opm::Linear::Index>(domesticIdx);
+        const unsigned vertexIdx = vertexOfRow[domesticIdx];
+        check(overlap.isFront(idx) == (decomposition.distance(rank, vertexIdx) == overlapSize),
+              "The front of the overlap is wrong");
+        check(overlap.masterRank(idx) == static_cast<Opm::Linear::ProcessRank>(decomposition.masterRank(vertexIdx)),
+              "The master rank of an index is wrong");
+
+        // the pattern of a row consists of all neighbors of its vertex in the overlap
+        // and the values are the ones of the globally assembled matrix
+        unsigned numEntries = 0;
+        const auto& row = A[domesticIdx];
+        for (auto colIt = row.begin(); colIt != row.end(); ++colIt) {
+            const double value = (*colIt)[0][0];
+            check(decomposition.rowOfValue(value) == vertexIdx
+                  && decomposition.colOfValue(value) == vertexOfRow[colIt.index()]
+                  && value == decomposition.globalValue(vertexIdx, vertexOfRow[colIt.index()]),
+                  "An entry of the overlapping matrix is wrong");
+            ++numEntries;
+        }
+
+        unsigned expectedNumEntries = 0;
+        for (unsigned neighborIdx : decomposition.stencil(vertexIdx))
+            if (expectedVertices.count(neighborIdx) > 0)
+                ++expectedNumEntries;
+        check(numEntries == expectedNumEntries, "The pattern of a row is wrong");
+    }
+
+    // the global index of each vertex must be the same on all processes and the
+    // global indices must be a numbering of the vertices
+    std::vector<int> globalIndices(decomposition.numVertices(), -1);
+    for (unsigned domesticIdx = 0; domesticIdx < numDomestic; ++domesticIdx)
+        globalIndices[vertexOfRow[domesticIdx]] =
+            overlap.domesticToGlobal(static_cast<Opm::Linear::Index>(domesticIdx));
+
+    std::vector<int> allGlobalIndices(globalIndices);
+#if HAVE_MPI
+    allGlobalIndices.resize(numProcs*globalIndices.size());
+    MPI_Allgather(globalIndices.data(), static_cast<int>(globalIndices.size()), MPI_INT,
+                  allGlobalIndices.data(), static_cast<int>(globalIndices.size()), MPI_INT,
+                  MPI_COMM_WORLD);
+#endif
+
+    std::vector<int> vertexOfGlobalIdx(decomposition.numVertices(), -1);
+    for (unsigned vertexIdx = 0; vertexIdx < decomposition.numVertices(); ++vertexIdx) {
+        int globalIdx = -1;
+        for (unsigned peerRank = 0; peerRank < numProcs; ++peerRank) {
+            const int peerGlobalIdx = allGlobalIndices[peerRank*decomposition.numVertices() + vertexIdx];
+            if (peerGlobalIdx < 0)
+                continue;
+            check(globalIdx < 0 || globalIdx == peerGlobalIdx,
+                  "The processes do not agree on the global index of a vertex");
+            globalIdx = peerGlobalIdx;
+        }
+
+        check(globalIdx >= 0 && globalIdx < static_cast<int>(decomposition.numVertices()),
+              "A vertex does not exhibit a valid global index");
+        check(vertexOfGlobalIdx[static_cast<unsigned>(globalIdx)] < 0,
+              "A global index is used for two vertices");
+        vertexOfGlobalIdx[static_cast<unsigned>(globalIdx)] = static_cast<int>(vertexIdx);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const auto& mpiHelper = Dune::MPIHelper::instance(argc, argv);
+    const unsigned rank = static_cast<unsigned>(mpiHelper.rank());
+    const unsigned numProcs = static_cast<unsigned>(mpiHelper.size());
+
+    // narrow strips make the overlap extend beyond the neighboring processes
+    for (unsigned width : {1u, 2u, 4u}) {
+        for (unsigned overlapSize : {1u, 2u, 3u}) {
+            if (rank == 0)
+                std::cout << "testing strips of width " << width
+                          << " with an overlap of size " << overlapSize << std::endl;
+            testOverlap(rank, numProcs, width, overlapSize);
+        }
+    }
+
+    return 0;
+}
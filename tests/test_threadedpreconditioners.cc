@@ -0,0 +1,217 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \brief A test for the preconditioners which are applied by multiple threads.
+ */
+#include "config.h"
+
+#include <opm/simulators/linalg/threadedpreconditioners.hh>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+#include <dune/istl/preconditioners.hh>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+using Matrix = Dune::BCRSMatrix<Dune::FieldMatrix<double, 2, 2>>;
+using Vector = Dune::BlockVector<Dune::FieldVector<double, 2>>;
+using Pattern = std::vector<std::set<unsigned>>;
+
+// the pattern of a 2D lattice where each row is coupled to its western, southern and
+// eastern neighbors and to a random row, i.e., the pattern is not symmetric
+Pattern nonSymmetricPattern(unsigned nx, unsigned ny, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<unsigned> randomRow(0, nx*ny - 1);
+
+    Pattern pattern(nx*ny);
+    for (unsigned j = 0; j < ny; ++j) {
+        for (unsigned i = 0; i < nx; ++i) {
+            auto& row = pattern[j*nx + i];
+            row.insert(j*nx + i);
+            if (i > 0)
+                row.insert(j*nx + i - 1);
+            if (i < nx - 1)
+                row.insert(j*nx + i + 1);
+            if (j > 0)
+                row.insert((j - 1)*nx + i);
+            row.insert(randomRow(rng));
+        }
+    }
+    return pattern;
+}
+
+// a matrix which is strictly diagonally dominant by rows and whose diagonal blocks
+// also couple the two equations of a row
+Matrix createMatrix(const Pattern& pattern)
+{
+    const std::size_t n = pattern.size();
+    Matrix A(n, n, Matrix::random);
+    for (std::size_t rowIdx = 0; rowIdx < n; ++rowIdx)
+        A.setrowsize(rowIdx, pattern[rowIdx].size());
+    A.endrowsizes();
+    for (std::size_t rowIdx = 0; rowIdx < n; ++rowIdx)
+        for (unsigned colIdx : pattern[rowIdx])
+            A.addindex(rowIdx, colIdx);
+    A.endindices();
+
+    for (auto rowIt = A.begin(); rowIt != A.end(); ++rowIt) {
+        for (auto colIt = rowIt->begin(); colIt != rowIt->end(); ++colIt) {
+            auto& block = *colIt;
+            block = 0.0;
+            if (colIt.index() == rowIt.index()) {
+                block[0][0] = 5.0;
+                block[1][1] = 5.5;
+                block[0][1] = 0.3;
+                block[1][0] = -0.2;
+            }
+            else {
+                block[0][0] = -1.0;
+                block[1][1] = -1.0;
+            }
+        }
+    }
+    return A;
+}
+
+Vector createRhs(std::size_t n)
+{
+    Vector b(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        b[i][0] = std::sin(0.1*i);
+        b[i][1] = 1.0 + std::cos(0.3*i);
+    }
+    return b;
+}
+
+double maxAbs(const Vector& v)
+{
+    double result = 0.0;
+    for (const auto& block : v)
+        for (const auto& value : block)
+            result = std::max(result, std::abs(value));
+    return result;
+}
+
+// the coloring must be a partition of the rows such that no entry of the matrix
+// couples two different rows of the same color
+void testColoring(const Matrix& A)
+{
+    std::vector<unsigned> rows;
+    std::vector<std::size_t> colorOffsets;
+    Opm::Linear::colorMatrixRows(A, rows, colorOffsets);
+
+    const std::size_t numColors = colorOffsets.size() - 1;
+    std::cout << "number of colors: " << numColors << std::endl;
+    if (colorOffsets.front() != 0 || colorOffsets.back() != A.N() || rows.size() != A.N())
+        throw std::logic_error("The colors do not contain all rows");
+
+    std::vector<int> color(A.N(), -1);
+    for (std::size_t colorIdx = 0; colorIdx < numColors; ++colorIdx) {
+        if (colorOffsets[colorIdx] >= colorOffsets[colorIdx + 1])
+            throw std::logic_error("The coloring contains an empty color");
+        for (std::size_t k = colorOffsets[colorIdx]; k < colorOffsets[colorIdx + 1]; ++k) {
+            if (rows[k] >= A.N() || color[rows[k]] >= 0)
+                throw std::logic_error("The colors are not a partition of the rows");
+            color[rows[k]] = static_cast<int>(colorIdx);
+        }
+    }
+
+    for (auto rowIt = A.begin(); rowIt != A.end(); ++rowIt)
+        for (auto colIt = rowIt->begin(); colIt != rowIt->end(); ++colIt)
+            if (colIt.index() != rowIt.index() && color[colIt.index()] == color[rowIt.index()])
+                throw std::logic_error("Two rows of the same color are coupled");
+}
+
+// with a single block, the block Jacobi preconditioner is the ILU(0) of dune-istl
+void testBlockJacobi(const Matrix& A, const Vector& b)
+{
+    const double relaxation = 0.9;
+    Dune::SeqILU<Matrix, Vector, Vector> seqIlu(A, relaxation);
+    Opm::Linear::BlockJacobiILU0<Matrix, Vector, Vector> blockJacobi(A, relaxation, /*numBlocks=*/1);
+
+    Vector seqCorrection(A.N());
+    Vector blockJacobiCorrection(A.N());
+    seqCorrection = 0.0;
+    blockJacobiCorrection = 0.0;
+    seqIlu.apply(seqCorrection, b);
+    blockJacobi.apply(blockJacobiCorrection, b);
+
+    Vector difference(blockJacobiCorrection);
+    difference -= seqCorrection;
+    const double relativeDifference = maxAbs(difference)/maxAbs(seqCorrection);
+    std::cout << "relative difference to SeqILU: " << relativeDifference << std::endl;
+    if (relativeDifference > 1e-12)
+        throw std::logic_error("The block Jacobi preconditioner deviates from SeqILU");
+}
+
+// each application of the SOR preconditioner is a sweep of a stationary iterative
+// method which must reduce the residual
+void testSOR(const Matrix& A, const Vector& b, double relaxation, bool symmetric)
+{
+    Opm::Linear::MultiColorSOR<Matrix, Vector, Vector> sor(A, /*numIterations=*/1, relaxation, symmetric);
+
+    Vector x(A.N());
+    x = 0.0;
+    double lastResidual = b.two_norm();
+    for (int sweepIdx = 0; sweepIdx < 10; ++sweepIdx) {
+        sor.apply(x, b);
+
+        Vector residual(b);
+        A.mmv(x, residual);
+        const double residualNorm = residual.two_norm();
+        if (residualNorm >= lastResidual)
+            throw std::logic_error("A sweep of the SOR preconditioner does not reduce the residual");
+        lastResidual = residualNorm;
+    }
+
+    const double reduction = lastResidual/b.two_norm();
+    std::cout << "residual reduction of " << (symmetric ? "SSOR" : "SOR")
+              << " with relaxation " << relaxation << ": " << reduction << std::endl;
+    if (reduction > 1e-2)
+        throw std::logic_error("The SOR preconditioner does not converge sufficiently fast");
+}
+
+int main()
+{
+    const Pattern pattern = nonSymmetricPattern(/*nx=*/30, /*ny=*/20, /*seed=*/1);
+    const Matrix A = createMatrix(pattern);
+    const Vector b = createRhs(A.N());
+
+    testColoring(A);
+    testBlockJacobi(A, b);
+    testSOR(A, b, /*relaxation=*/1.0, /*symmetric=*/false);
+    testSOR(A, b, /*relaxation=*/1.1, /*symmetric=*/false);
+    testSOR(A, b, /*relaxation=*/1.0, /*symmetric=*/true);
+
+    return 0;
+}
@@ -0,0 +1,108 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \brief A test for the PID controller of the time step size.
+ */
+#include "config.h"
+
+#include <opm/models/discretization/common/fvbasetimestepcontrol.hh>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+
+using Controller = Opm::PidTimeStepController<double>;
+
+void checkClose(double value, double expected, const char* what)
+{
+    if (std::abs(value - expected) > 1e-12*std::max(1.0, std::abs(expected))) {
+        std::cout << what << ": " << value << " (expected: " << expected << ")\n";
+        throw std::logic_error("The time step control yields an unexpected factor");
+    }
+}
+
+// simulate a problem for which the change of the solution is proportional to the time
+// step size. the growth of the time step size is limited like by the time step control
+// of the discretizations. returns the size of the last time step.
+double simulate(Controller& controller, double changeRate, double dt, int numSteps, double tolerance)
+{
+    double lastDt = 0.0;
+    for (int stepIdx = 0; stepIdx < numSteps; ++stepIdx) {
+        const double change = changeRate*dt;
+        if (change > tolerance*(1 + 1e-10))
+            throw std::logic_error("The time step size overshoots the targeted change");
+        if (dt < lastDt)
+            throw std::logic_error("The time step size decreases for a constant rate of change");
+
+        controller.recordChange(change);
+        lastDt = dt;
+        dt *= std::clamp(controller.factor(), 0.25, 2.0);
+    }
+    return dt;
+}
+
+int main()
+{
+    const double tolerance = 0.1;
+
+    // if the change matches the tolerance, the size of the time step is kept
+    Controller steadyController(tolerance);
+    for (int i = 0; i < 5; ++i) {
+        steadyController.recordChange(tolerance);
+        checkClose(steadyController.factor(), 1.0, "change equals the tolerance");
+    }
+
+    // during the first time steps, the size is scaled proportionally to the deviation
+    // from the targeted change. after that, the PID controller grows it more cautiously.
+    Controller startController(tolerance);
+    startController.recordChange(tolerance/2);
+    checkClose(startController.factor(), 2.0, "first time step");
+    startController.recordChange(tolerance/2);
+    checkClose(startController.factor(), 2.0, "second time step");
+    startController.recordChange(tolerance/2);
+    checkClose(startController.factor(), std::pow(2.0, 0.175), "third time step");
+
+    // a change which is too large reduces the size proportionally
+    startController.recordChange(4*tolerance);
+    checkClose(startController.factor(), 0.25, "too large change");
+
+    // for a constant rate of change, the size of the time steps approaches the one
+    // which yields the targeted change from below
+    Controller controller(tolerance);
+    const double changeRate = 0.01;
+    const double targetDt = tolerance/changeRate;
+    double dt = simulate(controller, changeRate, /*dt=*/1.0, /*numSteps=*/40, tolerance);
+    std::cout << "time step size after 40 steps: " << dt
+              << " (targeted: " << targetDt << ")\n";
+    if (std::abs(dt - targetDt) > 0.02*targetDt)
+        throw std::logic_error("The time step size does not approach the targeted one");
+
+    // if the solution suddenly changes four times faster, the size is reduced at once
+    controller.recordChange(4*changeRate*dt);
+    dt *= controller.factor();
+    checkClose(4*changeRate*dt, tolerance, "change after the rate increased");
+
+    return 0;
+}
@@ -0,0 +1,114 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \brief A test for the cost-weighted recursive coordinate bisection.
+ */
+#include "config.h"
+
+#include <opm/models/parallel/weightedbisectionpartitioner.hh>
+
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+using Partitioner = Opm::WeightedBisectionPartitioner<double, 2>;
+
+// the centers of the cells of a 2D lattice
+std::vector<Partitioner::GlobalPosition> latticePoints(unsigned nx, unsigned ny)
+{
+    std::vector<Partitioner::GlobalPosition> points;
+    for (unsigned j = 0; j < ny; ++j) {
+        for (unsigned i = 0; i < nx; ++i) {
+            Partitioner::GlobalPosition pos;
+            pos[0] = i + 0.5;
+            pos[1] = j + 0.5;
+            points.push_back(pos);
+        }
+    }
+    return points;
+}
+
+// partition a 2D lattice of points and return the total weight of each part
+std::vector<double> partWeights(const std::vector<double>& weights, unsigned nx, unsigned ny, int numParts)
+{
+    const auto points = latticePoints(nx, ny);
+    Partitioner partitioner(points, weights, numParts);
+
+    std::vector<double> result(static_cast<std::size_t>(numParts), 0.0);
+    for (std::size_t i = 0; i < points.size(); ++i) {
+        int part = partitioner.part(points[i]);
+        if (part < 0 || part >= numParts)
+            throw std::logic_error("Invalid part returned by the partitioner");
+        result[static_cast<std::size_t>(part)] += weights[i];
+    }
+    return result;
+}
+
+void checkBalance(const std::vector<double>& result, double maxImbalance)
+{
+    double total = 0.0;
+    for (double w : result)
+        total += w;
+    double mean = total/result.size();
+    double maxWeight = *std::max_element(result.begin(), result.end());
+
+    std::cout << "part weights:";
+    for (double w : result)
+        std::cout << " " << w;
+    std::cout << " (imbalance: " << maxWeight/mean << ")" << std::endl;
+
+    if (maxWeight/mean > maxImbalance)
+        throw std::logic_error("The partition is not balanced");
+}
+
+int main()
+{
+    const unsigned nx = 160;
+    const unsigned ny = 40;
+
+    // uniform weights must result in parts of equal size
+    std::vector<double> weights(nx*ny, 1.0);
+    checkBalance(partWeights(weights, nx, ny, 4), 1.01);
+
+    // the elements on the left are ten times as expensive as the ones on the right
+    for (unsigned j = 0; j < ny; ++j)
+        for (unsigned i = 0; i < nx/4; ++i)
+            weights[j*nx + i] = 10.0;
+    checkBalance(partWeights(weights, nx, ny, 4), 1.1);
+
+    // an odd number of parts
+    checkBalance(partWeights(weights, nx, ny, 3), 1.1);
+
+    // no cost recorded at all: balance the number of points
+    std::fill(weights.begin(), weights.end(), 0.0);
+    const auto points = latticePoints(nx, ny);
+    Partitioner partitioner(points, weights, 5);
+    std::vector<double> result(5, 0.0);
+    for (const auto& pos : points)
+        result[static_cast<std::size_t>(partitioner.part(pos))] += 1.0;
+    checkBalance(result, 1.01);
+
+    return 0;
+}